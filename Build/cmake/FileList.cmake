@@ -15,8 +15,12 @@ set(Core_HDR_FILES
     ${PROJECT_SOURCE_DIR}/Source/Core/PluginRegistry.h
     ${PROJECT_SOURCE_DIR}/Source/Core/StyleSheetNodeSelectorEmpty.h
     ${PROJECT_SOURCE_DIR}/Source/Core/StyleSheetParser.h
+    ${PROJECT_SOURCE_DIR}/Source/Core/StyleStatisticsRecorder.h
     ${PROJECT_SOURCE_DIR}/Source/Core/XMLNodeHandlerTemplate.h
     ${PROJECT_SOURCE_DIR}/Source/Core/PropertyShorthandDefinition.h
+    ${PROJECT_SOURCE_DIR}/Source/Core/PropertySourceTable.h
+    ${PROJECT_SOURCE_DIR}/Source/Core/PropertyLayer.h
+    ${PROJECT_SOURCE_DIR}/Source/Core/PseudoClassRegistry.h
     ${PROJECT_SOURCE_DIR}/Source/Core/StyleSheetNodeSelectorNthOfType.h
     ${PROJECT_SOURCE_DIR}/Source/Core/ElementTextDefault.h
     ${PROJECT_SOURCE_DIR}/Source/Core/StyleSheetNodeSelector.h
@@ -27,10 +31,17 @@ set(Core_HDR_FILES
     ${PROJECT_SOURCE_DIR}/Source/Core/PropertyParserString.h
     ${PROJECT_SOURCE_DIR}/Source/Core/TextureResource.h
     ${PROJECT_SOURCE_DIR}/Source/Core/StyleSheetNode.h
+    ${PROJECT_SOURCE_DIR}/Source/Core/AncestorFilter.h
+    ${PROJECT_SOURCE_DIR}/Source/Core/StyleSharingCache.h
     ${PROJECT_SOURCE_DIR}/Source/Core/Clock.h
     ${PROJECT_SOURCE_DIR}/Source/Core/DecoratorTiledInstancer.h
     ${PROJECT_SOURCE_DIR}/Source/Core/DecoratorTiledImage.h
     ${PROJECT_SOURCE_DIR}/Source/Core/DecoratorTiledVerticalInstancer.h
+    ${PROJECT_SOURCE_DIR}/Source/Core/DefinitionCache.h
+    ${PROJECT_SOURCE_DIR}/Source/Core/DefinitionUpdateBatch.h
+    ${PROJECT_SOURCE_DIR}/Source/Core/InvalidationMap.h
+    ${PROJECT_SOURCE_DIR}/Source/Core/StyleSheetBinary.h
+    ${PROJECT_SOURCE_DIR}/Source/Core/PropertyParseCache.h
     ${PROJECT_SOURCE_DIR}/Source/Core/StyleSheetNodeSelectorLastChild.h
     ${PROJECT_SOURCE_DIR}/Source/Core/ElementHandle.h
     ${PROJECT_SOURCE_DIR}/Source/Core/EventDispatcher.h
@@ -41,9 +52,11 @@ set(Core_HDR_FILES
     ${PROJECT_SOURCE_DIR}/Source/Core/EventIterators.h
     ${PROJECT_SOURCE_DIR}/Source/Core/XMLNodeHandlerBody.h
     ${PROJECT_SOURCE_DIR}/Source/Core/LayoutBlockBox.h
+    ${PROJECT_SOURCE_DIR}/Source/Core/LayoutArena.h
     ${PROJECT_SOURCE_DIR}/Source/Core/WidgetSlider.h
     ${PROJECT_SOURCE_DIR}/Source/Core/LayoutInlineBoxText.h
     ${PROJECT_SOURCE_DIR}/Source/Core/FontFaceLayer.h
+    ${PROJECT_SOURCE_DIR}/Source/Core/FontStringWidthCache.h
     ${PROJECT_SOURCE_DIR}/Source/Core/ElementImage.h
     ${PROJECT_SOURCE_DIR}/Source/Core/FontFamily.h
     ${PROJECT_SOURCE_DIR}/Source/Core/DecoratorTiled.h
@@ -57,6 +70,9 @@ set(Core_HDR_FILES
     ${PROJECT_SOURCE_DIR}/Source/Core/StyleSheetNodeSelectorNthLastChild.h
     ${PROJECT_SOURCE_DIR}/Source/Core/StyleSheetNodeSelectorFirstChild.h
     ${PROJECT_SOURCE_DIR}/Source/Core/LayoutLineBox.h
+    ${PROJECT_SOURCE_DIR}/Source/Core/LayoutStatisticsRecorder.h
+    ${PROJECT_SOURCE_DIR}/Source/Core/AtomicCounter.h
+    ${PROJECT_SOURCE_DIR}/Source/Core/LayoutUpdateBatch.h
     ${PROJECT_SOURCE_DIR}/Source/Core/DebugFont.h
     ${PROJECT_SOURCE_DIR}/Source/Core/FontEffectNone.h
     ${PROJECT_SOURCE_DIR}/Source/Core/FontEffectShadow.h
@@ -97,6 +113,7 @@ set(Core_PUB_HDR_FILES
     ${PROJECT_SOURCE_DIR}/Include/Rocket/Core/SystemInterface.h
     ${PROJECT_SOURCE_DIR}/Include/Rocket/Core/Colour.h
     ${PROJECT_SOURCE_DIR}/Include/Rocket/Core/Box.h
+    ${PROJECT_SOURCE_DIR}/Include/Rocket/Core/ComputedStyle.h
     ${PROJECT_SOURCE_DIR}/Include/Rocket/Core/ConvolutionFilter.h
     ${PROJECT_SOURCE_DIR}/Include/Rocket/Core/EventListenerInstancer.h
     ${PROJECT_SOURCE_DIR}/Include/Rocket/Core/ElementInstancerGeneric.h
@@ -114,6 +131,8 @@ set(Core_PUB_HDR_FILES
     ${PROJECT_SOURCE_DIR}/Include/Rocket/Core/Decorator.h
     ${PROJECT_SOURCE_DIR}/Include/Rocket/Core/Texture.h
     ${PROJECT_SOURCE_DIR}/Include/Rocket/Core/PropertyDictionary.h
+    ${PROJECT_SOURCE_DIR}/Include/Rocket/Core/PropertyIds.h
+    ${PROJECT_SOURCE_DIR}/Include/Rocket/Core/PropertyIdSet.h
     ${PROJECT_SOURCE_DIR}/Include/Rocket/Core/StyleSheet.h
     ${PROJECT_SOURCE_DIR}/Include/Rocket/Core/FontGlyph.h
     ${PROJECT_SOURCE_DIR}/Include/Rocket/Core/ReferenceCountable.h
@@ -125,6 +144,7 @@ set(Core_PUB_HDR_FILES
     ${PROJECT_SOURCE_DIR}/Include/Rocket/Core/GeometryUtilities.h
     ${PROJECT_SOURCE_DIR}/Include/Rocket/Core/Vector2.h
     ${PROJECT_SOURCE_DIR}/Include/Rocket/Core/StyleSheetSpecification.h
+    ${PROJECT_SOURCE_DIR}/Include/Rocket/Core/StyleStatistics.h
     ${PROJECT_SOURCE_DIR}/Include/Rocket/Core/RenderInterface.h
     ${PROJECT_SOURCE_DIR}/Include/Rocket/Core/StyleSheetKeywords.h
     ${PROJECT_SOURCE_DIR}/Include/Rocket/Core/Core.h
@@ -138,6 +158,7 @@ set(Core_PUB_HDR_FILES
     ${PROJECT_SOURCE_DIR}/Include/Rocket/Core/Debug.h
     ${PROJECT_SOURCE_DIR}/Include/Rocket/Core/URL.h
     ${PROJECT_SOURCE_DIR}/Include/Rocket/Core/Input.h
+    ${PROJECT_SOURCE_DIR}/Include/Rocket/Core/LayoutStatistics.h
     ${PROJECT_SOURCE_DIR}/Include/Rocket/Core/Event.h
     ${PROJECT_SOURCE_DIR}/Include/Rocket/Core/Geometry.h
     ${PROJECT_SOURCE_DIR}/Include/Rocket/Core/Font.h
@@ -207,6 +228,7 @@ set(Core_SRC_FILES
     ${PROJECT_SOURCE_DIR}/Source/Core/ElementText.cpp
     ${PROJECT_SOURCE_DIR}/Source/Core/precompiled.cpp
     ${PROJECT_SOURCE_DIR}/Source/Core/StyleSheetSpecification.cpp
+    ${PROJECT_SOURCE_DIR}/Source/Core/StyleStatistics.cpp
     ${PROJECT_SOURCE_DIR}/Source/Core/FontEffectNone.cpp
     ${PROJECT_SOURCE_DIR}/Source/Core/PluginRegistry.cpp
     ${PROJECT_SOURCE_DIR}/Source/Core/ElementInstancer.cpp
@@ -229,6 +251,7 @@ set(Core_SRC_FILES
     ${PROJECT_SOURCE_DIR}/Source/Core/Texture.cpp
     ${PROJECT_SOURCE_DIR}/Source/Core/ElementScroll.cpp
     ${PROJECT_SOURCE_DIR}/Source/Core/FontFaceLayer.cpp
+    ${PROJECT_SOURCE_DIR}/Source/Core/FontStringWidthCache.cpp
     ${PROJECT_SOURCE_DIR}/Source/Core/UnicodeRange.cpp
     ${PROJECT_SOURCE_DIR}/Source/Core/FileInterface.cpp
     ${PROJECT_SOURCE_DIR}/Source/Core/StyleSheetNodeSelectorNthLastChild.cpp
@@ -241,6 +264,8 @@ set(Core_SRC_FILES
     ${PROJECT_SOURCE_DIR}/Source/Core/Vector2.cpp
     ${PROJECT_SOURCE_DIR}/Source/Core/PropertyParserKeyword.cpp
     ${PROJECT_SOURCE_DIR}/Source/Core/StyleSheetNode.cpp
+    ${PROJECT_SOURCE_DIR}/Source/Core/AncestorFilter.cpp
+    ${PROJECT_SOURCE_DIR}/Source/Core/StyleSharingCache.cpp
     ${PROJECT_SOURCE_DIR}/Source/Core/ElementDocument.cpp
     ${PROJECT_SOURCE_DIR}/Source/Core/StyleSheetNodeSelectorEmpty.cpp
     ${PROJECT_SOURCE_DIR}/Source/Core/DecoratorTiledImageInstancer.cpp
@@ -257,14 +282,20 @@ set(Core_SRC_FILES
     ${PROJECT_SOURCE_DIR}/Source/Core/EventInstancer.cpp
     ${PROJECT_SOURCE_DIR}/Source/Core/TextureLayoutRow.cpp
     ${PROJECT_SOURCE_DIR}/Source/Core/PropertySpecification.cpp
+    ${PROJECT_SOURCE_DIR}/Source/Core/PropertySourceTable.cpp
+    ${PROJECT_SOURCE_DIR}/Source/Core/PropertyLayer.cpp
+    ${PROJECT_SOURCE_DIR}/Source/Core/PseudoClassRegistry.cpp
     ${PROJECT_SOURCE_DIR}/Source/Core/FontFaceHandle.cpp
     ${PROJECT_SOURCE_DIR}/Source/Core/SystemInterface.cpp
     ${PROJECT_SOURCE_DIR}/Source/Core/ElementBorder.cpp
     ${PROJECT_SOURCE_DIR}/Source/Core/Plugin.cpp
     ${PROJECT_SOURCE_DIR}/Source/Core/LayoutLineBox.cpp
+    ${PROJECT_SOURCE_DIR}/Source/Core/LayoutStatistics.cpp
+    ${PROJECT_SOURCE_DIR}/Source/Core/LayoutUpdateBatch.cpp
     ${PROJECT_SOURCE_DIR}/Source/Core/TextureLayoutRectangle.cpp
     ${PROJECT_SOURCE_DIR}/Source/Core/TextureResource.cpp
     ${PROJECT_SOURCE_DIR}/Source/Core/LayoutBlockBox.cpp
+    ${PROJECT_SOURCE_DIR}/Source/Core/LayoutArena.cpp
     ${PROJECT_SOURCE_DIR}/Source/Core/StyleSheetNodeSelectorNthOfType.cpp
     ${PROJECT_SOURCE_DIR}/Source/Core/ElementImage.cpp
     ${PROJECT_SOURCE_DIR}/Source/Core/StyleSheetNodeSelector.cpp
@@ -287,6 +318,11 @@ set(Core_SRC_FILES
     ${PROJECT_SOURCE_DIR}/Source/Core/StyleSheetNodeSelectorNthChild.cpp
     ${PROJECT_SOURCE_DIR}/Source/Core/Geometry.cpp
     ${PROJECT_SOURCE_DIR}/Source/Core/DecoratorTiledVerticalInstancer.cpp
+    ${PROJECT_SOURCE_DIR}/Source/Core/DefinitionCache.cpp
+    ${PROJECT_SOURCE_DIR}/Source/Core/DefinitionUpdateBatch.cpp
+    ${PROJECT_SOURCE_DIR}/Source/Core/InvalidationMap.cpp
+    ${PROJECT_SOURCE_DIR}/Source/Core/StyleSheetBinary.cpp
+    ${PROJECT_SOURCE_DIR}/Source/Core/PropertyParseCache.cpp
     ${PROJECT_SOURCE_DIR}/Source/Core/ElementReference.cpp
     ${PROJECT_SOURCE_DIR}/Source/Core/StyleSheetNodeSelectorOnlyOfType.cpp
     ${PROJECT_SOURCE_DIR}/Source/Core/PropertyParserString.cpp
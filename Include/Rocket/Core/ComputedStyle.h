@@ -0,0 +1,128 @@
+/*
+ * This source file is part of libRocket, the HTML/CSS Interface Middleware
+ *
+ * For the latest information, see http://www.librocket.com
+ *
+ * Copyright (c) 2008-2010 CodePoint Ltd, Shift Technology Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+#ifndef ROCKETCORECOMPUTEDSTYLE_H
+#define ROCKETCORECOMPUTEDSTYLE_H
+
+#include <Rocket/Core/Header.h>
+#include <Rocket/Core/Box.h>
+#include <Rocket/Core/Types.h>
+
+namespace Rocket {
+namespace Core {
+
+/**
+	A length from an element's style, resolved as far as is possible without knowing the dimensions of the element's
+	containing block. Absolute and em-relative lengths are stored in pixels; percentages are stored as-is and scaled
+	when they are resolved.
+ */
+
+struct ROCKETCORE_API ComputedLength
+{
+	enum Type
+	{
+		PIXELS,
+		PERCENT,
+		AUTO
+	};
+
+	/// The type of the length.
+	Type type;
+	/// The length in pixels, or the percentage if this is a percentage length.
+	float value;
+
+	/// Resolves the length into pixels.
+	/// @param[in] base_value The value that is scaled by the length if it is a percentage.
+	/// @return The resolved length. Automatic lengths resolve to zero.
+	inline float Resolve(float base_value) const
+	{
+		if (type == PIXELS)
+			return value;
+		if (type == PERCENT)
+			return base_value * value * 0.01f;
+		return 0;
+	}
+};
+
+/**
+	A flat block of an element's resolved style values. It is rebuilt in a single pass the first time it is accessed
+	after any of the element's properties are dirtied, so per-frame consumers can read values directly instead of
+	looking them up (and walking the element's ancestors for inherited properties) on every access.
+
+	Keyword properties are stored as their keyword values, and colours as Colourb.
+ */
+
+struct ROCKETCORE_API ComputedStyle
+{
+	/// 'margin', 'padding', 'border-width' and 'border-color' properties, indexed by Box::Edge.
+	ComputedLength margin[Box::NUM_EDGES];
+	ComputedLength padding[Box::NUM_EDGES];
+	ComputedLength border_width[Box::NUM_EDGES];
+	Colourb border_colour[Box::NUM_EDGES];
+
+	/// 'width' and 'height' properties.
+	ComputedLength width;
+	ComputedLength height;
+	/// 'min-width', 'max-width', 'min-height' and 'max-height' properties. If a property is not set on the
+	/// element, it resolves to zero for a minimum and FLT_MAX for a maximum.
+	ComputedLength min_width;
+	ComputedLength max_width;
+	ComputedLength min_height;
+	ComputedLength max_height;
+
+	/// Positioning keywords.
+	int display;
+	int position;
+	int float_;
+	int clear;
+	int overflow_x;
+	int overflow_y;
+	int visibility;
+
+	/// True if 'z-index' is 'auto'; otherwise z_index holds the resolved index, with the 'top' and 'bottom'
+	/// keywords resolved to FLT_MAX and -FLT_MAX.
+	bool z_index_auto;
+	float z_index;
+
+	/// Colour properties.
+	Colourb colour;
+	Colourb background_colour;
+
+	/// Font and text keywords.
+	int font_style;
+	int font_weight;
+	int text_align;
+	int text_decoration;
+	int text_transform;
+	int white_space;
+};
+
+}
+}
+
+#endif
@@ -85,6 +85,33 @@ public:
 	/// Renders all visible elements in the context's documents.
 	bool Render();
 
+	/// Sets whether hidden elements are skipped when the context is updated. Elements with a 'display' of 'none'
+	/// and hidden documents then have no definitions resolved and aren't updated, and nor are any of their
+	/// descendants; hidden documents aren't laid out either. They catch up when they are next shown. By default,
+	/// every element is updated.
+	/// @param[in] skip True to skip hidden elements, false to update every element.
+	void SetSkipHiddenElements(bool skip);
+	/// Returns true if hidden elements are skipped when the context is updated.
+	/// @return True if hidden elements are skipped.
+	bool GetSkipHiddenElements() const;
+
+	/// Sets whether the context's documents are formatted concurrently. Documents are then formatted together at the
+	/// end of the context's update, rather than each during its own update, and again before rendering if required.
+	/// If the system interface can run tasks concurrently, each dirty document is formatted as a separate task, as is
+	/// each dirty layout root (such as an absolutely-positioned or floated element) within a document that doesn't
+	/// need to be formatted in its entirety. By default, documents are formatted one at a time.
+	///
+	/// While the documents are formatted, custom elements' GetIntrinsicDimensions() may be called from any of the
+	/// tasks, and messages may be logged from them. Resize, scroll and other events raised by the layout are
+	/// dispatched once every document has been formatted. Scrollbars are created, hidden, on every element that may
+	/// need them before it is formatted. Tools/layoutbench has an example system interface that runs the tasks on
+	/// threads.
+	/// @param[in] concurrent True to format documents concurrently, false to format them one at a time.
+	void SetConcurrentLayout(bool concurrent);
+	/// Returns true if the context's documents are formatted concurrently.
+	/// @return True if documents are formatted concurrently.
+	bool GetConcurrentLayout() const;
+
 	/// Creates a new, empty document and places it into this context.
 	/// @param[in] tag The document type to create.
 	/// @return The new document, or NULL if no document could be created. The document is returned with a reference owned by the caller.
@@ -268,6 +295,11 @@ private:
 
 	ElementDocument* cursor_proxy;
 
+	// True if hidden elements and documents are skipped during the update.
+	bool skip_hidden_elements;
+	// True if documents are formatted concurrently.
+	bool concurrent_layout;
+
 	// The element that is currently being dragged (or about to be dragged).
 	ElementReference drag;
 	// True if a drag has begun (ie, the ondragstart event has been fired for the drag element), false otherwise.
@@ -327,6 +359,8 @@ private:
 
 	// Releases all unloaded documents pending destruction.
 	void ReleaseUnloadedDocuments();
+	// Formats the documents whose layouts are dirty, concurrently if we allow it.
+	void UpdateLayouts();
 
 	// Sends the specified event to all elements in new_items that don't appear in old_items.
 	static void SendEvents(const ElementSet& old_items, const ElementSet& new_items, const String& event, const Dictionary& parameters, bool interruptible);
@@ -32,6 +32,7 @@
 #include <Rocket/Core/Math.h>
 #include <Rocket/Core/Header.h>
 #include <Rocket/Core/Box.h>
+#include <Rocket/Core/ComputedStyle.h>
 #include <Rocket/Core/Context.h>
 #include <Rocket/Core/ContextInstancer.h>
 #include <Rocket/Core/Decorator.h>
@@ -57,11 +58,14 @@
 #include <Rocket/Core/Geometry.h>
 #include <Rocket/Core/GeometryUtilities.h>
 #include <Rocket/Core/Input.h>
+#include <Rocket/Core/LayoutStatistics.h>
 #include <Rocket/Core/Log.h>
 #include <Rocket/Core/Plugin.h>
 #include <Rocket/Core/Property.h>
 #include <Rocket/Core/PropertyDefinition.h>
 #include <Rocket/Core/PropertyDictionary.h>
+#include <Rocket/Core/PropertyIds.h>
+#include <Rocket/Core/PropertyIdSet.h>
 #include <Rocket/Core/PropertyParser.h>
 #include <Rocket/Core/PropertySpecification.h>
 #include <Rocket/Core/RenderInterface.h>
@@ -69,6 +73,7 @@
 #include <Rocket/Core/StyleSheet.h>
 #include <Rocket/Core/StyleSheetKeywords.h>
 #include <Rocket/Core/StyleSheetSpecification.h>
+#include <Rocket/Core/StyleStatistics.h>
 #include <Rocket/Core/SystemInterface.h>
 #include <Rocket/Core/Texture.h>
 #include <Rocket/Core/Types.h>
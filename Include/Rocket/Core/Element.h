@@ -34,6 +34,8 @@
 #include <Rocket/Core/Box.h>
 #include <Rocket/Core/Event.h>
 #include <Rocket/Core/Property.h>
+#include <Rocket/Core/PropertyIds.h>
+#include <Rocket/Core/PropertyIdSet.h>
 #include <Rocket/Core/Types.h>
 
 namespace Rocket {
@@ -45,6 +47,7 @@ namespace Core {
 namespace Rocket {
 namespace Core {
 
+struct ComputedStyle;
 class Context;
 class Decorator;
 class ElementInstancer;
@@ -100,6 +103,9 @@ public:
 	/// Return the active class list.
 	/// @return The space-separated list of classes active on the element.
 	String GetClassNames() const;
+	/// Returns the active class list.
+	/// @return The list of classes active on the element.
+	const StringList& GetClassNameList() const;
 	//@}
 
 	/// Returns the active style sheet for this element. This may be NULL.
@@ -195,31 +201,64 @@ public:
 	/// @param[in] property The parsed property to set.
 	/// @return True if the property was set successfully, false otherwise.
 	bool SetProperty(const String& name, const Property& property);
+	/// Sets a number of local property overrides on the element to pre-parsed values. This is faster than setting
+	/// each property individually, as the changes are propagated through the element's hierarchy once.
+	/// @param[in] properties The parsed properties to set.
+	/// @return True if all of the properties were set successfully, false if any were not.
+	bool SetProperties(const PropertyDictionary& properties);
 	/// Removes a local property override on the element; its value will revert to that defined in
 	/// the style sheet.
 	/// @param[in] name The name of the local property definition to remove.
 	void RemoveProperty(const String& name);
+	/// Begins a batch of style changes on the element. Until the matching call to EndStyleUpdate(), properties
+	/// set, removed or changed by pseudo-classes on the element are collected and propagated once when the batch
+	/// ends. Calls may be nested. The element's own property values are kept up to date during the batch, and its
+	/// descendants read the new values of the properties they inherit, but their computed styles aren't rebuilt and
+	/// they aren't notified of the changes until the batch ends, so it should be ended before the context is updated.
+	void BeginStyleUpdate();
+	/// Ends a batch of style changes begun with BeginStyleUpdate().
+	void EndStyleUpdate();
 	/// Returns one of this element's properties. If this element is not defined this property, or a parent cannot
 	/// be found that we can inherit the property from, the default value will be returned.
 	/// @param[in] name The name of the property to fetch the value for.
 	/// @return The value of this property for this element, or NULL if no property exists with the given name.
 	const Property* GetProperty(const String& name);		
+	/// Returns one of this element's registered properties. This is faster than looking the property up by name.
+	/// @param[in] id The identifier of the property to fetch the value for.
+	/// @return The value of this property for this element, or NULL if the identifier is invalid.
+	const Property* GetProperty(PropertyId id);
 	/// Returns the values of one of this element's properties.		
 	/// @param[in] name The name of the property to get.
 	/// @return The value of this property.
 	template < typename T >
 	T GetProperty(const String& name);
+	/// Returns the values of one of this element's registered properties.
+	/// @param[in] id The identifier of the property to get.
+	/// @return The value of this property.
+	template < typename T >
+	T GetProperty(PropertyId id);
 	/// Returns one of this element's properties. If this element is not defined this property, NULL will be
 	/// returned.
 	/// @param[in] name The name of the property to fetch the value for.
 	/// @return The value of this property for this element, or NULL if this property has not been explicitly defined for this element.
 	const Property* GetLocalProperty(const String& name);		
+	/// Returns one of this element's registered properties. If this element is not defined this property, NULL
+	/// will be returned.
+	/// @param[in] id The identifier of the property to fetch the value for.
+	/// @return The value of this property for this element, or NULL if this property has not been explicitly defined for this element.
+	const Property* GetLocalProperty(PropertyId id);
 	/// Resolves one of this element's properties. If the value is a number or px, this is returned. If it's a 
 	/// percentage then it is resolved based on the second argument (the base value).
 	/// @param[in] name The name of the property to resolve the value for.
 	/// @param[in] base_value The value that is scaled by the percentage value, if it is a percentage.
 	/// @return The value of this property for this element.
 	float ResolveProperty(const String& name, float base_value);
+	/// Resolves one of this element's registered properties. If the value is a number or px, this is returned. If
+	/// it's a percentage then it is resolved based on the second argument (the base value).
+	/// @param[in] id The identifier of the property to resolve the value for.
+	/// @param[in] base_value The value that is scaled by the percentage value, if it is a percentage.
+	/// @return The value of this property for this element.
+	float ResolveProperty(PropertyId id, float base_value);
 	/// Resolves one of this element's non-inherited properties. If the value is a number or px, this is returned. If it's a 
 	/// percentage then it is resolved based on the second argument (the base value).
 	/// @param[in] name The property to resolve the value for.
@@ -258,6 +297,11 @@ public:
 	/// Returns 'vertical-align' property value from element's style or local cache.
 	const Property *GetVerticalAlignProperty();
 
+	/// Returns the element's computed style. The values are resolved once each time the element's properties change,
+	/// so this is the preferred way to read the style in layout and rendering code.
+	/// @return The element's computed style.
+	const ComputedStyle& GetComputedStyle();
+
 	/// Iterates over the properties defined on this element.
 	/// @param[inout] index Index of the property to fetch. This is incremented to the next valid index after the fetch. Indices are not necessarily incremental.
 	/// @param[out] pseudo_classes The pseudo-classes the property is defined by.
@@ -578,12 +622,21 @@ public:
 	/// Update the element's layout if required.
 	void UpdateLayout();
 
+	/// Marks the element as needing an update on the next update loop. Only elements marked as such (and their
+	/// ancestors) are visited by the loop; OnUpdate() is only called on elements that have been marked.
+	void DirtyUpdate();
+	/// Sets whether the element is to be updated on every update loop, whether or not it has been marked as
+	/// needing an update. This should be enabled by elements that need to be ticked every frame from OnUpdate().
+	/// @param[in] continuous_update True to update the element every frame, false to only update it when required.
+	void SetContinuousUpdate(bool continuous_update);
+
 protected:
 	/// Forces the element to generate a local stacking context, regardless of the value of its z-index
 	/// property.
 	void ForceLocalStackingContext();
 
-	/// Called during the update loop after children are updated.
+	/// Called during the update loop after children are updated, if the element has been marked as needing an update
+	/// or has continuous updates enabled.
 	virtual void OnUpdate();
 	/// Called during render after backgrounds, borders, decorators, but before children, are rendered.
 	virtual void OnRender();
@@ -596,7 +649,7 @@ protected:
 	virtual void OnAttributeChange(const AttributeNameList& changed_attributes);
 	/// Called when properties on the element are changed.
 	/// @param[in] changed_properties The properties changed on the element.
-	virtual void OnPropertyChange(const PropertyNameList& changed_properties);
+	virtual void OnPropertyChange(const PropertyIdSet& changed_properties);
 
 	/// Called when a child node has been added somewhere in the hierarchy.
 	// @param[in] child The element that has been added. This may be this element.
@@ -613,6 +666,10 @@ protected:
 
 	/// Increment/Decrement the layout lock
 	virtual void LockLayout(bool lock);
+	/// Returns true if the element's document is being formatted concurrently with others. While it is, anything
+	/// done during layout that affects state outside of the document (such as generating geometry or dispatching
+	/// events) has to wait until the layout is finished.
+	bool IsLayoutDeferred();
 
 	/// Forces a reevaluation of applicable font effects.
 	virtual void DirtyFont();
@@ -638,6 +695,27 @@ private:
 
 	void DirtyStructure();
 
+	// Returns true if the element is hidden and its context skips hidden elements, in which case neither it nor its
+	// descendants are updated.
+	bool IsUpdateSkipped();
+
+	// Returns the nearest of our ancestors within our document that is a layout root, or NULL if we have none.
+	Element* GetParentLayoutRoot();
+
+	// Prepares this element and its descendants to be formatted concurrently with other elements, by resolving
+	// everything that would otherwise be lazily resolved from shared state during layout.
+	void PrepareConcurrentLayout();
+	// Regenerates our decoration for our new box, and sends the resize event.
+	void OnBoxChange();
+	// Shows or hides our scrollbars after they've been enabled or disabled.
+	void UpdateScrollbarVisibility();
+	// Formats our scrollbars after we've been sized.
+	void FormatScrollbars();
+	// Notifies us that we've been formatted.
+	void OnLayoutComplete();
+	// Runs anything deferred on us and our descendants while our document was formatted concurrently.
+	void ProcessDeferredLayout();
+
 	// Original tag this element came from.
 	String tag;
 
@@ -700,6 +778,35 @@ private:
 	ElementList active_children;
 	ElementList deleted_children;
 
+	// Set if this element needs to be updated on the next update loop, or if one of its descendants does.
+	bool update_dirty;
+	bool child_update_dirty;
+	// Set if this element is updated on every update loop.
+	bool continuous_update;
+
+	// Set if the element was last formatted independently of its surroundings (as a float, inline-block or
+	// absolutely-positioned element). If only its contents change, it can be formatted again on its own against the
+	// containing block it was last formatted in.
+	bool layout_root;
+	Vector2f layout_root_containing_block;
+	// Set if this element is a layout root that needs to be formatted again, or if one of its descendants is.
+	bool layout_root_dirty;
+	bool child_layout_root_dirty;
+	// Set if this element or one of its descendants has changed in a way affecting layout since the element was last
+	// formatted. If not, a layout root formatted against the same containing block as before can keep its layout.
+	bool subtree_layout_dirty;
+
+	enum DeferredLayout
+	{
+		DEFERRED_BOX_CHANGE = 1 << 0,
+		DEFERRED_SCROLLBAR_VISIBILITY = 1 << 1,
+		DEFERRED_SCROLLBARS = 1 << 2,
+		DEFERRED_LAYOUT_COMPLETE = 1 << 3
+	};
+
+	// The notifications deferred while our document was formatted concurrently.
+	int deferred_layout;
+
 	float z_index;
 	bool local_stacking_context;
 	bool local_stacking_context_forced;
@@ -716,9 +823,12 @@ private:
 	bool clipping_state_dirty;
 
 	friend class Context;
+	friend class ElementScroll;
 	friend class ElementStyle;
+	friend class LayoutBlockBox;
 	friend class LayoutEngine;
 	friend class LayoutInlineBox;
+	friend class LayoutUpdateBatch;
 };
 
 #include <Rocket/Core/Element.inl>
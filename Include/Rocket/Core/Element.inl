@@ -35,6 +35,15 @@ T Element::GetProperty(const String& name)
 	return property->Get< T >();
 }
 
+// Returns the values of one of this element's registered properties.
+template < typename T >
+T Element::GetProperty(PropertyId id)
+{
+	const Property* property = GetProperty(id);
+	ROCKET_ASSERTMSG(property, "Invalid property identifier.");
+	return property->Get< T >();
+}
+
 // Sets an attribute on the element.
 template< typename T >
 void Element::SetAttribute(const String& name, const T& value)
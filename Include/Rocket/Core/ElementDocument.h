@@ -139,12 +139,12 @@ protected:
 	virtual void OnUpdate();
 
 	/// Repositions the document if necessary.
-	virtual void OnPropertyChange(const PropertyNameList& changed_properties);
+	virtual void OnPropertyChange(const PropertyIdSet& changed_properties);
 
 	/// Sets the dirty flag on the layout so the document will format its children before the next render.
 	virtual void DirtyLayout();
 
-	/// Returns true if the document has been marked as needing a re-layout.
+	/// Returns true if the entire document has been marked as needing a re-layout.
 	virtual bool IsLayoutDirty();
 
 	/// Processes the 'onpropertychange' event, checking for a change in position or size.
@@ -172,12 +172,23 @@ private:
 
 	// Is the layout dirty?
 	bool layout_dirty;
+	// Does the entire document need formatting, or only the dirty layout roots within it?
+	bool document_layout_dirty;
 	int lock_layout;
+	// Set while the document is being formatted concurrently with other documents or layout roots.
+	bool concurrent_layout;
 
 	friend class Context;
+	friend class Element;
 	friend class Factory;
+	friend class LayoutUpdateBatch;
 	
 	void _UpdateLayout();
+	// Formats the entire document.
+	void FormatDocument();
+	// Sets the dirty flag on the layout so the dirty layout roots within the document will be formatted before the
+	// next render.
+	void DirtyLayoutRoots();
 };
 
 }
@@ -65,6 +65,11 @@ public:
 	/// Disables and hides one of the scrollbars.
 	/// @param[in] orientation Which scrollbar (vertical or horizontal) to disable.
 	void DisableScrollbar(Orientation orientation);
+	/// Creates, hidden, any scrollbars that may be enabled on the element given its overflow properties, so they
+	/// don't need to be created while it is being formatted.
+	void CreateScrollbars();
+	/// Shows the enabled scrollbars and hides the disabled ones.
+	void UpdateScrollbarVisibility();
 
 	/// Updates the position of the scrollbar.
 	/// @param[in] orientation Which scrollbar (vertical or horizontal) to update).
@@ -95,6 +100,8 @@ private:
 		Element* element;
 		WidgetSliderScroll* widget;
 		bool enabled;
+		// True if the scrollbar was last made visible, false if it was hidden or hasn't been shown yet.
+		bool visible;
 		float size;
 	};
 
@@ -0,0 +1,67 @@
+/*
+ * This source file is part of libRocket, the HTML/CSS Interface Middleware
+ *
+ * For the latest information, see http://www.librocket.com
+ *
+ * Copyright (c) 2008-2010 CodePoint Ltd, Shift Technology Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef ROCKETCORELAYOUTSTATISTICS_H
+#define ROCKETCORELAYOUTSTATISTICS_H
+
+#include <Rocket/Core/Header.h>
+
+namespace Rocket {
+namespace Core {
+
+/**
+	Read-only access to the layout engine's performance counters. The counters are only gathered when the library
+	is built with ROCKET_ENABLE_LAYOUT_STATS defined (the ENABLE_LAYOUT_STATS CMake option); otherwise the recording
+	points compile away entirely and every query returns zero. Reset the counters once per frame to read them as
+	per-frame figures. The counters aren't synchronised, so they may undercount while a context's documents are
+	formatted concurrently.
+ */
+
+class ROCKETCORE_API LayoutStatistics
+{
+public:
+	/// Returns true if the library was built with layout statistics enabled.
+	static bool IsEnabled();
+	/// Resets all counters to zero. This must not be called while a context is being updated or rendered.
+	static void Reset();
+
+	/// Returns the number of elements that have been formatted by the layout engine.
+	static unsigned int GetFormattedElements();
+	/// Returns the number of times a document has been formatted in its entirety.
+	static unsigned int GetDocumentLayouts();
+	/// Returns the number of times a layout root (an element formatted independently of its surroundings, such as a
+	/// float or an absolutely-positioned element) has been formatted without formatting the rest of its document.
+	static unsigned int GetSubtreeLayouts();
+	/// Returns the number of times a layout root has kept its previous layout, as nothing within it nor its
+	/// containing block had changed since it was last formatted.
+	static unsigned int GetReusedLayouts();
+};
+
+}
+}
+
+#endif
@@ -78,7 +78,7 @@ public:
 		definition = NULL;
 		parser_index = -1;
 
-		source_line_number = 0;
+		source_index = 0;
 	}
 
 	~Property();	
@@ -93,6 +93,15 @@ public:
 		return value.Get<T>();
 	}
 
+	/// Sets the source the property was declared in.
+	/// @param[in] source The file the property was declared in.
+	/// @param[in] source_line_number The line the property was declared on.
+	void SetSource(const String& source, int source_line_number);
+	/// Returns the file the property was declared in, or an empty string if it wasn't declared in a file.
+	String GetSource() const;
+	/// Returns the line the property was declared on, or 0 if it wasn't declared in a file.
+	int GetSourceLineNumber() const;
+
 	Variant value;
 	Unit unit;
 	int specificity;
@@ -100,8 +109,9 @@ public:
 	const PropertyDefinition* definition;
 	int parser_index;
 
-	String source;
-	int source_line_number;
+	// The index of the property's source in the table of declaration sources; the sources are only needed for
+	// debugging, so they are kept out of the property itself.
+	int source_index;
 };
 
 }
@@ -31,6 +31,7 @@
 #include <Rocket/Core/Header.h>
 #include <Rocket/Core/Property.h>
 #include <Rocket/Core/PropertyParser.h>
+#include <Rocket/Core/PropertyIds.h>
 
 namespace Rocket {
 namespace Core {
@@ -42,7 +43,7 @@ namespace Core {
 class ROCKETCORE_API PropertyDefinition
 {
 public:
-	PropertyDefinition(const String& default_value, bool inherited, bool forces_layout);
+	PropertyDefinition(PropertyId id, const String& default_value, bool inherited, bool forces_layout);
 	virtual ~PropertyDefinition();
 
 	/// Registers a parser to parse values for this definition.
@@ -71,13 +72,27 @@ public:
 	/// Returns the default defined for this property.
 	const Property* GetDefaultValue() const;
 
+	/// Returns the identifier the property was registered under in its specification.
+	PropertyId GetId() const;
+
+	/// Returns the number of parsers registered on this definition.
+	int GetNumParsers() const;
+	/// Returns the name of one of this definition's parsers.
+	/// @param[in] index The index of the parser, in the order it was added.
+	const String& GetParserName(int index) const;
+	/// Returns the validation parameters (ie, the keywords) of one of this definition's parsers.
+	/// @param[in] index The index of the parser, in the order it was added.
+	const ParameterMap& GetParserParameters(int index) const;
+
 private:
+	PropertyId id;
 	Property default_value;
 	bool inherited;
 	bool forces_layout;
 
 	struct ParserState
 	{
+		String name;
 		PropertyParser* parser;
 		ParameterMap parameters;
 	};
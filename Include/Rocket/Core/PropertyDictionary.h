@@ -30,6 +30,7 @@
 
 #include <Rocket/Core/Header.h>
 #include <Rocket/Core/Property.h>
+#include <Rocket/Core/PropertyIds.h>
 
 namespace Rocket {
 namespace Core {
@@ -46,18 +47,32 @@ class ROCKETCORE_API PropertyDictionary
 {
 public:
 	PropertyDictionary();
+	PropertyDictionary(const PropertyDictionary& copy);
 	~PropertyDictionary();
 
+	PropertyDictionary& operator=(const PropertyDictionary& copy);
+
 	/// Sets a property on the dictionary. Any existing property with a similar name will be overwritten.
 	/// @param[in] name The name of the property to add.
 	/// @param[in] property The value of the new property.
 	void SetProperty(const String& name, const Property& property);
+	/// Sets a registered property on the dictionary. Any existing property with the same identifier will be
+	/// overwritten.
+	/// @param[in] id The identifier of the property to add.
+	/// @param[in] property The value of the new property.
+	void SetProperty(PropertyId id, const Property& property);
 	/// Removes a property from the dictionary, if it exists.
 	/// @param[in] name The name of the property to remove.
 	void RemoveProperty(const String& name);
+	/// Removes a registered property from the dictionary, if it exists.
+	/// @param[in] id The identifier of the property to remove.
+	void RemoveProperty(PropertyId id);
 	/// Returns the value of the property with the requested name, if one exists.
 	/// @param[in] name The name of the desired property.
 	const Property* GetProperty(const String& name) const;
+	/// Returns the value of the registered property with the requested identifier, if one exists.
+	/// @param[in] id The identifier of the desired property.
+	const Property* GetProperty(PropertyId id) const;
 
 	/// Returns the number of properties in the dictionary.
 	/// @return The number of properties in the dictionary.
@@ -86,8 +101,14 @@ private:
 	// specificity (given by the parameter, not read from the property itself) is at least equal to
 	// the specificity of the conflicting property.
 	void SetProperty(const String& name, const Rocket::Core::Property& property, int specificity);
+	// Stores a property under its name and identifier.
+	Property& StoreProperty(PropertyId id, const String& name, const Property& property);
+	// Rebuilds the identifier index from the property map.
+	void BuildIndex();
 
 	PropertyMap properties;
+	// The registered properties in the map, indexed by property identifier.
+	std::vector< Property* > property_index;
 };
 
 }
@@ -0,0 +1,120 @@
+/*
+ * This source file is part of libRocket, the HTML/CSS Interface Middleware
+ *
+ * For the latest information, see http://www.librocket.com
+ *
+ * Copyright (c) 2008-2010 CodePoint Ltd, Shift Technology Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+#ifndef ROCKETCOREPROPERTYIDSET_H
+#define ROCKETCOREPROPERTYIDSET_H
+
+#include <Rocket/Core/Types.h>
+#include <Rocket/Core/Math.h>
+#include <Rocket/Core/PropertyIds.h>
+
+namespace Rocket {
+namespace Core {
+
+/**
+	A set of registered property identifiers, stored as a bitset. The identifiers of the first properties registered
+	are stored inline, so sets of changed properties are built, merged, compared and searched without allocating; a
+	set only allocates if a property registered beyond those is inserted into it.
+
+	Iterate over a set with:
+		for (PropertyId id = set.First(); id != PROPERTY_INVALID; id = set.Next(id))
+ */
+
+class PropertyIdSet
+{
+public:
+	/// The number of registered properties that can be stored in a set without allocating.
+	static const int NUM_INLINE_PROPERTIES = 128;
+
+	/// Constructs an empty set.
+	inline PropertyIdSet();
+
+	/// Adds a property to the set.
+	/// @param[in] id The identifier of the property to add.
+	inline void Insert(PropertyId id);
+	/// Removes a property from the set.
+	/// @param[in] id The identifier of the property to remove.
+	inline void Erase(PropertyId id);
+	/// Checks if a property is in the set.
+	/// @param[in] id The identifier of the property to check for.
+	/// @return True if the property is in the set.
+	inline bool Contains(PropertyId id) const;
+	/// Removes every property from the set.
+	inline void Clear();
+
+	/// Returns true if the set contains no properties.
+	inline bool Empty() const;
+	/// Returns the number of properties in the set.
+	inline int Count() const;
+	/// Returns true if this set shares any properties with another.
+	/// @param[in] other The set to check against.
+	inline bool Intersects(const PropertyIdSet& other) const;
+
+	/// Returns the lowest identifier in the set, or PROPERTY_INVALID if the set is empty.
+	inline PropertyId First() const;
+	/// Returns the lowest identifier in the set greater than another, or PROPERTY_INVALID if there is none.
+	/// @param[in] id The identifier to continue on from.
+	inline PropertyId Next(PropertyId id) const;
+
+	/// Adds the properties of another set to this one.
+	inline PropertyIdSet& operator|=(const PropertyIdSet& rhs);
+	/// Removes the properties from this set that aren't in another.
+	inline PropertyIdSet& operator&=(const PropertyIdSet& rhs);
+	/// Returns the properties in either this set or another.
+	inline PropertyIdSet operator|(const PropertyIdSet& rhs) const;
+	/// Returns the properties in both this set and another.
+	inline PropertyIdSet operator&(const PropertyIdSet& rhs) const;
+	/// Removes the properties in another set from this one.
+	inline void Subtract(const PropertyIdSet& rhs);
+
+	/// Equality operator.
+	inline bool operator==(const PropertyIdSet& rhs) const;
+	/// Inequality operator.
+	inline bool operator!=(const PropertyIdSet& rhs) const;
+
+private:
+	enum { BITS_PER_WORD = 64, NUM_INLINE_WORDS = NUM_INLINE_PROPERTIES / BITS_PER_WORD };
+
+	// Returns the number of words in the set, including those that aren't stored inline.
+	inline int GetNumWords() const;
+	// Returns one of the words of the set, or zero if the word is beyond those stored.
+	inline uint64_t GetWord(int index) const;
+	// Returns one of the words of the set for modification, allocating it and any before it if necessary.
+	inline uint64_t& GetWordForInsert(int index);
+
+	uint64_t words[NUM_INLINE_WORDS];
+	// The words of identifiers beyond those stored inline, allocated as properties are inserted.
+	std::vector< uint64_t > overflow_words;
+};
+
+}
+}
+
+#include <Rocket/Core/PropertyIdSet.inl>
+
+#endif
@@ -0,0 +1,250 @@
+/*
+ * This source file is part of libRocket, the HTML/CSS Interface Middleware
+ *
+ * For the latest information, see http://www.librocket.com
+ *
+ * Copyright (c) 2008-2010 CodePoint Ltd, Shift Technology Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+namespace Rocket {
+namespace Core {
+
+// Constructs an empty set.
+PropertyIdSet::PropertyIdSet()
+{
+	for (int i = 0; i < NUM_INLINE_WORDS; ++i)
+		words[i] = 0;
+}
+
+// Adds a property to the set.
+void PropertyIdSet::Insert(PropertyId id)
+{
+	if (id >= 0)
+		GetWordForInsert(id / BITS_PER_WORD) |= (uint64_t) 1 << (id % BITS_PER_WORD);
+}
+
+// Removes a property from the set.
+void PropertyIdSet::Erase(PropertyId id)
+{
+	if (id >= 0 && id / BITS_PER_WORD < GetNumWords())
+		GetWordForInsert(id / BITS_PER_WORD) &= ~((uint64_t) 1 << (id % BITS_PER_WORD));
+}
+
+// Checks if a property is in the set.
+bool PropertyIdSet::Contains(PropertyId id) const
+{
+	if (id < 0)
+		return false;
+
+	return (GetWord(id / BITS_PER_WORD) & ((uint64_t) 1 << (id % BITS_PER_WORD))) != 0;
+}
+
+// Removes every property from the set.
+void PropertyIdSet::Clear()
+{
+	for (int i = 0; i < NUM_INLINE_WORDS; ++i)
+		words[i] = 0;
+
+	overflow_words.clear();
+}
+
+// Returns true if the set contains no properties.
+bool PropertyIdSet::Empty() const
+{
+	for (int i = 0; i < GetNumWords(); ++i)
+	{
+		if (GetWord(i) != 0)
+			return false;
+	}
+
+	return true;
+}
+
+// Returns the number of properties in the set.
+int PropertyIdSet::Count() const
+{
+	int count = 0;
+	for (int i = 0; i < GetNumWords(); ++i)
+	{
+		for (uint64_t word = GetWord(i); word != 0; word &= word - 1)
+			++count;
+	}
+
+	return count;
+}
+
+// Returns true if this set shares any properties with another.
+bool PropertyIdSet::Intersects(const PropertyIdSet& other) const
+{
+	int num_words = Math::Min(GetNumWords(), other.GetNumWords());
+	for (int i = 0; i < num_words; ++i)
+	{
+		if ((GetWord(i) & other.GetWord(i)) != 0)
+			return true;
+	}
+
+	return false;
+}
+
+// Returns the lowest identifier in the set.
+PropertyId PropertyIdSet::First() const
+{
+	return Next(PROPERTY_INVALID);
+}
+
+// Returns the lowest identifier in the set greater than another.
+PropertyId PropertyIdSet::Next(PropertyId id) const
+{
+	int num_properties = GetNumWords() * BITS_PER_WORD;
+	for (++id; id < num_properties; ++id)
+	{
+		uint64_t word = GetWord(id / BITS_PER_WORD) >> (id % BITS_PER_WORD);
+
+		// Skip straight to the next word if there's nothing left in this one.
+		if (word == 0)
+		{
+			id |= BITS_PER_WORD - 1;
+			continue;
+		}
+
+		while ((word & 1) == 0)
+		{
+			word >>= 1;
+			++id;
+		}
+
+		return id;
+	}
+
+	return PROPERTY_INVALID;
+}
+
+// Adds the properties of another set to this one.
+PropertyIdSet& PropertyIdSet::operator|=(const PropertyIdSet& rhs)
+{
+	for (int i = 0; i < NUM_INLINE_WORDS; ++i)
+		words[i] |= rhs.words[i];
+
+	if (overflow_words.size() < rhs.overflow_words.size())
+		overflow_words.resize(rhs.overflow_words.size(), 0);
+	for (size_t i = 0; i < rhs.overflow_words.size(); ++i)
+		overflow_words[i] |= rhs.overflow_words[i];
+
+	return *this;
+}
+
+// Removes the properties from this set that aren't in another.
+PropertyIdSet& PropertyIdSet::operator&=(const PropertyIdSet& rhs)
+{
+	for (int i = 0; i < NUM_INLINE_WORDS; ++i)
+		words[i] &= rhs.words[i];
+
+	if (overflow_words.size() > rhs.overflow_words.size())
+		overflow_words.resize(rhs.overflow_words.size());
+	for (size_t i = 0; i < overflow_words.size(); ++i)
+		overflow_words[i] &= rhs.overflow_words[i];
+
+	return *this;
+}
+
+// Returns the properties in either this set or another.
+PropertyIdSet PropertyIdSet::operator|(const PropertyIdSet& rhs) const
+{
+	PropertyIdSet result(*this);
+	result |= rhs;
+	return result;
+}
+
+// Returns the properties in both this set and another.
+PropertyIdSet PropertyIdSet::operator&(const PropertyIdSet& rhs) const
+{
+	PropertyIdSet result(*this);
+	result &= rhs;
+	return result;
+}
+
+// Removes the properties in another set from this one.
+void PropertyIdSet::Subtract(const PropertyIdSet& rhs)
+{
+	for (int i = 0; i < NUM_INLINE_WORDS; ++i)
+		words[i] &= ~rhs.words[i];
+
+	size_t num_overflow_words = Math::Min(overflow_words.size(), rhs.overflow_words.size());
+	for (size_t i = 0; i < num_overflow_words; ++i)
+		overflow_words[i] &= ~rhs.overflow_words[i];
+}
+
+// Equality operator.
+bool PropertyIdSet::operator==(const PropertyIdSet& rhs) const
+{
+	// Sets may have allocated different numbers of words, so any words beyond those of the other set must be empty.
+	int num_words = Math::Max(GetNumWords(), rhs.GetNumWords());
+	for (int i = 0; i < num_words; ++i)
+	{
+		if (GetWord(i) != rhs.GetWord(i))
+			return false;
+	}
+
+	return true;
+}
+
+// Inequality operator.
+bool PropertyIdSet::operator!=(const PropertyIdSet& rhs) const
+{
+	return !(*this == rhs);
+}
+
+// Returns the number of words in the set, including those that aren't stored inline.
+int PropertyIdSet::GetNumWords() const
+{
+	return NUM_INLINE_WORDS + (int) overflow_words.size();
+}
+
+// Returns one of the words of the set, or zero if the word is beyond those stored.
+uint64_t PropertyIdSet::GetWord(int index) const
+{
+	if (index < NUM_INLINE_WORDS)
+		return words[index];
+
+	index -= NUM_INLINE_WORDS;
+	if (index < (int) overflow_words.size())
+		return overflow_words[index];
+
+	return 0;
+}
+
+// Returns one of the words of the set for modification, allocating it and any before it if necessary.
+uint64_t& PropertyIdSet::GetWordForInsert(int index)
+{
+	if (index < NUM_INLINE_WORDS)
+		return words[index];
+
+	index -= NUM_INLINE_WORDS;
+	if (index >= (int) overflow_words.size())
+		overflow_words.resize(index + 1, 0);
+
+	return overflow_words[index];
+}
+
+}
+}
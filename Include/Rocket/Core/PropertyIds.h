@@ -0,0 +1,105 @@
+/*
+ * This source file is part of libRocket, the HTML/CSS Interface Middleware
+ *
+ * For the latest information, see http://www.librocket.com
+ *
+ * Copyright (c) 2008-2010 CodePoint Ltd, Shift Technology Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef ROCKETCOREPROPERTYIDS_H
+#define ROCKETCOREPROPERTYIDS_H
+
+namespace Rocket {
+namespace Core {
+
+/// Dense integer identifier for a registered property. Each property specification hands out identifiers in
+/// registration order; unless stated otherwise, identifiers refer to the style sheet specification, where
+/// properties registered by the application follow on from the default ones.
+typedef int PropertyId;
+
+/// Identifiers of Rocket's default properties. These must be kept in the same order as the properties are
+/// registered in StyleSheetSpecification::RegisterDefaultProperties().
+enum
+{
+	PROPERTY_INVALID = -1,
+
+	PROPERTY_MARGIN_TOP = 0,
+	PROPERTY_MARGIN_RIGHT,
+	PROPERTY_MARGIN_BOTTOM,
+	PROPERTY_MARGIN_LEFT,
+	PROPERTY_PADDING_TOP,
+	PROPERTY_PADDING_RIGHT,
+	PROPERTY_PADDING_BOTTOM,
+	PROPERTY_PADDING_LEFT,
+	PROPERTY_BORDER_TOP_WIDTH,
+	PROPERTY_BORDER_RIGHT_WIDTH,
+	PROPERTY_BORDER_BOTTOM_WIDTH,
+	PROPERTY_BORDER_LEFT_WIDTH,
+	PROPERTY_BORDER_TOP_COLOR,
+	PROPERTY_BORDER_RIGHT_COLOR,
+	PROPERTY_BORDER_BOTTOM_COLOR,
+	PROPERTY_BORDER_LEFT_COLOR,
+	PROPERTY_DISPLAY,
+	PROPERTY_POSITION,
+	PROPERTY_TOP,
+	PROPERTY_RIGHT,
+	PROPERTY_BOTTOM,
+	PROPERTY_LEFT,
+	PROPERTY_FLOAT,
+	PROPERTY_CLEAR,
+	PROPERTY_Z_INDEX,
+	PROPERTY_WIDTH,
+	PROPERTY_MIN_WIDTH,
+	PROPERTY_MAX_WIDTH,
+	PROPERTY_HEIGHT,
+	PROPERTY_MIN_HEIGHT,
+	PROPERTY_MAX_HEIGHT,
+	PROPERTY_LINE_HEIGHT,
+	PROPERTY_VERTICAL_ALIGN,
+	PROPERTY_OVERFLOW_X,
+	PROPERTY_OVERFLOW_Y,
+	PROPERTY_CLIP,
+	PROPERTY_VISIBILITY,
+	PROPERTY_BACKGROUND_COLOR,
+	PROPERTY_COLOR,
+	PROPERTY_FONT_FAMILY,
+	PROPERTY_FONT_CHARSET,
+	PROPERTY_FONT_STYLE,
+	PROPERTY_FONT_WEIGHT,
+	PROPERTY_FONT_SIZE,
+	PROPERTY_TEXT_ALIGN,
+	PROPERTY_TEXT_DECORATION,
+	PROPERTY_TEXT_TRANSFORM,
+	PROPERTY_WHITE_SPACE,
+	PROPERTY_CURSOR,
+	PROPERTY_DRAG,
+	PROPERTY_TAB_INDEX,
+	PROPERTY_FOCUS,
+	PROPERTY_SCROLLBAR_MARGIN,
+
+	NUM_DEFAULT_PROPERTIES
+};
+
+}
+}
+
+#endif
@@ -31,6 +31,7 @@
 #include <Rocket/Core/Header.h>
 #include <Rocket/Core/Element.h>
 #include <Rocket/Core/PropertyDefinition.h>
+#include <Rocket/Core/PropertyIdSet.h>
 
 namespace Rocket {
 namespace Core {
@@ -74,6 +75,18 @@ public:
 	/// @param[in] property_name The name of the desired property.
 	/// @return The appropriate property definition if it could be found, NULL otherwise.
 	const PropertyDefinition* GetProperty(const String& property_name) const;
+	/// Returns a property definition.
+	/// @param[in] id The identifier of the desired property.
+	/// @return The appropriate property definition if the identifier is valid, NULL otherwise.
+	const PropertyDefinition* GetProperty(PropertyId id) const;
+	/// Returns the identifier of a registered property.
+	/// @param[in] property_name The name of the desired property.
+	/// @return The property's identifier, or PROPERTY_INVALID if no property is registered under the name.
+	PropertyId GetPropertyId(const String& property_name) const;
+	/// Returns the name a property was registered under.
+	/// @param[in] id The identifier of the desired property.
+	/// @return The property's name, or an empty string if the identifier is invalid.
+	const String& GetPropertyName(PropertyId id) const;
 
 	/// Returns the list of the names of all registered property definitions.
 	/// @return The list with stored property names.
@@ -83,6 +96,14 @@ public:
 	/// @return The list with stored property names.
 	const PropertyNameList& GetRegisteredInheritedProperties() const;
 
+	/// Returns the set of the identifiers of all registered property definitions.
+	/// @return The set of registered property identifiers.
+	const PropertyIdSet& GetRegisteredPropertyIds() const;
+
+	/// Returns the set of the identifiers of all registered inherited property definitions.
+	/// @return The set of registered inherited property identifiers.
+	const PropertyIdSet& GetRegisteredInheritedPropertyIds() const;
+
 	/// Registers a shorthand property definition.
 	/// @param[in] shorthand_name The name to register the new shorthand property under.
 	/// @param[in] properties A comma-separated list of the properties this definition is shorthand for. The order in which they are specified here is the order in which the values will be processed.
@@ -110,8 +131,13 @@ private:
 
 	PropertyMap properties;
 	ShorthandMap shorthands;
+	// The registered definitions and their names, indexed by property identifier.
+	std::vector< PropertyDefinition* > property_index;
+	StringList property_index_names;
 	PropertyNameList property_names;
 	PropertyNameList inherited_property_names;
+	PropertyIdSet property_ids;
+	PropertyIdSet inherited_property_ids;
 
 	bool ParsePropertyValues(StringList& values_list, const String& values, bool split_values) const;
 };
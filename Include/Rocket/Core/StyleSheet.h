@@ -36,8 +36,12 @@
 namespace Rocket {
 namespace Core {
 
+class AncestorFilter;
+class DefinitionCache;
+struct DefinitionMatch;
 class Element;
 class ElementDefinition;
+class InvalidationMap;
 class StyleSheetNode;
 
 /**
@@ -50,7 +54,7 @@ class StyleSheetNode;
 class ROCKETCORE_API StyleSheet : public ReferenceCountable
 {
 public:
-	typedef std::set< StyleSheetNode* > NodeList;
+	typedef std::vector< StyleSheetNode* > NodeList;
 	typedef std::map< String, NodeList > NodeIndex;
 
 	StyleSheet();
@@ -58,6 +62,20 @@ public:
 
 	/// Loads a style from a CSS definition.
 	bool LoadStyleSheet(Stream* stream);
+	/// Loads a style sheet from its precompiled binary form, as written by WriteCompiledStyleSheet(). If the compiled
+	/// sheet is invalid, or was compiled from a different version of the RCSS, the style sheet is left unchanged.
+	/// @param[in] data The compiled sheet.
+	/// @param[in] length The length of the compiled sheet, in bytes.
+	/// @param[in] source The RCSS the sheet was compiled from. This is only read to check the compiled sheet is up to date.
+	/// @return True if the compiled sheet was loaded.
+	bool LoadCompiledStyleSheet(const byte* data, size_t length, Stream* source);
+	/// Writes the style sheet in its precompiled binary form. This should only be called on a sheet loaded directly
+	/// from RCSS. The parsed property values depend on the registered properties, so sheets compiled with a different
+	/// set of properties are rejected on load.
+	/// @param[in] stream The stream to write the compiled sheet to.
+	/// @param[in] source The RCSS the sheet was loaded from.
+	/// @return True if the sheet was compiled.
+	bool WriteCompiledStyleSheet(Stream* stream, Stream* source) const;
 
 	/// Combines this style sheet with another one, producing a new sheet.
 	StyleSheet* CombineStyleSheet(const StyleSheet* sheet) const;
@@ -66,7 +84,30 @@ public:
 
 	/// Returns the compiled element definition for a given element hierarchy. A reference count will be added for the
 	/// caller, so another should not be added. The definition should be released by removing the reference count.
-	ElementDefinition* GetElementDefinition(const Element* element) const;
+	/// @param[in] element The element to generate the definition for.
+	/// @param[in] ancestor_filter If set, a filter of the element's ancestors used to quickly reject inapplicable rules.
+	ElementDefinition* GetElementDefinition(const Element* element, const AncestorFilter* ancestor_filter = NULL) const;
+
+	/// Matches an element against the style sheet's rules, without looking up or creating its definition. This only
+	/// reads from the style sheet and the element hierarchy, so different elements may be matched concurrently as
+	/// long as the hierarchy isn't modified and the elements aren't structurally volatile.
+	/// @param[out] match The result of the match.
+	/// @param[in] element The element to match.
+	/// @param[in] ancestor_filter If set, a filter of the element's ancestors used to quickly reject inapplicable rules.
+	void MatchElement(DefinitionMatch& match, const Element* element, const AncestorFilter* ancestor_filter = NULL) const;
+	/// Returns the compiled element definition for the result of a match. A reference count will be added for the
+	/// caller, so another should not be added.
+	/// @param[in] match The result of matching the element.
+	/// @return The element's definition, or NULL if no rules apply to it.
+	ElementDefinition* GetElementDefinition(const DefinitionMatch& match) const;
+	/// Returns true if elements with the given tag may be matched by rules using structural pseudo-classes. Such
+	/// elements' definitions depend on their siblings, so they can't be matched concurrently.
+	/// @param[in] tag The tag of the element.
+	bool IsStructurallyVolatile(const String& tag) const;
+	/// Returns the map of the style sheet's rules depending on the classes, ids and pseudo-classes of their subjects'
+	/// ancestors.
+	/// @return The invalidation map, or NULL if the style sheet's index hasn't been built.
+	const InvalidationMap* GetInvalidationMap() const;
 
 protected:
 	/// Destroys the style sheet.
@@ -83,16 +124,24 @@ private:
 	// precedence in the event of a conflict.
 	int specificity_offset;
 
-	// Map of only nodes with actual style information.
-	NodeIndex styled_node_index;
-	// Map of every node, even empty, un-styled, nodes.
-	NodeIndex complete_node_index;
+	// The nodes that apply to elements, bucketed by the right-most id of their selectors; if a selector doesn't
+	// specify an id then it is bucketed by its right-most class, and failing that, its tag. Selectors with none of
+	// these are kept in the universal list, which is checked against every element.
+	NodeIndex id_node_index;
+	NodeIndex class_node_index;
+	NodeIndex tag_node_index;
+	NodeList universal_nodes;
+	// The tags (including the universal tag) of the structurally volatile tag nodes.
+	std::set< String > structurally_volatile_tags;
+	// The rules depending on the classes, ids and pseudo-classes of their subjects' ancestors.
+	InvalidationMap* invalidation_map;
+	// Set once the index has been built.
+	bool node_index_built;
 
-	typedef std::map< String, ElementDefinition* > ElementDefinitionCache;
-	// Index of element addresses to element definitions.
-	mutable ElementDefinitionCache address_cache;
 	// Index of node sets to element definitions.
-	mutable ElementDefinitionCache node_cache;
+	DefinitionCache* node_cache;
+	// The match used to look up definitions in the node cache, kept so its storage can be reused.
+	DefinitionMatch* node_match;
 };
 
 }
@@ -35,6 +35,7 @@
 namespace Rocket {
 namespace Core {
 
+class PropertyParseCache;
 class PropertyParser;
 
 /**
@@ -71,6 +72,18 @@ public:
 	/// @param[in] property_name The name of the desired property.
 	/// @return The appropriate property definition if it could be found, NULL otherwise.
 	static const PropertyDefinition* GetProperty(const String& property_name);
+	/// Returns a property definition.
+	/// @param[in] id The identifier of the desired property.
+	/// @return The appropriate property definition if the identifier is valid, NULL otherwise.
+	static const PropertyDefinition* GetProperty(PropertyId id);
+	/// Returns the identifier of a registered property.
+	/// @param[in] property_name The name of the desired property.
+	/// @return The property's identifier, or PROPERTY_INVALID if no property is registered under the name.
+	static PropertyId GetPropertyId(const String& property_name);
+	/// Returns the name a property was registered under.
+	/// @param[in] id The identifier of the desired property.
+	/// @return The property's name, or an empty string if the identifier is invalid.
+	static const String& GetPropertyName(PropertyId id);
 
 	/// Returns the list of the names of all registered property definitions.
 	/// @return The list with stored property names.
@@ -80,6 +93,14 @@ public:
 	/// @return The list with stored property names.
 	static const PropertyNameList & GetRegisteredInheritedProperties();
 
+	/// Returns the set of the identifiers of all registered property definitions.
+	/// @return The set of registered property identifiers.
+	static const PropertyIdSet& GetRegisteredPropertyIds();
+
+	/// Returns the set of the identifiers of all registered inherited property definitions.
+	/// @return The set of registered inherited property identifiers.
+	static const PropertyIdSet& GetRegisteredInheritedPropertyIds();
+
 	/// Registers a shorthand property definition.
 	/// @param[in] shorthand_name The name to register the new shorthand property under.
 	/// @param[in] properties A comma-separated list of the properties this definition is shorthand for. The order in which they are specified here is the order in which the values will be processed.
@@ -99,6 +120,17 @@ public:
 	/// @param[in] line_number The location of the source file where this property was declared. Used for error reporting and debugging.
 	/// @return True if all properties were parsed successfully, false otherwise.
 	static bool ParsePropertyDeclaration(PropertyDictionary& dictionary, const String& property_name, const String& property_value, const String& source_file = "", int source_line_number = 0);
+	/// Parses a property declaration without a source, as ParsePropertyDeclaration() does. The parsed values of
+	/// recent declarations are cached, so values set repeatedly from code aren't parsed again.
+	/// @param[in] dictionary The property dictionary which will hold all declared properties.
+	/// @param[in] property_name The name of the declared property.
+	/// @param[in] property_value The values the property is being set to.
+	/// @return True if all properties were parsed successfully, false otherwise.
+	static bool ParseCachedPropertyDeclaration(PropertyDictionary& dictionary, const String& property_name, const String& property_value);
+	/// Enables or disables the cache used by ParseCachedPropertyDeclaration(). The cache is enabled by default;
+	/// disabling it discards its contents.
+	/// @param[in] enabled True to cache parsed declarations, false to parse every declaration.
+	static void SetParseCacheEnabled(bool enabled);
 
 private:
 	StyleSheetSpecification();
@@ -115,6 +147,10 @@ private:
 
 	// The properties defined in the style sheet specification.
 	PropertySpecification properties;
+
+	// Recently parsed declarations; cleared whenever the specification changes.
+	PropertyParseCache* parse_cache;
+	bool parse_cache_enabled;
 };
 
 }
@@ -0,0 +1,82 @@
+/*
+ * This source file is part of libRocket, the HTML/CSS Interface Middleware
+ *
+ * For the latest information, see http://www.librocket.com
+ *
+ * Copyright (c) 2008-2010 CodePoint Ltd, Shift Technology Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+#ifndef ROCKETCORESTYLESTATISTICS_H
+#define ROCKETCORESTYLESTATISTICS_H
+
+#include <Rocket/Core/Header.h>
+#include <Rocket/Core/PropertyIds.h>
+
+namespace Rocket {
+namespace Core {
+
+/**
+	Read-only access to the style system's performance counters. The counters are only gathered when the library
+	is built with ROCKET_ENABLE_STYLE_STATS defined (the ENABLE_STYLE_STATS CMake option); otherwise the recording
+	points compile away entirely and every query returns zero.
+ */
+
+class ROCKETCORE_API StyleStatistics
+{
+public:
+	/// Returns true if the library was built with style statistics enabled.
+	static bool IsEnabled();
+	/// Resets all counters to zero. This must not be called while a context is being updated or rendered.
+	static void Reset();
+
+	/// Returns the number of times a property has been looked up through an element's style.
+	/// @param[in] id The identifier of the property.
+	/// @return The number of lookups since the last reset. Only the first 256 properties
+	/// registered are counted individually; lookups of any others are only counted in the total.
+	static unsigned int GetPropertyLookups(PropertyId id);
+	/// Returns the total number of property lookups through all elements' styles.
+	static unsigned int GetTotalPropertyLookups();
+
+	/// Returns the number of element style cache requests served from the cache.
+	static unsigned int GetCacheHits();
+	/// Returns the number of element style cache requests that had to resolve the property.
+	static unsigned int GetCacheMisses();
+
+	/// Returns the number of inherited property lookups that were not defined locally on the element.
+	static unsigned int GetInheritedLookups();
+	/// Returns the total number of ancestors visited while resolving inherited properties.
+	static unsigned int GetInheritedWalkSteps();
+	/// Returns the largest number of ancestors visited to resolve a single inherited property.
+	static unsigned int GetMaxInheritedWalkDepth();
+
+	/// Returns the number of times a pseudo-class (such as :hover) has been set on or removed from an element.
+	static unsigned int GetPseudoClassChanges();
+	/// Returns the number of element definitions that have had to be updated because of pseudo-class changes. Divide
+	/// by the number of changes for the restyles per hover or focus event.
+	static unsigned int GetPseudoClassRestyles();
+};
+
+}
+}
+
+#endif
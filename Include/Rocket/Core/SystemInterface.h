@@ -45,6 +45,8 @@ namespace Core {
 
 	The default implemention of Translation doesn't translate anything
 
+	The default implementation of Tasks runs every task sequentially on the calling thread
+
 	The default implementation of logging logs Windows Debug Console,
 	or Standard Error, depending on what platform you're using.
 
@@ -54,6 +56,9 @@ namespace Core {
 class ROCKETCORE_API SystemInterface : public ReferenceCountable
 {
 public:
+	/// A task function; it is called with the data passed to RunTasks() and the index of the task to run.
+	typedef void (*TaskFunction)(void* data, int task_index);
+
 	SystemInterface();
 	virtual ~SystemInterface();
 
@@ -79,6 +84,19 @@ public:
 	/// @return True to continue execution, false to break into the debugger.
 	virtual bool LogMessage(Log::Type type, const String& message);
 
+	/// Returns the number of tasks the application can run concurrently through RunTasks(). If this is greater than
+	/// one, large style updates (and the layouts of contexts that allow it) will be split into independent tasks and run
+	/// through RunTasks().
+	/// @return The number of concurrent tasks. The default implementation returns 1.
+	virtual int GetMaxConcurrentTasks();
+	/// Runs a batch of independent tasks, returning once every task has completed. The tasks only read from shared
+	/// state and write to their own results, so they may be run in any order and on any thread; applications with a
+	/// work-stealing scheduler should submit each task to it individually.
+	/// @param[in] function The function to call for each task.
+	/// @param[in] data The data to pass to each call of the function.
+	/// @param[in] num_tasks The number of tasks; the function is called once for each index from 0 to num_tasks - 1.
+	virtual void RunTasks(TaskFunction function, void* data, int num_tasks);
+
 	/// Activate keyboard (for touchscreen devices)
 	virtual void ActivateKeyboard();
 	
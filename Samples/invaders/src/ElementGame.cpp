@@ -35,6 +35,9 @@
 ElementGame::ElementGame(const Rocket::Core::String& tag) : Rocket::Core::Element(tag)
 {
 	game = new Game();
+
+	// The game is ticked from OnUpdate(), so we need to be updated every frame.
+	SetContinuousUpdate(true);
 }
 
 ElementGame::~ElementGame()
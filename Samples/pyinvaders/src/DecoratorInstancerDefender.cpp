@@ -46,7 +46,7 @@ Rocket::Core::Decorator* DecoratorInstancerDefender::InstanceDecorator(const Roc
 	Rocket::Core::String image_source = image_source_property->Get< Rocket::Core::String >();
 
 	DecoratorDefender* decorator = new DecoratorDefender();
-	if (decorator->Initialise(image_source, image_source_property->source))
+	if (decorator->Initialise(image_source, image_source_property->GetSource()))
 		return decorator;
 
 	decorator->RemoveReference();
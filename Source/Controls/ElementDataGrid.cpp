@@ -65,6 +65,9 @@ ElementDataGrid::ElementDataGrid(const Rocket::Core::String& tag) : Core::Elemen
 	SetProperty("overflow", "auto");
 
 	new_data_source = "";
+
+	// Our rows are loaded and refreshed from our update.
+	SetContinuousUpdate(true);
 }
 
 ElementDataGrid::~ElementDataGrid()
@@ -47,7 +47,7 @@ void ElementTextSelection::SetWidget(WidgetTextInput* _widget)
 }
 
 // Processes 'color' and 'background-color' property changes.
-void ElementTextSelection::OnPropertyChange(const Rocket::Core::PropertyNameList& changed_properties)
+void ElementTextSelection::OnPropertyChange(const Rocket::Core::PropertyIdSet& changed_properties)
 {
 	Element::OnPropertyChange(changed_properties);
 
@@ -55,8 +55,8 @@ void ElementTextSelection::OnPropertyChange(const Rocket::Core::PropertyNameList
 		return;
 
 	// Check for a colour change.
-	if (changed_properties.find("color") != changed_properties.end() ||
-		changed_properties.find("background-color") != changed_properties.end())
+	if (changed_properties.Contains(Core::PROPERTY_COLOR) ||
+		changed_properties.Contains(Core::PROPERTY_BACKGROUND_COLOR))
 	{
 		widget->UpdateSelectionColours();
 	}
@@ -68,7 +68,7 @@ bool InputType::OnAttributeChange(const Core::AttributeNameList& ROCKET_UNUSED(c
 }
 
 // Called when properties on the control are changed.
-void InputType::OnPropertyChange(const Core::PropertyNameList& ROCKET_UNUSED(changed_properties))
+void InputType::OnPropertyChange(const Core::PropertyIdSet& ROCKET_UNUSED(changed_properties))
 {
 }
 
@@ -88,10 +88,10 @@ bool InputTypeText::OnAttributeChange(const Core::AttributeNameList& changed_att
 }
 
 // Called when properties on the control are changed.
-void InputTypeText::OnPropertyChange(const Core::PropertyNameList& changed_properties)
+void InputTypeText::OnPropertyChange(const Core::PropertyIdSet& changed_properties)
 {
-	if (changed_properties.find("color") != changed_properties.end() ||
-		changed_properties.find("background-color") != changed_properties.end())
+	if (changed_properties.Contains(Core::PROPERTY_COLOR) ||
+		changed_properties.Contains(Core::PROPERTY_BACKGROUND_COLOR))
 		widget->UpdateSelectionColours();
 }
 
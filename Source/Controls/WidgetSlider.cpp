@@ -173,6 +173,11 @@ void WidgetSlider::Update()
 			}
 		}
 	}
+
+	// We're updated from our element's update; it has to be visited again while an arrow is held down.
+	if (arrow_timers[0] > 0 ||
+		arrow_timers[1] > 0)
+		parent->DirtyUpdate();
 }
 
 // Sets the position of the bar.
@@ -455,6 +460,11 @@ void WidgetSlider::ProcessEvent(Core::Event& event)
 			last_update_time = Core::GetSystemInterface()->GetElapsedTime();
 			SetBarPosition(OnLineIncrement());
 		}
+
+		// Our element has to update us until the arrow is released.
+		if (arrow_timers[0] > 0 ||
+			arrow_timers[1] > 0)
+			parent->DirtyUpdate();
 	}
 	else if (event == "mouseup" ||
 			 event == "mouseout")
@@ -104,6 +104,8 @@ WidgetTextInput::~WidgetTextInput()
 	parent->RemoveEventListener("mousedown", this, true);
 	parent->RemoveEventListener("drag", this, true);
 
+	parent->SetContinuousUpdate(false);
+
 	// Remove all the children added by the text widget.
 	parent->RemoveChild(text_element);
 	parent->RemoveChild(selected_text_element);
@@ -639,6 +641,9 @@ void WidgetTextInput::ShowCursor(bool show, bool move_to_cursor)
 		cursor_timer = CURSOR_BLINK_TIME;
 		last_update_time = Core::GetSystemInterface()->GetElapsedTime();
 
+		// Our element updates us every frame while the cursor is blinking.
+		parent->SetContinuousUpdate(true);
+
 		// Shift the cursor into view.
 		if (move_to_cursor)
 		{
@@ -663,6 +668,7 @@ void WidgetTextInput::ShowCursor(bool show, bool move_to_cursor)
 		cursor_visible = false;
 		cursor_timer = -1;
 		last_update_time = 0;
+		parent->SetContinuousUpdate(false);
 		if (keyboard_showed)
 		{
 			SetKeyboardActive(false);
@@ -0,0 +1,132 @@
+/*
+ * This source file is part of libRocket, the HTML/CSS Interface Middleware
+ *
+ * For the latest information, see http://www.librocket.com
+ *
+ * Copyright (c) 2008-2010 CodePoint Ltd, Shift Technology Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+#include "precompiled.h"
+#include "AncestorFilter.h"
+#include <string.h>
+
+namespace Rocket {
+namespace Core {
+
+// 32-bit FNV-1a parameters.
+static const unsigned int FNV_OFFSET_BASIS = 2166136261U;
+static const unsigned int FNV_PRIME = 16777619U;
+
+// Hashes a name, salted with the type of the name so tags, ids and classes of the same name don't collide.
+static unsigned int HashName(char type, const String& name)
+{
+	unsigned int hash = FNV_OFFSET_BASIS;
+	hash ^= (unsigned char) type;
+	hash *= FNV_PRIME;
+
+	const char* characters = name.CString();
+	for (size_t i = 0; i < name.Length(); ++i)
+	{
+		hash ^= (unsigned char) characters[i];
+		hash *= FNV_PRIME;
+	}
+
+	return hash;
+}
+
+AncestorFilter::AncestorFilter()
+{
+	memset(counters, 0, sizeof(counters));
+}
+
+// Adds an element's tag, id and classes into the filter.
+void AncestorFilter::Push(const String& tag, const String& id, const StringList& classes)
+{
+	Add(HashTag(tag));
+	if (!id.Empty())
+		Add(HashId(id));
+
+	for (size_t i = 0; i < classes.size(); ++i)
+		Add(HashClass(classes[i]));
+}
+
+// Removes an element's tag, id and classes from the filter.
+void AncestorFilter::Pop(const String& tag, const String& id, const StringList& classes)
+{
+	Remove(HashTag(tag));
+	if (!id.Empty())
+		Remove(HashId(id));
+
+	for (size_t i = 0; i < classes.size(); ++i)
+		Remove(HashClass(classes[i]));
+}
+
+// Checks if an element with a name may be in the filter.
+bool AncestorFilter::MayContain(unsigned int hash) const
+{
+	return counters[hash & KEY_MASK] != 0 &&
+		   counters[(hash >> 16) & KEY_MASK] != 0;
+}
+
+// Hashes an element tag for use with the filter.
+unsigned int AncestorFilter::HashTag(const String& tag)
+{
+	return HashName('t', tag);
+}
+
+// Hashes an element id for use with the filter.
+unsigned int AncestorFilter::HashId(const String& id)
+{
+	return HashName('#', id);
+}
+
+// Hashes an element class for use with the filter.
+unsigned int AncestorFilter::HashClass(const String& class_name)
+{
+	return HashName('.', class_name);
+}
+
+void AncestorFilter::Add(unsigned int hash)
+{
+	unsigned char& first = counters[hash & KEY_MASK];
+	if (first != MAX_COUNT)
+		first++;
+
+	unsigned char& second = counters[(hash >> 16) & KEY_MASK];
+	if (second != MAX_COUNT)
+		second++;
+}
+
+void AncestorFilter::Remove(unsigned int hash)
+{
+	unsigned char& first = counters[hash & KEY_MASK];
+	if (first != 0 && first != MAX_COUNT)
+		first--;
+
+	unsigned char& second = counters[(hash >> 16) & KEY_MASK];
+	if (second != 0 && second != MAX_COUNT)
+		second--;
+}
+
+}
+}
@@ -0,0 +1,91 @@
+/*
+ * This source file is part of libRocket, the HTML/CSS Interface Middleware
+ *
+ * For the latest information, see http://www.librocket.com
+ *
+ * Copyright (c) 2008-2010 CodePoint Ltd, Shift Technology Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+#ifndef ROCKETCOREANCESTORFILTER_H
+#define ROCKETCOREANCESTORFILTER_H
+
+#include <Rocket/Core/Types.h>
+
+namespace Rocket {
+namespace Core {
+
+/**
+	A counting Bloom filter of the tags, ids and classes of an element's ancestors, maintained as the element tree is
+	traversed while element definitions are updated. Style sheet nodes can use it to reject a rule in constant time
+	if an ancestor the rule requires can't exist.
+
+	The filter may report false positives, but never false negatives.
+ */
+
+class AncestorFilter
+{
+public:
+	AncestorFilter();
+
+	/// Adds an element's tag, id and classes into the filter.
+	/// @param[in] tag The element's tag.
+	/// @param[in] id The element's id.
+	/// @param[in] classes The element's classes.
+	void Push(const String& tag, const String& id, const StringList& classes);
+	/// Removes an element's tag, id and classes from the filter. These must be identical to those pushed.
+	/// @param[in] tag The element's tag.
+	/// @param[in] id The element's id.
+	/// @param[in] classes The element's classes.
+	void Pop(const String& tag, const String& id, const StringList& classes);
+
+	/// Checks if an element with a name may be in the filter.
+	/// @param[in] hash The hash of the name, as returned from one of the hashing functions.
+	/// @return False if the name is definitely not in the filter, true if it may be.
+	bool MayContain(unsigned int hash) const;
+
+	/// Hashes an element tag for use with the filter.
+	static unsigned int HashTag(const String& tag);
+	/// Hashes an element id for use with the filter.
+	static unsigned int HashId(const String& id);
+	/// Hashes an element class for use with the filter.
+	static unsigned int HashClass(const String& class_name);
+
+private:
+	// Adds or removes one name from the filter.
+	void Add(unsigned int hash);
+	void Remove(unsigned int hash);
+
+	static const int KEY_BITS = 10;
+	static const unsigned int KEY_MASK = (1 << KEY_BITS) - 1;
+	static const int NUM_COUNTERS = 1 << KEY_BITS;
+	static const unsigned char MAX_COUNT = 0xff;
+
+	// The filter's counters. Each name sets two counters, one from the low bits of its hash and one from the high
+	// bits. Counters that have saturated are never decremented.
+	unsigned char counters[NUM_COUNTERS];
+};
+
+}
+}
+
+#endif
@@ -0,0 +1,75 @@
+/*
+ * This source file is part of libRocket, the HTML/CSS Interface Middleware
+ *
+ * For the latest information, see http://www.librocket.com
+ *
+ * Copyright (c) 2008-2010 CodePoint Ltd, Shift Technology Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+#ifndef ROCKETCOREATOMICCOUNTER_H
+#define ROCKETCOREATOMICCOUNTER_H
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace Rocket {
+namespace Core {
+
+/**
+	Operations on counters that may be updated by several threads at once, such as the statistics gathered while
+	layout tasks run concurrently. Reading a counter while it is being updated gives either its old or new value.
+ */
+
+/// Adds a value onto a counter, returning the counter's previous value.
+inline unsigned int AtomicAdd(volatile unsigned int& counter, unsigned int value)
+{
+#if defined(_MSC_VER)
+	return (unsigned int) _InterlockedExchangeAdd((volatile long*) &counter, (long) value);
+#else
+	return __sync_fetch_and_add(&counter, value);
+#endif
+}
+
+/// Raises a counter to a value, if it is lower.
+inline void AtomicMax(volatile unsigned int& counter, unsigned int value)
+{
+	unsigned int current = counter;
+	while (current < value)
+	{
+#if defined(_MSC_VER)
+		unsigned int previous = (unsigned int) _InterlockedCompareExchange((volatile long*) &counter, (long) value, (long) current);
+#else
+		unsigned int previous = __sync_val_compare_and_swap(&counter, current, value);
+#endif
+		if (previous == current)
+			break;
+
+		current = previous;
+	}
+}
+
+}
+}
+
+#endif
@@ -29,6 +29,7 @@
 #include <Rocket/Core.h>
 #include "EventDispatcher.h"
 #include "EventIterators.h"
+#include "LayoutUpdateBatch.h"
 #include "PluginRegistry.h"
 #include "StreamFile.h"
 #include <Rocket/Core/StreamMemory.h>
@@ -67,6 +68,9 @@ Context::Context(const String& name) : name(name), mouse_position(0, 0), dimensi
 
 	show_cursor = true;
 
+	skip_hidden_elements = false;
+	concurrent_layout = false;
+
 	drag_started = false;
 	drag_verbose = false;
 	drag_clone = NULL;
@@ -137,6 +141,11 @@ bool Context::Update()
 {
 	root->Update();
 
+	// Documents don't format themselves during the update if they're to be formatted concurrently, so they're all
+	// formatted together now.
+	if (concurrent_layout)
+		UpdateLayouts();
+
 	// Release any documents that were unloaded during the update.
 	ReleaseUnloadedDocuments();
 
@@ -152,8 +161,7 @@ bool Context::Render()
 
 	// Update the layout for all documents in the root. This is done now as events during the
 	// update may have caused elements to require an update.
-	for (int i = 0; i < root->GetNumChildren(); ++i)
-		root->GetChild(i)->UpdateLayout();
+	UpdateLayouts();
 
 	render_interface->context = this;
 	ElementUtilities::ApplyActiveClipRegion(this, render_interface);
@@ -188,6 +196,30 @@ bool Context::Render()
 	return true;
 }
 
+// Sets whether hidden elements are skipped when the context is updated.
+void Context::SetSkipHiddenElements(bool skip)
+{
+	skip_hidden_elements = skip;
+}
+
+// Returns true if hidden elements are skipped when the context is updated.
+bool Context::GetSkipHiddenElements() const
+{
+	return skip_hidden_elements;
+}
+
+// Sets whether the context's documents are formatted concurrently when it is rendered.
+void Context::SetConcurrentLayout(bool concurrent)
+{
+	concurrent_layout = concurrent;
+}
+
+// Returns true if the context's documents are formatted concurrently.
+bool Context::GetConcurrentLayout() const
+{
+	return concurrent_layout;
+}
+
 // Creates a new, empty document and places it into this context.
 ElementDocument* Context::CreateDocument(const String& tag)
 {
@@ -629,10 +661,10 @@ void Context::ProcessMouseMove(int x, int y, int key_modifier_state)
 static Element* FindFocusElement(Element* element)
 {
 	ElementDocument* owner_document = element->GetOwnerDocument();
-	if (!owner_document || owner_document->GetProperty< int >(FOCUS) == FOCUS_NONE)
+	if (!owner_document || owner_document->GetProperty< int >(PROPERTY_FOCUS) == FOCUS_NONE)
 		return NULL;
 	
-	while (element && element->GetProperty< int >(FOCUS) == FOCUS_NONE)
+	while (element && element->GetProperty< int >(PROPERTY_FOCUS) == FOCUS_NONE)
 	{
 		element = element->GetParentNode();
 	}
@@ -703,7 +735,7 @@ void Context::ProcessMouseButtonDown(int button_index, int key_modifier_state)
 			drag = hover;
 			while (drag)
 			{
-				int drag_style = drag->GetProperty(DRAG)->value.Get< int >();
+				int drag_style = drag->GetProperty(PROPERTY_DRAG)->value.Get< int >();
 				switch (drag_style)
 				{
 					case DRAG_NONE:		drag = drag->GetParentNode(); continue;
@@ -913,7 +945,7 @@ bool Context::OnFocusChange(Element* new_focus)
 	ElementDocument* document = focus->GetOwnerDocument();
 	if (document != NULL)
 	{
-		const Property* z_index_property = document->GetProperty(Z_INDEX);
+		const Property* z_index_property = document->GetProperty(PROPERTY_Z_INDEX);
 		if (z_index_property->unit == Property::KEYWORD &&
 			z_index_property->value.Get< int >() == Z_INDEX_AUTO)
 			document->PullToFront();
@@ -961,7 +993,7 @@ void Context::UpdateHoverChain(const Dictionary& parameters, const Dictionary& d
 				drag->DispatchEvent(DRAGSTART, drag_start_parameters);
 				drag_started = true;
 
-				if (drag->GetProperty< int >(DRAG) == DRAG_CLONE)
+				if (drag->GetProperty< int >(PROPERTY_DRAG) == DRAG_CLONE)
 				{
 					// Clone the element and attach it to the mouse cursor.
 					CreateDragClone(*drag);
@@ -975,10 +1007,10 @@ void Context::UpdateHoverChain(const Dictionary& parameters, const Dictionary& d
 	hover = GetElementAtPoint(position);
 
 	if (!hover ||
-		hover->GetProperty(CURSOR)->unit == Property::KEYWORD)
+		hover->GetProperty(PROPERTY_CURSOR)->unit == Property::KEYWORD)
 		active_cursor = default_cursor;
 	else
-		SetMouseCursor(hover->GetProperty< String >(CURSOR));
+		SetMouseCursor(hover->GetProperty< String >(PROPERTY_CURSOR));
 
 	// Build the new hover chain.
 	ElementSet new_hover_chain;
@@ -1011,7 +1043,7 @@ void Context::UpdateHoverChain(const Dictionary& parameters, const Dictionary& d
 			drag->DispatchEvent(DRAGSTART, drag_parameters);
 			drag_started = true;
 
-			if (drag->GetProperty< int >(DRAG) == DRAG_CLONE)
+			if (drag->GetProperty< int >(PROPERTY_DRAG) == DRAG_CLONE)
 			{
 				// Clone the element and attach it to the mouse cursor.
 				CreateDragClone(*drag);
@@ -1208,6 +1240,41 @@ void Context::ReleaseUnloadedDocuments()
 	}
 }
 
+// Formats the documents whose layouts are dirty.
+void Context::UpdateLayouts()
+{
+	// Hidden documents are left until they're shown if we skip hidden elements, as their definitions may not be up to
+	// date.
+	int max_concurrent_tasks = concurrent_layout ? GetSystemInterface()->GetMaxConcurrentTasks() : 1;
+	if (max_concurrent_tasks > 1)
+	{
+		LayoutUpdateBatch batch;
+		for (int i = 0; i < root->GetNumChildren(); ++i)
+		{
+			Element* document = root->GetChild(i);
+			if (skip_hidden_elements &&
+				!document->IsVisible())
+				continue;
+
+			batch.AddDocument(document->GetOwnerDocument());
+		}
+
+		batch.Format(max_concurrent_tasks);
+	}
+	else
+	{
+		for (int i = 0; i < root->GetNumChildren(); ++i)
+		{
+			Element* document = root->GetChild(i);
+			if (skip_hidden_elements &&
+				!document->IsVisible())
+				continue;
+
+			document->UpdateLayout();
+		}
+	}
+}
+
 // Sends the specified event to all elements in new_items that don't appear in old_items.
 void Context::SendEvents(const ElementSet& old_items, const ElementSet& new_items, const String& event, const Dictionary& parameters, bool interruptible)
 {
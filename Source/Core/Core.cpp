@@ -31,6 +31,8 @@
 #include "FileInterfaceDefault.h"
 #include "GeometryDatabase.h"
 #include "PluginRegistry.h"
+#include "PropertySourceTable.h"
+#include "PseudoClassRegistry.h"
 #include "StyleSheetFactory.h"
 #include "TemplateCache.h"
 #include "TextureDatabase.h"
@@ -129,6 +131,8 @@ void Shutdown()
 	TemplateCache::Shutdown();
 	StyleSheetFactory::Shutdown();
 	StyleSheetSpecification::Shutdown();
+	PropertySourceTable::Shutdown();
+	PseudoClassRegistry::Shutdown();
 	FontDatabase::Shutdown();
 	TextureDatabase::Shutdown();
 	Factory::Shutdown();
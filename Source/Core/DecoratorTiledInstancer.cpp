@@ -71,7 +71,7 @@ void DecoratorTiledInstancer::GetTileProperties(DecoratorTiled::Tile& tile, Stri
 
 	const Property* texture_property = properties.GetProperty(String(32, "%s-src", name.CString()));
 	texture_name = texture_property->Get< String >();
-	rcss_path = texture_property->source;
+	rcss_path = texture_property->GetSource();
 }
 
 // Loads a single texture coordinate value from the properties.
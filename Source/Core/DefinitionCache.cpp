@@ -0,0 +1,202 @@
+/*
+ * This source file is part of libRocket, the HTML/CSS Interface Middleware
+ *
+ * For the latest information, see http://www.librocket.com
+ *
+ * Copyright (c) 2008-2010 CodePoint Ltd, Shift Technology Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+#include "precompiled.h"
+#include "DefinitionCache.h"
+#include "ElementDefinition.h"
+
+namespace Rocket {
+namespace Core {
+
+// 64-bit FNV-1a parameters.
+static const uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
+static const uint64_t FNV_PRIME = 1099511628211ULL;
+
+// The table is grown once it is more than half full, and never shrinks below this size.
+static const size_t MINIMUM_TABLE_SIZE = 16;
+
+// Mixes a 64-bit value into a running FNV-1a hash, one byte at a time.
+static uint64_t HashValue(uint64_t hash, uint64_t value)
+{
+	for (int i = 0; i < 8; ++i)
+	{
+		hash ^= (value >> (i * 8)) & 0xff;
+		hash *= FNV_PRIME;
+	}
+
+	return hash;
+}
+
+DefinitionCacheKey::DefinitionCacheKey()
+{
+	volatile_pseudo_classes = 0;
+	hash = 0;
+}
+
+// Empties the key, keeping its storage for reuse.
+void DefinitionCacheKey::Clear()
+{
+	nodes.clear();
+	volatile_pseudo_classes = 0;
+	hash = 0;
+}
+
+// Returns the key's list of applicable nodes.
+DefinitionCacheKey::NodeList& DefinitionCacheKey::GetNodes()
+{
+	return nodes;
+}
+
+// Returns the key's list of applicable nodes.
+const DefinitionCacheKey::NodeList& DefinitionCacheKey::GetNodes() const
+{
+	return nodes;
+}
+
+// Sets the key's volatile pseudo-classes and computes its hash.
+void DefinitionCacheKey::Finalise(PseudoClassMask _volatile_pseudo_classes)
+{
+	volatile_pseudo_classes = _volatile_pseudo_classes;
+
+	hash = FNV_OFFSET_BASIS;
+	for (size_t i = 0; i < nodes.size(); ++i)
+		hash = HashValue(hash, (uint64_t) (uintptr_t) nodes[i]);
+	hash = HashValue(hash, volatile_pseudo_classes);
+}
+
+// Returns the key's hash.
+uint64_t DefinitionCacheKey::GetHash() const
+{
+	return hash;
+}
+
+bool DefinitionCacheKey::operator==(const DefinitionCacheKey& rhs) const
+{
+	return hash == rhs.hash &&
+		   volatile_pseudo_classes == rhs.volatile_pseudo_classes &&
+		   nodes == rhs.nodes;
+}
+
+DefinitionMatch::DefinitionMatch()
+{
+	volatile_pseudo_classes = 0;
+	volatile_pseudo_classes_complete = true;
+	structurally_volatile = false;
+}
+
+DefinitionCache::DefinitionCache()
+{
+	num_definitions = 0;
+}
+
+DefinitionCache::~DefinitionCache()
+{
+	Clear();
+}
+
+// Looks up a definition.
+ElementDefinition* DefinitionCache::Find(const DefinitionCacheKey& key) const
+{
+	if (slots.empty())
+		return NULL;
+
+	return slots[FindSlot(slots, key)].definition;
+}
+
+// Adds a definition to the cache.
+void DefinitionCache::Insert(const DefinitionCacheKey& key, ElementDefinition* definition)
+{
+	// Keep the load factor at a half or less, so probe sequences stay short.
+	if ((size_t) (num_definitions + 1) * 2 > slots.size())
+		Rehash(Math::Max(MINIMUM_TABLE_SIZE, slots.size() * 2));
+
+	Slot& slot = slots[FindSlot(slots, key)];
+	ROCKET_ASSERT(slot.definition == NULL);
+
+	slot.key = key;
+	slot.definition = definition;
+	definition->AddReference();
+
+	num_definitions++;
+}
+
+// Releases all cached definitions.
+void DefinitionCache::Clear()
+{
+	for (size_t i = 0; i < slots.size(); ++i)
+	{
+		if (slots[i].definition != NULL)
+			slots[i].definition->RemoveReference();
+	}
+
+	slots.clear();
+	num_definitions = 0;
+}
+
+// Returns the number of cached definitions.
+int DefinitionCache::GetNumDefinitions() const
+{
+	return num_definitions;
+}
+
+// Returns the index of the slot holding the key, or the empty slot where it would be inserted.
+size_t DefinitionCache::FindSlot(const SlotList& table, const DefinitionCacheKey& key) const
+{
+	size_t mask = table.size() - 1;
+	size_t index = (size_t) key.GetHash() & mask;
+
+	// Linear probing; the table is never full, so this will always terminate.
+	while (table[index].definition != NULL &&
+		   !(table[index].key == key))
+		index = (index + 1) & mask;
+
+	return index;
+}
+
+// Resizes the table, re-inserting all existing definitions.
+void DefinitionCache::Rehash(size_t new_size)
+{
+	SlotList new_slots(new_size);
+	for (size_t i = 0; i < new_slots.size(); ++i)
+		new_slots[i].definition = NULL;
+
+	for (size_t i = 0; i < slots.size(); ++i)
+	{
+		if (slots[i].definition == NULL)
+			continue;
+
+		Slot& new_slot = new_slots[FindSlot(new_slots, slots[i].key)];
+		new_slot.key = slots[i].key;
+		new_slot.definition = slots[i].definition;
+	}
+
+	slots.swap(new_slots);
+}
+
+}
+}
@@ -0,0 +1,136 @@
+/*
+ * This source file is part of libRocket, the HTML/CSS Interface Middleware
+ *
+ * For the latest information, see http://www.librocket.com
+ *
+ * Copyright (c) 2008-2010 CodePoint Ltd, Shift Technology Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+#ifndef ROCKETCOREDEFINITIONCACHE_H
+#define ROCKETCOREDEFINITIONCACHE_H
+
+#include "PseudoClassRegistry.h"
+
+namespace Rocket {
+namespace Core {
+
+class ElementDefinition;
+class StyleSheetNode;
+
+/**
+	The key of an element definition in a style sheet's definition cache: the sorted list of style sheet nodes that
+	apply to an element, and the set of volatile pseudo-classes. The key's hash is computed when it is finalised.
+ */
+
+class DefinitionCacheKey
+{
+public:
+	typedef std::vector< const StyleSheetNode* > NodeList;
+
+	DefinitionCacheKey();
+
+	/// Empties the key, keeping its storage for reuse.
+	void Clear();
+	/// Returns the key's list of applicable nodes, to be filled in by the caller before the key is finalised.
+	NodeList& GetNodes();
+	/// Returns the key's list of applicable nodes.
+	const NodeList& GetNodes() const;
+	/// Sets the key's volatile pseudo-classes and computes its hash.
+	void Finalise(PseudoClassMask volatile_pseudo_classes);
+
+	/// Returns the key's hash. This is only valid once the key has been finalised.
+	uint64_t GetHash() const;
+
+	bool operator==(const DefinitionCacheKey& rhs) const;
+
+private:
+	NodeList nodes;
+	PseudoClassMask volatile_pseudo_classes;
+	uint64_t hash;
+};
+
+/**
+	The result of matching an element against a style sheet: the key of the element's definition in the style sheet's
+	definition cache, and the volatility information needed to build the definition if it isn't already cached.
+ */
+
+struct DefinitionMatch
+{
+	DefinitionMatch();
+
+	DefinitionCacheKey key;
+	PseudoClassMask volatile_pseudo_classes;
+	// False if some of the volatile pseudo-classes couldn't be interned into the mask, in which case the key is
+	// ambiguous and the definition can't be cached.
+	bool volatile_pseudo_classes_complete;
+	bool structurally_volatile;
+};
+
+/**
+	An open-addressing hash table mapping definition keys to element definitions. The cache holds a reference on
+	each of its definitions, released when the cache is cleared or destroyed.
+ */
+
+class DefinitionCache
+{
+public:
+	DefinitionCache();
+	~DefinitionCache();
+
+	/// Looks up a definition. This does not allocate.
+	/// @param[in] key The finalised key to look up.
+	/// @return The cached definition, or NULL if the key isn't in the cache. No reference is added.
+	ElementDefinition* Find(const DefinitionCacheKey& key) const;
+	/// Adds a definition to the cache. A reference will be added to the definition.
+	/// @param[in] key The finalised key of the definition. This must not already be in the cache.
+	/// @param[in] definition The definition to cache.
+	void Insert(const DefinitionCacheKey& key, ElementDefinition* definition);
+	/// Releases all cached definitions.
+	void Clear();
+
+	/// Returns the number of cached definitions.
+	int GetNumDefinitions() const;
+
+private:
+	struct Slot
+	{
+		DefinitionCacheKey key;
+		ElementDefinition* definition;
+	};
+
+	typedef std::vector< Slot > SlotList;
+
+	// Returns the index of the slot holding the key, or the empty slot where it would be inserted.
+	size_t FindSlot(const SlotList& table, const DefinitionCacheKey& key) const;
+	// Resizes the table, re-inserting all existing definitions.
+	void Rehash(size_t new_size);
+
+	// The slots of the table; the size is always a power of two. Empty slots have a NULL definition.
+	SlotList slots;
+	int num_definitions;
+};
+
+}
+}
+
+#endif
@@ -0,0 +1,157 @@
+/*
+ * This source file is part of libRocket, the HTML/CSS Interface Middleware
+ *
+ * For the latest information, see http://www.librocket.com
+ *
+ * Copyright (c) 2008-2010 CodePoint Ltd, Shift Technology Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+#include "precompiled.h"
+#include "DefinitionUpdateBatch.h"
+#include <algorithm>
+#include <Rocket/Core/Element.h>
+#include <Rocket/Core/StyleSheet.h>
+#include <Rocket/Core/SystemInterface.h>
+#include "AncestorFilter.h"
+
+namespace Rocket {
+namespace Core {
+
+// The number of tasks created for each task the system interface can run concurrently. Creating more tasks than can be
+// run at once lets the scheduler balance subtrees that are slower to match than others.
+static const int TASKS_PER_CONCURRENT_TASK = 4;
+// The minimum number of elements matched by a single task.
+static const int MIN_MATCHES_PER_TASK = 32;
+
+DefinitionUpdateBatch::DefinitionUpdateBatch()
+{
+	num_tasks = 0;
+}
+
+// Adds an element into the batch.
+void DefinitionUpdateBatch::AddElement(Element* element, const StyleSheet* style_sheet, int depth)
+{
+	Entry entry;
+	entry.element = element;
+	entry.style_sheet = style_sheet;
+	entry.depth = depth;
+	entry.match_index = -1;
+
+	if (style_sheet != NULL)
+	{
+		entry.match_index = (int) match_indices.size();
+		match_indices.push_back(MatchIndex(element, entry.match_index));
+		match_entries.push_back((int) entries.size());
+	}
+
+	entries.push_back(entry);
+}
+
+// Returns the number of elements in the batch that will be matched.
+int DefinitionUpdateBatch::GetNumMatches() const
+{
+	return (int) match_indices.size();
+}
+
+// Matches the batch's elements concurrently.
+void DefinitionUpdateBatch::Match(int max_concurrent_tasks)
+{
+	matches.resize(match_indices.size());
+
+	num_tasks = Math::Min(max_concurrent_tasks * TASKS_PER_CONCURRENT_TASK, GetNumMatches() / MIN_MATCHES_PER_TASK);
+	num_tasks = Math::Max(num_tasks, 1);
+
+	GetSystemInterface()->RunTasks(MatchTask, this, num_tasks);
+
+	std::sort(match_indices.begin(), match_indices.end());
+}
+
+// Returns the result of matching an element.
+const DefinitionMatch* DefinitionUpdateBatch::GetMatch(const Element* element, const StyleSheet* style_sheet) const
+{
+	MatchIndexList::const_iterator iterator = std::lower_bound(match_indices.begin(), match_indices.end(), MatchIndex(element, -1));
+	if (iterator == match_indices.end() ||
+		(*iterator).first != element)
+		return NULL;
+
+	// Only hand out the match if the element is still being matched against the same style sheet.
+	int match_index = (*iterator).second;
+	if (match_index >= (int) matches.size() ||
+		entries[match_entries[match_index]].style_sheet != style_sheet)
+		return NULL;
+
+	return &matches[match_index];
+}
+
+// Matches a range of the batch's elements.
+void DefinitionUpdateBatch::MatchTask(void* data, int task_index)
+{
+	DefinitionUpdateBatch* batch = (DefinitionUpdateBatch*) data;
+
+	int num_entries = (int) batch->entries.size();
+	batch->MatchRange((int) (((long long) num_entries * task_index) / batch->num_tasks), (int) (((long long) num_entries * (task_index + 1)) / batch->num_tasks));
+}
+
+void DefinitionUpdateBatch::MatchRange(int begin, int end)
+{
+	if (begin >= end)
+		return;
+
+	// Fill our filter with the ancestors of the first element in our range. From then on, as the elements are in
+	// document order, each element's ancestors are at the bottom of our ancestor stack.
+	AncestorFilter ancestor_filter;
+	std::vector< Element* > ancestors;
+
+	for (Element* ancestor = entries[begin].element->GetParentNode(); ancestor != NULL; ancestor = ancestor->GetParentNode())
+		ancestors.push_back(ancestor);
+	std::reverse(ancestors.begin(), ancestors.end());
+
+	for (size_t i = 0; i < ancestors.size(); ++i)
+		ancestor_filter.Push(ancestors[i]->GetTagName(), ancestors[i]->GetId(), ancestors[i]->GetClassNameList());
+
+	for (int i = begin; i < end; ++i)
+	{
+		const Entry& entry = entries[i];
+
+		while ((int) ancestors.size() > entry.depth)
+		{
+			Element* ancestor = ancestors.back();
+			ancestor_filter.Pop(ancestor->GetTagName(), ancestor->GetId(), ancestor->GetClassNameList());
+			ancestors.pop_back();
+		}
+
+		if (entry.match_index >= 0)
+			entry.style_sheet->MatchElement(matches[entry.match_index], entry.element, &ancestor_filter);
+
+		// If the next element is our child, we become one of its ancestors.
+		if (i + 1 < end &&
+			entries[i + 1].depth > entry.depth)
+		{
+			ancestor_filter.Push(entry.element->GetTagName(), entry.element->GetId(), entry.element->GetClassNameList());
+			ancestors.push_back(entry.element);
+		}
+	}
+}
+
+}
+}
@@ -0,0 +1,103 @@
+/*
+ * This source file is part of libRocket, the HTML/CSS Interface Middleware
+ *
+ * For the latest information, see http://www.librocket.com
+ *
+ * Copyright (c) 2008-2010 CodePoint Ltd, Shift Technology Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+#ifndef ROCKETCOREDEFINITIONUPDATEBATCH_H
+#define ROCKETCOREDEFINITIONUPDATEBATCH_H
+
+#include "DefinitionCache.h"
+
+namespace Rocket {
+namespace Core {
+
+class Element;
+class StyleSheet;
+
+/**
+	A batch of elements whose definitions are being updated together. The elements are matched against their style
+	sheets concurrently, through the system interface's tasks, before their definitions are resolved and applied one
+	at a time.
+
+	Elements are added in document order along with their depth, so each task can maintain its own ancestor filter
+	as it walks its range of the batch.
+ */
+
+class DefinitionUpdateBatch
+{
+public:
+	DefinitionUpdateBatch();
+
+	/// Adds an element into the batch. Elements must be added in document order, and every ancestor of an element
+	/// must either be added before it or be an ancestor of the first element.
+	/// @param[in] element The element.
+	/// @param[in] style_sheet The style sheet to match the element against, or NULL if it isn't to be matched.
+	/// @param[in] depth The number of ancestors the element has.
+	void AddElement(Element* element, const StyleSheet* style_sheet, int depth);
+	/// Returns the number of elements in the batch that will be matched.
+	int GetNumMatches() const;
+
+	/// Matches the batch's elements concurrently. The element hierarchy must not be modified until this returns.
+	/// @param[in] max_concurrent_tasks The number of tasks the system interface can run concurrently.
+	void Match(int max_concurrent_tasks);
+	/// Returns the result of matching an element.
+	/// @param[in] element The element.
+	/// @param[in] style_sheet The style sheet the element is now being matched against.
+	/// @return The element's match, or NULL if it wasn't matched against the style sheet.
+	const DefinitionMatch* GetMatch(const Element* element, const StyleSheet* style_sheet) const;
+
+private:
+	// Matches a range of the batch's elements; this is run as a task.
+	static void MatchTask(void* data, int task_index);
+	void MatchRange(int begin, int end);
+
+	struct Entry
+	{
+		Element* element;
+		const StyleSheet* style_sheet;
+		int depth;
+		// The index of the element's match, or -1 if it isn't being matched.
+		int match_index;
+	};
+
+	typedef std::vector< Entry > EntryList;
+	typedef std::pair< const Element*, int > MatchIndex;
+	typedef std::vector< MatchIndex > MatchIndexList;
+
+	EntryList entries;
+	std::vector< DefinitionMatch > matches;
+	// The indices of the matches, sorted by element.
+	MatchIndexList match_indices;
+	// The index of each match's entry.
+	std::vector< int > match_entries;
+
+	int num_tasks;
+};
+
+}
+}
+
+#endif
@@ -89,6 +89,16 @@ Element::Element(const String& _tag) : absolute_offset(0, 0), relative_offset_ba
 
 	num_non_dom_children = 0;
 
+	update_dirty = true;
+	child_update_dirty = false;
+	continuous_update = false;
+
+	layout_root = false;
+	layout_root_dirty = false;
+	child_layout_root_dirty = false;
+	subtree_layout_dirty = true;
+	deferred_layout = 0;
+
 	visible = true;
 
 	z_index = 0;
@@ -151,16 +161,52 @@ Element::~Element()
 
 void Element::Update()
 {
+	// Nothing in this branch of the tree has changed since the last update.
+	if (!update_dirty &&
+		!child_update_dirty)
+		return;
+
 	ReleaseElements(deleted_children);
-	active_children = children;
-	for (size_t i = 0; i < active_children.size(); i++)
-		active_children[i]->Update();
 
-	// Force a definition reload, if necessary.
-	style->GetDefinition();
+	// If hidden elements are skipped, our definition has to be brought up to date before anything else so we know
+	// if we're hidden. If we are, we and our descendants are left as they are until we're shown again; we stay
+	// marked so we're checked again on the next update.
+	Context* context = GetContext();
+	if (context != NULL &&
+		context->GetSkipHiddenElements())
+	{
+		style->GetDefinition();
+		if (IsUpdateSkipped())
+		{
+			DirtyUpdate();
+			return;
+		}
+	}
+
+	// The flags are cleared before the updates are made, so any element marked during the update is visited again on
+	// the next loop.
+	if (child_update_dirty)
+	{
+		child_update_dirty = false;
+
+		active_children = children;
+		for (size_t i = 0; i < active_children.size(); i++)
+			active_children[i]->Update();
+	}
+
+	if (update_dirty)
+	{
+		update_dirty = false;
 
-	scroll->Update();
-	OnUpdate();
+		// Force a definition reload, if necessary.
+		style->GetDefinition();
+
+		scroll->Update();
+		OnUpdate();
+
+		if (continuous_update)
+			DirtyUpdate();
+	}
 }
 
 void Element::Render()
@@ -189,6 +235,116 @@ void Element::Render()
 		stacking_context[i]->Render();
 }
 
+// Returns the nearest of our ancestors within our document that is a layout root.
+Element* Element::GetParentLayoutRoot()
+{
+	ElementDocument* document = GetOwnerDocument();
+	for (Element* ancestor = parent; ancestor != NULL && ancestor != document; ancestor = ancestor->parent)
+	{
+		if (ancestor->layout_root)
+			return ancestor;
+	}
+
+	return NULL;
+}
+
+// Returns true if the element is hidden and its context skips hidden elements.
+bool Element::IsUpdateSkipped()
+{
+	Context* context = GetContext();
+	if (context == NULL ||
+		!context->GetSkipHiddenElements())
+		return false;
+
+	if (GetComputedStyle().display == DISPLAY_NONE)
+		return true;
+
+	// A hidden document's contents are hidden with it.
+	return GetOwnerDocument() == this && !IsVisible();
+}
+
+// Prepares this element and its descendants to be formatted concurrently with other elements.
+void Element::PrepareConcurrentLayout()
+{
+	// Definitions are resolved through the style sheet's shared caches, and our owner document is cached on us and
+	// our ancestors when first looked up.
+	style->GetDefinition();
+	GetOwnerDocument();
+	if (GetComputedStyle().display == DISPLAY_NONE)
+		return;
+
+	// Replaced elements load their content when first asked for their dimensions.
+	Vector2f dimensions;
+	GetIntrinsicDimensions(dimensions);
+
+	// Scrollbars are instanced through the factory, so any that may be enabled during layout are created now.
+	scroll->CreateScrollbars();
+
+	for (int i = 0; i < GetNumChildren(true); ++i)
+		GetChild(i)->PrepareConcurrentLayout();
+}
+
+// Returns true if our document is being formatted concurrently.
+bool Element::IsLayoutDeferred()
+{
+	ElementDocument* document = GetOwnerDocument();
+	return document != NULL && document->concurrent_layout;
+}
+
+// Regenerates our decoration for our new box, and sends the resize event.
+void Element::OnBoxChange()
+{
+	decoration->ReloadDecorators();
+	DispatchEvent(RESIZE, Dictionary());
+}
+
+// Shows or hides our scrollbars after they've been enabled or disabled.
+void Element::UpdateScrollbarVisibility()
+{
+	if (IsLayoutDeferred())
+		deferred_layout |= DEFERRED_SCROLLBAR_VISIBILITY;
+	else
+		scroll->UpdateScrollbarVisibility();
+}
+
+// Formats our scrollbars after we've been sized.
+void Element::FormatScrollbars()
+{
+	if (IsLayoutDeferred())
+		deferred_layout |= DEFERRED_SCROLLBARS;
+	else
+		scroll->FormatScrollbars();
+}
+
+// Notifies us that we've been formatted.
+void Element::OnLayoutComplete()
+{
+	if (IsLayoutDeferred())
+		deferred_layout |= DEFERRED_LAYOUT_COMPLETE;
+	else
+		OnLayout();
+}
+
+// Runs anything deferred on us and our descendants while our document was formatted concurrently.
+void Element::ProcessDeferredLayout()
+{
+	for (int i = 0; i < GetNumChildren(true); ++i)
+		GetChild(i)->ProcessDeferredLayout();
+
+	// Our descendants are notified before us, as they would have been had we been formatted normally.
+	int deferred = deferred_layout;
+	deferred_layout = 0;
+
+	if (deferred & DEFERRED_BOX_CHANGE)
+		OnBoxChange();
+	if (deferred & DEFERRED_SCROLLBAR_VISIBILITY)
+		scroll->UpdateScrollbarVisibility();
+	if (deferred & DEFERRED_SCROLLBARS)
+		scroll->FormatScrollbars();
+	if (deferred & DEFERRED_LAYOUT_COMPLETE)
+		OnLayout();
+}
+
 // Clones this element, returning a new, unparented element.
 Element* Element::Clone() const
 {
@@ -238,6 +394,12 @@ String Element::GetClassNames() const
 	return style->GetClassNames();
 }
 
+// Returns the active class list.
+const StringList& Element::GetClassNameList() const
+{
+	return style->GetClassNameList();
+}
+
 // Returns the active style sheet for this element. This may be NULL.
 StyleSheet* Element::GetStyleSheet() const
 {
@@ -403,9 +565,11 @@ void Element::SetBox(const Box& box)
 
 		background->DirtyBackground();
 		border->DirtyBorder();
-		decoration->ReloadDecorators();
 
-		DispatchEvent(RESIZE, Dictionary());
+		if (IsLayoutDeferred())
+			deferred_layout |= DEFERRED_BOX_CHANGE;
+		else
+			OnBoxChange();
 	}
 }
 
@@ -413,11 +577,14 @@ void Element::SetBox(const Box& box)
 void Element::AddBox(const Box& box)
 {
 	boxes.push_back(box);
-	DispatchEvent(RESIZE, Dictionary());
 
 	background->DirtyBackground();
 	border->DirtyBorder();
-	decoration->ReloadDecorators();
+
+	if (IsLayoutDeferred())
+		deferred_layout |= DEFERRED_BOX_CHANGE;
+	else
+		OnBoxChange();
 }
 
 // Returns one of the boxes describing the size of the element.
@@ -499,12 +666,30 @@ bool Element::SetProperty(const String& name, const String& value)
 	return style->SetProperty(name, value);
 }
 
+// Sets a number of local property overrides on the element to pre-parsed values.
+bool Element::SetProperties(const PropertyDictionary& properties)
+{
+	return style->SetProperties(properties);
+}
+
 // Removes a local property override on the element.
 void Element::RemoveProperty(const String& name)
 {
 	style->RemoveProperty(name);
 }
 
+// Begins a batch of style changes on the element.
+void Element::BeginStyleUpdate()
+{
+	style->BeginUpdate();
+}
+
+// Ends a batch of style changes on the element.
+void Element::EndStyleUpdate()
+{
+	style->EndUpdate();
+}
+
 // Sets a local property override on the element to a pre-parsed value.
 bool Element::SetProperty(const String& name, const Property& property)
 {
@@ -517,18 +702,36 @@ const Property* Element::GetProperty(const String& name)
 	return style->GetProperty(name);	
 }
 
+// Returns one of this element's registered properties.
+const Property* Element::GetProperty(PropertyId id)
+{
+	return style->GetProperty(id);
+}
+
 // Returns one of this element's properties.
 const Property* Element::GetLocalProperty(const String& name)
 {
 	return style->GetLocalProperty(name);
 }
 
+// Returns one of this element's registered properties.
+const Property* Element::GetLocalProperty(PropertyId id)
+{
+	return style->GetLocalProperty(id);
+}
+
 // Resolves one of this element's style.
 float Element::ResolveProperty(const String& name, float base_value)
 {
 	return style->ResolveProperty(name, base_value);
 }
 
+// Resolves one of this element's style.
+float Element::ResolveProperty(PropertyId id, float base_value)
+{
+	return style->ResolveProperty(id, base_value);
+}
+
 // Resolves one of this element's style.
 float Element::ResolveProperty(const Property *property, float base_value)
 {
@@ -605,6 +808,12 @@ const Property *Element::GetVerticalAlignProperty()
 	return style->GetVerticalAlignProperty();
 }
 
+// Returns the element's computed style.
+const ComputedStyle& Element::GetComputedStyle()
+{
+	return style->GetComputedStyle();
+}
+
 // Iterates over the properties defined on this element.
 bool Element::IterateProperties(int& index, PseudoClassList& pseudo_classes, String& name, const Property*& property) const
 {
@@ -977,7 +1186,7 @@ void Element::SetInnerRML(const String& rml)
 bool Element::Focus()
 {
 	// Are we allowed focus?
-	int focus_property = GetProperty< int >(FOCUS);
+	int focus_property = GetProperty< int >(PROPERTY_FOCUS);
 	if (focus_property == FOCUS_NONE)
 		return false;
 
@@ -1065,8 +1274,8 @@ void Element::ScrollIntoView(bool align_with_top)
 	Element* scroll_parent = parent;
 	while (scroll_parent != NULL)
 	{
-		int overflow_x_property = scroll_parent->GetProperty< int >(OVERFLOW_X);
-		int overflow_y_property = scroll_parent->GetProperty< int >(OVERFLOW_Y);
+		int overflow_x_property = scroll_parent->GetProperty< int >(PROPERTY_OVERFLOW_X);
+		int overflow_y_property = scroll_parent->GetProperty< int >(PROPERTY_OVERFLOW_Y);
 
 		if ((overflow_x_property != OVERFLOW_VISIBLE &&
 			 scroll_parent->GetScrollWidth() > scroll_parent->GetClientWidth()) ||
@@ -1113,6 +1322,7 @@ void Element::AppendChild(Element* child, bool dom_element)
 	child->OnChildAdd(child);
 	DirtyStackingContext();
 	DirtyStructure();
+	DirtyUpdate();
 
 	if (dom_element)
 		DirtyLayout();
@@ -1161,6 +1371,7 @@ void Element::InsertBefore(Element* child, Element* adjacent_element)
 		child->OnChildAdd(child);
 		DirtyStackingContext();
 		DirtyStructure();
+		DirtyUpdate();
 
 		LockLayout(false);
 	}
@@ -1227,6 +1438,9 @@ bool Element::RemoveChild(Element* child)
 			deleted_children.push_back(child);
 			children.erase(itr);
 
+			// We'll release the child on our next update.
+			DirtyUpdate();
+
 			// Remove the child element as the focussed child of this element.
 			if (child == focus)
 			{
@@ -1346,12 +1560,12 @@ bool Element::IsClippingEnabled()
 	if (clipping_state_dirty)
 	{
 		// Is clipping enabled for this element, yes unless both overlow properties are set to visible
-		clipping_enabled = style->GetProperty(OVERFLOW_X)->Get< int >() != OVERFLOW_VISIBLE 
-							|| style->GetProperty(OVERFLOW_Y)->Get< int >() != OVERFLOW_VISIBLE;
+		clipping_enabled = style->GetProperty(PROPERTY_OVERFLOW_X)->Get< int >() != OVERFLOW_VISIBLE 
+							|| style->GetProperty(PROPERTY_OVERFLOW_Y)->Get< int >() != OVERFLOW_VISIBLE;
 		
 		// Get the clipping ignore depth from the clip property
 		clipping_ignore_depth = 0;
-		const Property* clip_property = GetProperty(CLIP);
+		const Property* clip_property = GetProperty(PROPERTY_CLIP);
 		if (clip_property->unit == Property::NUMBER)
 			clipping_ignore_depth = clip_property->Get< int >();
 		else if (clip_property->Get< int >() == CLIP_NONE)
@@ -1413,8 +1627,12 @@ void Element::OnAttributeChange(const AttributeNameList& changed_attributes)
 {
 	if (changed_attributes.find("id") != changed_attributes.end())
 	{
+		String old_id = id;
 		id = GetAttribute< String >("id", "");
-		style->DirtyDefinition();
+
+		style->DirtyDefinition(InvalidationMap::ID, old_id);
+		if (id != old_id)
+			style->DirtyDefinition(InvalidationMap::ID, id);
 	}
 
 	if (changed_attributes.find("class") != changed_attributes.end())
@@ -1429,49 +1647,45 @@ void Element::OnAttributeChange(const AttributeNameList& changed_attributes)
 		StyleSheetParser parser;
 		parser.ParseProperties(properties, GetAttribute< String >("style", ""));
 
-		Rocket::Core::PropertyMap property_map = properties.GetProperties();
-		for (Rocket::Core::PropertyMap::iterator i = property_map.begin(); i != property_map.end(); ++i)
-		{
-			SetProperty((*i).first, (*i).second);
-		}
+		SetProperties(properties);
 	}
 }
 
 // Called when properties on the element are changed.
-void Element::OnPropertyChange(const PropertyNameList& changed_properties)
+void Element::OnPropertyChange(const PropertyIdSet& changed_properties)
 {
-	bool all_dirty = StyleSheetSpecification::GetRegisteredProperties() == changed_properties;
+	bool all_dirty = StyleSheetSpecification::GetRegisteredPropertyIds() == changed_properties;
 
-	if (!IsLayoutDirty())
+	// This is done even if our layout is already dirty; our hierarchy has to be marked as changed so its previous
+	// layout isn't reused.
+	if (all_dirty)
 	{
-		if (all_dirty)
-		{
-			DirtyLayout();
-		}
-		else
+		DirtyLayout();
+	}
+	else
+	{
+		// Force a relayout if any of the changed properties require it.
+		for (PropertyId id = changed_properties.First(); id != PROPERTY_INVALID; id = changed_properties.Next(id))
 		{
-			// Force a relayout if any of the changed properties require it.
-			for (PropertyNameList::const_iterator i = changed_properties.begin(); i != changed_properties.end(); ++i)
+			const PropertyDefinition* property_definition = StyleSheetSpecification::GetProperty(id);
+			if (property_definition)
 			{
-				const PropertyDefinition* property_definition = StyleSheetSpecification::GetProperty(*i);
-				if (property_definition)
+				if (property_definition->IsLayoutForced())
 				{
-					if (property_definition->IsLayoutForced())
-					{
-						DirtyLayout();
-						break;
-					}
+					DirtyLayout();
+					break;
 				}
 			}
 		}
 	}
 
 	// Update the visibility.
-	if (all_dirty || changed_properties.find(VISIBILITY) != changed_properties.end() ||
-		changed_properties.find(DISPLAY) != changed_properties.end())
+	if (all_dirty || changed_properties.Contains(PROPERTY_VISIBILITY) ||
+		changed_properties.Contains(PROPERTY_DISPLAY))
 	{
-		bool new_visibility = GetDisplay() != DISPLAY_NONE &&
-							  GetProperty< int >(VISIBILITY) == VISIBILITY_VISIBLE;
+		const ComputedStyle& computed = GetComputedStyle();
+		bool new_visibility = computed.display != DISPLAY_NONE &&
+							  computed.visibility == VISIBILITY_VISIBLE;
 
 		if (visible != new_visibility)
 		{
@@ -1482,7 +1696,7 @@ void Element::OnPropertyChange(const PropertyNameList& changed_properties)
 		}
 
 		if (all_dirty || 
-			changed_properties.find(DISPLAY) != changed_properties.end())
+			changed_properties.Contains(PROPERTY_DISPLAY))
 		{
 			if (parent != NULL)
 				parent->DirtyStructure();
@@ -1491,10 +1705,10 @@ void Element::OnPropertyChange(const PropertyNameList& changed_properties)
 
 	// Update the position.
 	if (all_dirty ||
-		changed_properties.find(LEFT) != changed_properties.end() ||
-		changed_properties.find(RIGHT) != changed_properties.end() ||
-		changed_properties.find(TOP) != changed_properties.end() ||
-		changed_properties.find(BOTTOM) != changed_properties.end())
+		changed_properties.Contains(PROPERTY_LEFT) ||
+		changed_properties.Contains(PROPERTY_RIGHT) ||
+		changed_properties.Contains(PROPERTY_TOP) ||
+		changed_properties.Contains(PROPERTY_BOTTOM))
 	{
 		UpdateOffset();
 		DirtyOffset();
@@ -1502,12 +1716,11 @@ void Element::OnPropertyChange(const PropertyNameList& changed_properties)
 
 	// Update the z-index.
 	if (all_dirty || 
-		changed_properties.find(Z_INDEX) != changed_properties.end())
+		changed_properties.Contains(PROPERTY_Z_INDEX))
 	{
-		const Property* z_index_property = GetProperty(Z_INDEX);
+		const ComputedStyle& computed = GetComputedStyle();
 
-		if (z_index_property->unit == Property::KEYWORD &&
-			z_index_property->value.Get< int >() == Z_INDEX_AUTO)
+		if (computed.z_index_auto)
 		{
 			if (local_stacking_context &&
 				!local_stacking_context_forced)
@@ -1528,17 +1741,7 @@ void Element::OnPropertyChange(const PropertyNameList& changed_properties)
 		}
 		else
 		{
-			float new_z_index;
-			if (z_index_property->unit == Property::KEYWORD)
-			{
-				if (z_index_property->value.Get< int >() == Z_INDEX_TOP)
-					new_z_index = FLT_MAX;
-				else
-					new_z_index = -FLT_MAX;
-			}
-			else
-				new_z_index = z_index_property->value.Get< float >();
-
+			float new_z_index = computed.z_index;
 			if (new_z_index != z_index)
 			{
 				z_index = new_z_index;
@@ -1557,28 +1760,28 @@ void Element::OnPropertyChange(const PropertyNameList& changed_properties)
 
 	// Dirty the background if it's changed.
 	if (all_dirty ||
-		changed_properties.find(BACKGROUND_COLOR) != changed_properties.end())
+		changed_properties.Contains(PROPERTY_BACKGROUND_COLOR))
 		background->DirtyBackground();
 
 	// Dirty the border if it's changed.
 	if (all_dirty || 
-		changed_properties.find(BORDER_TOP_WIDTH) != changed_properties.end() ||
-		changed_properties.find(BORDER_RIGHT_WIDTH) != changed_properties.end() ||
-		changed_properties.find(BORDER_BOTTOM_WIDTH) != changed_properties.end() ||
-		changed_properties.find(BORDER_LEFT_WIDTH) != changed_properties.end() ||
-		changed_properties.find(BORDER_TOP_COLOR) != changed_properties.end() ||
-		changed_properties.find(BORDER_RIGHT_COLOR) != changed_properties.end() ||
-		changed_properties.find(BORDER_BOTTOM_COLOR) != changed_properties.end() ||
-		changed_properties.find(BORDER_LEFT_COLOR) != changed_properties.end())
+		changed_properties.Contains(PROPERTY_BORDER_TOP_WIDTH) ||
+		changed_properties.Contains(PROPERTY_BORDER_RIGHT_WIDTH) ||
+		changed_properties.Contains(PROPERTY_BORDER_BOTTOM_WIDTH) ||
+		changed_properties.Contains(PROPERTY_BORDER_LEFT_WIDTH) ||
+		changed_properties.Contains(PROPERTY_BORDER_TOP_COLOR) ||
+		changed_properties.Contains(PROPERTY_BORDER_RIGHT_COLOR) ||
+		changed_properties.Contains(PROPERTY_BORDER_BOTTOM_COLOR) ||
+		changed_properties.Contains(PROPERTY_BORDER_LEFT_COLOR))
 		border->DirtyBorder();
 
 	// Fetch a new font face if it has been changed.
 	if (all_dirty ||
-		changed_properties.find(FONT_FAMILY) != changed_properties.end() ||
-		changed_properties.find(FONT_CHARSET) != changed_properties.end() ||
-		changed_properties.find(FONT_WEIGHT) != changed_properties.end() ||
-		changed_properties.find(FONT_STYLE) != changed_properties.end() ||
-		changed_properties.find(FONT_SIZE) != changed_properties.end())
+		changed_properties.Contains(PROPERTY_FONT_FAMILY) ||
+		changed_properties.Contains(PROPERTY_FONT_CHARSET) ||
+		changed_properties.Contains(PROPERTY_FONT_WEIGHT) ||
+		changed_properties.Contains(PROPERTY_FONT_STYLE) ||
+		changed_properties.Contains(PROPERTY_FONT_SIZE))
 	{
 		// Store the old em; if it changes, then we need to dirty all em-relative properties.
 		int old_em = -1;
@@ -1614,9 +1817,9 @@ void Element::OnPropertyChange(const PropertyNameList& changed_properties)
 	
 	// Check for clipping state changes
 	if (all_dirty ||
-		changed_properties.find(CLIP) != changed_properties.end() ||
-		changed_properties.find(OVERFLOW_X) != changed_properties.end() ||
-		changed_properties.find(OVERFLOW_Y) != changed_properties.end())
+		changed_properties.Contains(PROPERTY_CLIP) ||
+		changed_properties.Contains(PROPERTY_OVERFLOW_X) ||
+		changed_properties.Contains(PROPERTY_OVERFLOW_Y))
 	{
 		clipping_state_dirty = true;
 	}
@@ -1636,6 +1839,25 @@ void Element::OnChildRemove(Element* child)
 		parent->OnChildRemove(child);
 }
 
+// Marks the element as needing an update on the next update loop.
+void Element::DirtyUpdate()
+{
+	update_dirty = true;
+
+	// Our ancestors will need to descend to us. Once we find one that's already been marked, the rest will have been
+	// marked too.
+	for (Element* ancestor = parent; ancestor != NULL && !ancestor->child_update_dirty; ancestor = ancestor->parent)
+		ancestor->child_update_dirty = true;
+}
+
+// Sets whether the element is to be updated on every update loop.
+void Element::SetContinuousUpdate(bool _continuous_update)
+{
+	continuous_update = _continuous_update;
+	if (continuous_update)
+		DirtyUpdate();
+}
+
 // Update the element's layout if required.
 void Element::UpdateLayout()
 {
@@ -1647,9 +1869,32 @@ void Element::UpdateLayout()
 // Forces a re-layout of this element, and any other children required.
 void Element::DirtyLayout()
 {
-	Element* document = GetOwnerDocument();
-	if (document != NULL)
-		document->DirtyLayout();
+	ElementDocument* document = GetOwnerDocument();
+	if (document == NULL)
+		return;
+
+	// Neither we nor our ancestors can reuse the layouts they were last given.
+	for (Element* ancestor = this; ancestor != NULL && ancestor != document; ancestor = ancestor->parent)
+		ancestor->subtree_layout_dirty = true;
+
+	// If one of our ancestors is formatted independently of the rest of the document, only it needs to be formatted
+	// again (unless its size changes as a result). Otherwise, the entire document does.
+	Element* layout_root = GetParentLayoutRoot();
+	if (layout_root == NULL)
+	{
+		static_cast< Element* >(document)->DirtyLayout();
+		return;
+	}
+
+	layout_root->layout_root_dirty = true;
+	for (Element* ancestor = layout_root->parent; ancestor != NULL; ancestor = ancestor->parent)
+	{
+		ancestor->child_layout_root_dirty = true;
+		if (ancestor == document)
+			break;
+	}
+
+	document->DirtyLayoutRoots();
 }
 
 /// Increment/Decrement the layout lock
@@ -1664,9 +1909,15 @@ void Element::LockLayout(bool lock)
 bool Element::IsLayoutDirty()
 {
 	Element* document = GetOwnerDocument();
-	if (document != NULL)
-		return document->IsLayoutDirty();
-	return false;
+	if (document == NULL)
+		return false;
+
+	if (document->IsLayoutDirty())
+		return true;
+
+	// Otherwise, we'll be formatted if our layout root is.
+	Element* layout_root = GetParentLayoutRoot();
+	return layout_root != NULL && layout_root->layout_root_dirty;
 }
 
 // Forces a reevaluation of applicable font effects.
@@ -1702,7 +1953,7 @@ void Element::ProcessEvent(Event& event)
 		if ((wheel_delta < 0 && GetScrollTop() > 0) ||
 			(wheel_delta > 0 && GetScrollHeight() > GetScrollTop() + GetClientHeight()))
 		{
-			int overflow_property = GetProperty< int >(OVERFLOW_Y);
+			int overflow_property = GetProperty< int >(PROPERTY_OVERFLOW_Y);
 			if (overflow_property == OVERFLOW_AUTO ||
 				overflow_property == OVERFLOW_SCROLL)
 			{
@@ -1769,6 +2020,12 @@ void Element::SetParent(Element* _parent)
 
 	// Save our parent
 	parent = _parent;
+
+	// Anything we remembered from our old ancestors may not outlive them.
+	style->DirtyParent();
+
+	// We won't be a layout root until we've been formatted as one in our new position.
+	layout_root = false;
 }
 
 void Element::ReleaseDeletedElements()
@@ -1800,7 +2057,7 @@ void Element::ReleaseElements(ElementList& released_elements)
 
 		// Set the parent to NULL unless it's been reparented already.
 		if (element->GetParentNode() == this)
-			element->parent = NULL;
+			element->SetParent(NULL);
 
 		element->RemoveReference();
 	}
@@ -1826,27 +2083,27 @@ void Element::UpdateOffset()
 			const Box& parent_box = offset_parent->GetBox();
 			Vector2f containing_block = parent_box.GetSize(Box::PADDING);
 
-			const Property *left = GetLocalProperty(LEFT);
-			const Property *right = GetLocalProperty(RIGHT);
+			const Property *left = GetLocalProperty(PROPERTY_LEFT);
+			const Property *right = GetLocalProperty(PROPERTY_RIGHT);
 			// If the element is anchored left, then the position is offset by that resolved value.
 			if (left != NULL && left->unit != Property::KEYWORD)
-				relative_offset_base.x = parent_box.GetEdge(Box::BORDER, Box::LEFT) + (ResolveProperty(LEFT, containing_block.x) + GetBox().GetEdge(Box::MARGIN, Box::LEFT));
+				relative_offset_base.x = parent_box.GetEdge(Box::BORDER, Box::LEFT) + (ResolveProperty(PROPERTY_LEFT, containing_block.x) + GetBox().GetEdge(Box::MARGIN, Box::LEFT));
 			// If the element is anchored right, then the position is set first so the element's right-most edge
 			// (including margins) will render up against the containing box's right-most content edge, and then
 			// offset by the resolved value.
 			if (right != NULL && right->unit != Property::KEYWORD)
-				relative_offset_base.x = containing_block.x + parent_box.GetEdge(Box::BORDER, Box::LEFT) - (ResolveProperty(RIGHT, containing_block.x) + GetBox().GetSize(Box::BORDER).x + GetBox().GetEdge(Box::MARGIN, Box::RIGHT));
+				relative_offset_base.x = containing_block.x + parent_box.GetEdge(Box::BORDER, Box::LEFT) - (ResolveProperty(PROPERTY_RIGHT, containing_block.x) + GetBox().GetSize(Box::BORDER).x + GetBox().GetEdge(Box::MARGIN, Box::RIGHT));
 
-			const Property *top = GetLocalProperty(TOP);
-			const Property *bottom = GetLocalProperty(BOTTOM);
+			const Property *top = GetLocalProperty(PROPERTY_TOP);
+			const Property *bottom = GetLocalProperty(PROPERTY_BOTTOM);
 			// If the element is anchored top, then the position is offset by that resolved value.
 			if (top != NULL && top->unit != Property::KEYWORD)
-				relative_offset_base.y = parent_box.GetEdge(Box::BORDER, Box::TOP) + (ResolveProperty(TOP, containing_block.y) + GetBox().GetEdge(Box::MARGIN, Box::TOP));
+				relative_offset_base.y = parent_box.GetEdge(Box::BORDER, Box::TOP) + (ResolveProperty(PROPERTY_TOP, containing_block.y) + GetBox().GetEdge(Box::MARGIN, Box::TOP));
 			// If the element is anchored bottom, then the position is set first so the element's right-most edge
 			// (including margins) will render up against the containing box's right-most content edge, and then
 			// offset by the resolved value.
 			else if (bottom != NULL && bottom->unit != Property::KEYWORD)
-				relative_offset_base.y = containing_block.y + parent_box.GetEdge(Box::BORDER, Box::TOP) - (ResolveProperty(BOTTOM, containing_block.y) + GetBox().GetSize(Box::BORDER).y + GetBox().GetEdge(Box::MARGIN, Box::BOTTOM));
+				relative_offset_base.y = containing_block.y + parent_box.GetEdge(Box::BORDER, Box::TOP) - (ResolveProperty(PROPERTY_BOTTOM, containing_block.y) + GetBox().GetSize(Box::BORDER).y + GetBox().GetEdge(Box::MARGIN, Box::BOTTOM));
 		}
 	}
 	else if (position_property == POSITION_RELATIVE)
@@ -1856,21 +2113,21 @@ void Element::UpdateOffset()
 			const Box& parent_box = offset_parent->GetBox();
 			Vector2f containing_block = parent_box.GetSize();
 
-			const Property *left = GetLocalProperty(LEFT);
-			const Property *right = GetLocalProperty(RIGHT);
+			const Property *left = GetLocalProperty(PROPERTY_LEFT);
+			const Property *right = GetLocalProperty(PROPERTY_RIGHT);
 			if (left != NULL && left->unit != Property::KEYWORD)
-				relative_offset_position.x = ResolveProperty(LEFT, containing_block.x);
+				relative_offset_position.x = ResolveProperty(PROPERTY_LEFT, containing_block.x);
 			else if (right != NULL && right->unit != Property::KEYWORD)
-				relative_offset_position.x = -1 * ResolveProperty(RIGHT, containing_block.x);
+				relative_offset_position.x = -1 * ResolveProperty(PROPERTY_RIGHT, containing_block.x);
 			else
 				relative_offset_position.x = 0;
 
-			const Property *top = GetLocalProperty(TOP);
-			const Property *bottom = GetLocalProperty(BOTTOM);
+			const Property *top = GetLocalProperty(PROPERTY_TOP);
+			const Property *bottom = GetLocalProperty(PROPERTY_BOTTOM);
 			if (top != NULL && top->unit != Property::KEYWORD)
-				relative_offset_position.y = ResolveProperty(TOP, containing_block.y);
+				relative_offset_position.y = ResolveProperty(PROPERTY_TOP, containing_block.y);
 			else if (bottom != NULL && bottom->unit != Property::KEYWORD)
-				relative_offset_position.y = -1 * ResolveProperty(BOTTOM, containing_block.y);
+				relative_offset_position.y = -1 * ResolveProperty(PROPERTY_BOTTOM, containing_block.y);
 			else
 				relative_offset_position.y = 0;
 		}
@@ -66,7 +66,7 @@ void ElementBackground::DirtyBackground()
 void ElementBackground::GenerateBackground()
 {
 	// Fetch the new colour for the background. If the colour is transparent, then we don't render any background.
-	Colourb colour = element->GetProperty(BACKGROUND_COLOR)->value.Get< Colourb >();
+	Colourb colour = element->GetComputedStyle().background_colour;
 	if (colour.alpha <= 0)
 	{
 		geometry.GetVertices().clear();
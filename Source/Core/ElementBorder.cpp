@@ -88,11 +88,8 @@ void ElementBorder::GenerateBorder()
 		Vertex* raw_vertices = &vertices[0];
 		int* raw_indices = &indices[0];
 
-		Colourb border_colours[4];
-		border_colours[0] = element->GetProperty(BORDER_TOP_COLOR)->value.Get< Colourb >();
-		border_colours[1] = element->GetProperty(BORDER_RIGHT_COLOR)->value.Get< Colourb >();
-		border_colours[2] = element->GetProperty(BORDER_BOTTOM_COLOR)->value.Get< Colourb >();
-		border_colours[3] = element->GetProperty(BORDER_LEFT_COLOR)->value.Get< Colourb >();
+		// The computed border colours are indexed by edge, as the box's edges are.
+		const Colourb* border_colours = element->GetComputedStyle().border_colour;
 
 		for (int i = 0; i < element->GetNumBoxes(); ++i)
 			GenerateBorder(raw_vertices, raw_indices, index_offset, element->GetBox(i), border_colours);
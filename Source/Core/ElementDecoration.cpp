@@ -28,6 +28,7 @@
 #include "precompiled.h"
 #include "ElementDecoration.h"
 #include "ElementDefinition.h"
+#include "ElementStyle.h"
 #include <Rocket/Core/Decorator.h>
 #include <Rocket/Core/Element.h>
 
@@ -58,6 +59,8 @@ bool ElementDecoration::ReloadDecorators()
 	const PseudoClassDecoratorMap& pseudo_class_decorators = definition->GetPseudoClassDecorators();
 	for (PseudoClassDecoratorMap::const_iterator i = pseudo_class_decorators.begin(); i != pseudo_class_decorators.end(); ++i)
 	{
+		PseudoClassRule rule((*i).first);
+
 		for (DecoratorMap::const_iterator j = (*i).second.begin(); j != (*i).second.end(); ++j)
 		{
 			int index = LoadDecorator((*j).second);
@@ -79,7 +82,7 @@ bool ElementDecoration::ReloadDecorators()
 					break;
 			}
 
-			pseudo_class_decorator_index->insert(k, PseudoClassDecoratorIndex(PseudoClassList((*i).first.begin(), (*i).first.end()), index));
+			pseudo_class_decorator_index->insert(k, PseudoClassDecoratorIndex(rule, index));
 		}
 	}
 
@@ -91,9 +94,9 @@ bool ElementDecoration::ReloadDecorators()
 
 		DecoratorIndex::iterator index_iterator = decorator_index.find((*i).first);
 		if (index_iterator == decorator_index.end())
-			decorator_index.insert(DecoratorIndex::value_type((*i).first, PseudoClassDecoratorIndexList(1, PseudoClassDecoratorIndex(PseudoClassList(), index))));
+			decorator_index.insert(DecoratorIndex::value_type((*i).first, PseudoClassDecoratorIndexList(1, PseudoClassDecoratorIndex(PseudoClassRule(), index))));
 		else
-			(*index_iterator).second.push_back(PseudoClassDecoratorIndex(PseudoClassList(), index));
+			(*index_iterator).second.push_back(PseudoClassDecoratorIndex(PseudoClassRule(), index));
 	}
 
 	active_decorators_dirty = true;
@@ -136,12 +139,16 @@ void ElementDecoration::UpdateActiveDecorators()
 	{
 		active_decorators.clear();
 
+		const ElementStyle* style = element->GetStyle();
+		const PseudoClassList& pseudo_classes = style->GetActivePseudoClasses();
+		PseudoClassMask pseudo_class_mask = style->GetActivePseudoClassMask();
+
 		for (DecoratorIndex::iterator i = decorator_index.begin(); i != decorator_index.end(); ++i)
 		{
 			PseudoClassDecoratorIndexList& indices = (*i).second;
 			for (size_t j = 0; j < indices.size(); ++j)
 			{
-				if (element->ArePseudoClassesSet(indices[j].first))
+				if (indices[j].first.IsApplicable(pseudo_classes, pseudo_class_mask))
 				{
 					// Insert the new index into the list of active decorators, ordered by z-index.
 					float z_index = decorators[indices[j].second].decorator->GetZIndex();
@@ -200,7 +207,8 @@ bool ElementDecoration::IterateDecorators(int& index, PseudoClassList& pseudo_cl
 		name = index_iterator->first;
 
 		int relative_index = index - count;
-		pseudo_classes = decorator_index_list[relative_index].first;
+		const StringList& rule_pseudo_classes = decorator_index_list[relative_index].first.GetPseudoClasses();
+		pseudo_classes = PseudoClassList(rule_pseudo_classes.begin(), rule_pseudo_classes.end());
 
 		const DecoratorHandle& decorator_handle = decorators[decorator_index_list[relative_index].second];
 		decorator = decorator_handle.decorator;
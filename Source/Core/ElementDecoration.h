@@ -29,6 +29,7 @@
 #define ROCKETCOREELEMENTDECORATION_H
 
 #include <Rocket/Core/Types.h>
+#include "PseudoClassRegistry.h"
 
 namespace Rocket {
 namespace Core {
@@ -83,7 +84,7 @@ private:
 	};
 
 	typedef std::vector< DecoratorHandle > DecoratorList;
-	typedef std::pair< PseudoClassList, int > PseudoClassDecoratorIndex;
+	typedef std::pair< PseudoClassRule, int > PseudoClassDecoratorIndex;
 	typedef std::vector< PseudoClassDecoratorIndex > PseudoClassDecoratorIndexList;
 	typedef std::map< String, PseudoClassDecoratorIndexList > DecoratorIndex;
 
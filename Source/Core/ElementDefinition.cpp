@@ -31,17 +31,26 @@
 #include <Rocket/Core/Factory.h>
 #include <Rocket/Core/FontDatabase.h>
 #include <Rocket/Core/Log.h>
+#include <Rocket/Core/StyleSheetSpecification.h>
+#include "PropertyLayer.h"
 
 namespace Rocket {
 namespace Core {
 
 ElementDefinition::ElementDefinition()
 {
+	lookup_tables = NULL;
 	structurally_volatile = false;
 }
 
 ElementDefinition::~ElementDefinition()
 {
+	delete lookup_tables;
+	for (size_t i = 0; i < layers.size(); ++i)
+		layers[i]->RemoveReference();
+	for (size_t i = 0; i < pseudo_class_layers.size(); ++i)
+		pseudo_class_layers[i]->RemoveReference();
+
 	for (DecoratorMap::iterator i = decorators.begin(); i != decorators.end(); ++i)
 		(*i).second->RemoveReference();
 
@@ -69,198 +78,209 @@ void ElementDefinition::Initialise(const std::vector< const StyleSheetNode* >& s
 		pseudo_class_volatility[*i] = STRUCTURE_VOLATILE;
 
 
-	// Merge the default (non-pseudo-class) properties.
+	// Share the nodes' property layers rather than copying their properties. As the layers are copied on write, they
+	// stay unchanged for as long as we hold them, even if the style sheet is released.
 	for (size_t i = 0; i < style_sheet_nodes.size(); ++i)
-		properties.Merge(style_sheet_nodes[i]->GetProperties());
+	{
+		layers.push_back(style_sheet_nodes[i]->GetPropertyLayer());
+		style_sheet_nodes[i]->GetPseudoClassPropertyLayers(pseudo_class_layers);
+	}
 
+	bool declares_property_groups = false;
+	for (size_t i = 0; i < layers.size(); ++i)
+	{
+		layers[i]->AddReference();
+		declares_property_groups |= layers[i]->DeclaresPropertyGroups();
+	}
+	for (size_t i = 0; i < pseudo_class_layers.size(); ++i)
+	{
+		pseudo_class_layers[i]->AddReference();
+		declares_property_groups |= pseudo_class_layers[i]->DeclaresPropertyGroups();
+	}
 
-	// Merge the pseudo-class properties.
-	PseudoClassPropertyMap merged_pseudo_class_properties;
-	for (size_t i = 0; i < style_sheet_nodes.size(); ++i)
+	// Decorators and font effects need the fully merged properties to be instanced, but only once; the merged
+	// dictionaries are discarded afterwards. Most definitions declare neither, and so can skip the merge entirely.
+	if (declares_property_groups)
 	{
-		// Merge all the pseudo-classes.
-		PseudoClassPropertyMap node_properties;
-		style_sheet_nodes[i]->GetPseudoClassProperties(node_properties);
-		for (PseudoClassPropertyMap::iterator j = node_properties.begin(); j != node_properties.end(); ++j)
-		{
-			// Merge the property maps into one uber-map; for the decorators.
-			PseudoClassPropertyMap::iterator k = merged_pseudo_class_properties.find((*j).first);
-			if (k == merged_pseudo_class_properties.end())
-				merged_pseudo_class_properties[(*j).first] = (*j).second;
-			else
-				(*k).second.Merge((*j).second);
+		PropertyDictionary merged_properties;
+		for (size_t i = 0; i < layers.size(); ++i)
+			merged_properties.Merge(layers[i]->GetProperties());
 
-			// Search through all entries in this dictionary; we'll insert each one into our optimised list of
-			// pseudo-class properties.
-			for (PropertyMap::const_iterator k = (*j).second.GetProperties().begin(); k != (*j).second.GetProperties().end(); ++k)
-			{
-				const String& property_name = (*k).first;
-				const Property& property = (*k).second;
-
-				// Skip this property if its specificity is lower than the base property's, as in
-				// this case it will never be used.
-				const Property* default_property = properties.GetProperty(property_name);
-				if (default_property != NULL &&
-					default_property->specificity >= property.specificity)
-					continue;
-
-				PseudoClassPropertyDictionary::iterator l = pseudo_class_properties.find(property_name);
-				if (l == pseudo_class_properties.end())
-					pseudo_class_properties[property_name] = PseudoClassPropertyList(1, PseudoClassProperty((*j).first, property));
-				else
-				{
-					// Find the location to insert this entry in the map, based on property priorities.
-					int index = 0;
-					while (index < (int) (*l).second.size() &&
-						   (*l).second[index].second.specificity > property.specificity)
-						index++;
+		PseudoClassPropertyMap merged_pseudo_class_properties;
+		for (size_t i = 0; i < pseudo_class_layers.size(); ++i)
+		{
+			const StringList& pseudo_classes = pseudo_class_layers[i]->GetPseudoClassRule().GetPseudoClasses();
 
-					(*l).second.insert((*l).second.begin() + index, PseudoClassProperty((*j).first, property));
-				}
-			}
+			PseudoClassPropertyMap::iterator j = merged_pseudo_class_properties.find(pseudo_classes);
+			if (j == merged_pseudo_class_properties.end())
+				merged_pseudo_class_properties[pseudo_classes] = pseudo_class_layers[i]->GetProperties();
+			else
+				(*j).second.Merge(pseudo_class_layers[i]->GetProperties());
 		}
-	}
 
-	InstanceDecorators(merged_pseudo_class_properties);
-	InstanceFontEffects(merged_pseudo_class_properties);
+		InstanceDecorators(merged_properties, merged_pseudo_class_properties);
+		InstanceFontEffects(merged_properties, merged_pseudo_class_properties);
+	}
 }
 
 // Returns a specific property from the element definition's base properties.
-const Property* ElementDefinition::GetProperty(const String& name, const PseudoClassList& pseudo_classes) const
+const Property* ElementDefinition::GetProperty(const String& name, const PseudoClassList& pseudo_classes, PseudoClassMask pseudo_class_mask) const
 {
+	PropertyId id = StyleSheetSpecification::GetPropertyId(name);
+	if (id >= 0)
+		return GetProperty(id, pseudo_classes, pseudo_class_mask);
+
+	const LookupTables& tables = GetLookupTables();
+
 	// Find a pseudo-class override for this property.
-	PseudoClassPropertyDictionary::const_iterator property_iterator = pseudo_class_properties.find(name);
-	if (property_iterator != pseudo_class_properties.end())
+	PseudoClassPropertyDictionary::const_iterator property_iterator = tables.pseudo_class_properties.find(name);
+	if (property_iterator != tables.pseudo_class_properties.end())
 	{
-		const PseudoClassPropertyList& property_list = (*property_iterator).second;
-		for (size_t i = 0; i < property_list.size(); ++i)
-		{
-			if (!IsPseudoClassRuleApplicable(property_list[i].first, pseudo_classes))
-				continue;
-
-			return &property_list[i].second;
-		}
+		const Property* property = GetPseudoClassProperty((*property_iterator).second, pseudo_classes, pseudo_class_mask);
+		if (property != NULL)
+			return property;
 	}
 
-	return properties.GetProperty(name);
+	PropertyPointerMap::const_iterator i = tables.unregistered_properties.find(name);
+	if (i == tables.unregistered_properties.end())
+		return NULL;
+
+	return (*i).second;
 }
 
-// Returns the list of properties this element definition defines for an element with the given set of pseudo-classes.
-void ElementDefinition::GetDefinedProperties(PropertyNameList& property_names, const PseudoClassList& pseudo_classes) const
+// Returns a specific registered property from the element definition's base properties.
+const Property* ElementDefinition::GetProperty(PropertyId id, const PseudoClassList& pseudo_classes, PseudoClassMask pseudo_class_mask) const
 {
-	for (PropertyMap::const_iterator i = properties.GetProperties().begin(); i != properties.GetProperties().end(); ++i)
-		property_names.insert((*i).first);
+	const LookupTables& tables = GetLookupTables();
 
-	for (PseudoClassPropertyDictionary::const_iterator i = pseudo_class_properties.begin(); i != pseudo_class_properties.end(); ++i)
+	// Find a pseudo-class override for this property.
+	if (id >= 0 && id < (PropertyId) tables.pseudo_class_property_index.size() &&
+		tables.pseudo_class_property_index[id] != NULL)
 	{
-		// If this property is already in the default dictionary, don't bother checking for it here.
-		if (property_names.find((*i).first) != property_names.end())
-			continue;
+		const Property* property = GetPseudoClassProperty(*tables.pseudo_class_property_index[id], pseudo_classes, pseudo_class_mask);
+		if (property != NULL)
+			return property;
+	}
+
+	if (id < 0 || id >= (PropertyId) tables.property_index.size())
+		return NULL;
+
+	return tables.property_index[id];
+}
+
+// Adds the registered properties this element definition defines for an element with the given set of
+// pseudo-classes to a set.
+void ElementDefinition::GetDefinedProperties(PropertyIdSet& property_ids, const PseudoClassList& pseudo_classes, PseudoClassMask pseudo_class_mask) const
+{
+	const LookupTables& tables = GetLookupTables();
+	property_ids |= tables.default_property_ids;
 
-		const PseudoClassPropertyList& property_list = (*i).second;
+	// Only the overrides of properties that aren't already in the set need checking.
+	PropertyIdSet candidate_ids = tables.pseudo_class_property_ids;
+	candidate_ids.Subtract(property_ids);
+
+	for (PropertyId id = candidate_ids.First(); id != PROPERTY_INVALID; id = candidate_ids.Next(id))
+	{
+		const PseudoClassPropertyList& property_list = *tables.pseudo_class_property_index[id];
 
 		// Search through all the pseudo-class combinations that have a definition for this property; if the calling
-		// element matches at least one of them, then add it to the list.
-		bool property_defined = false;
+		// element matches at least one of them, then add it to the set.
 		for (size_t j = 0; j < property_list.size(); ++j)
 		{
-			if (IsPseudoClassRuleApplicable(property_list[j].first, pseudo_classes))
+			if (property_list[j].first->IsApplicable(pseudo_classes, pseudo_class_mask))
 			{
-				property_defined = true;
+				property_ids.Insert(id);
 				break;
 			}
 		}
-
-		if (property_defined)
-			property_names.insert((*i).first);
 	}
 }
 
-// Returns the list of properties this element definition has explicit definitions for involving the given
-// pseudo-class.
-void ElementDefinition::GetDefinedProperties(PropertyNameList& property_names, const PseudoClassList& pseudo_classes, const String& pseudo_class) const
+// Adds the registered properties this element definition has explicit definitions for involving the given
+// pseudo-class to a set.
+void ElementDefinition::GetDefinedProperties(PropertyIdSet& property_ids, const PseudoClassList& pseudo_classes, PseudoClassMask pseudo_class_mask, const String& pseudo_class) const
 {
-	for (PseudoClassPropertyDictionary::const_iterator i = pseudo_class_properties.begin(); i != pseudo_class_properties.end(); ++i)
-	{
-		// If this property has already been found, don't bother checking for it again.
-		if (property_names.find((*i).first) != property_names.end())
-			continue;
+	const LookupTables& tables = GetLookupTables();
+
+	PseudoClassPropertyIdMap::const_iterator dependent_ids = tables.pseudo_class_dependent_property_ids.find(pseudo_class);
+	if (dependent_ids == tables.pseudo_class_dependent_property_ids.end())
+		return;
 
-		const PseudoClassPropertyList& property_list = (*i).second;
+	// If a property has already been found, don't bother checking for it again.
+	PropertyIdSet candidate_ids = (*dependent_ids).second;
+	candidate_ids.Subtract(property_ids);
 
-		bool property_defined = false;
+	int pseudo_class_id = PseudoClassRegistry::FindId(pseudo_class);
+	for (PropertyId id = candidate_ids.First(); id != PROPERTY_INVALID; id = candidate_ids.Next(id))
+	{
+		const PseudoClassPropertyList& property_list = *tables.pseudo_class_property_index[id];
 		for (size_t j = 0; j < property_list.size(); ++j)
 		{
-			bool rule_valid = true;
-			bool found_toggled_pseudo_class = false;
-
-			const StringList& rule_pseudo_classes = property_list[j].first;
-			for (size_t j = 0; j < rule_pseudo_classes.size(); ++j)
+			if (property_list[j].first->IsApplicable(pseudo_classes, pseudo_class_mask, pseudo_class, pseudo_class_id))
 			{
-				if (rule_pseudo_classes[j] == pseudo_class)
-				{
-					found_toggled_pseudo_class = true;
-					continue;
-				}
-
-				if (pseudo_classes.find(rule_pseudo_classes[j]) == pseudo_classes.end())
-				{			
-					rule_valid = false;
-					break;
-				}
-			}
-
-			if (rule_valid &&
-				found_toggled_pseudo_class)
-			{
-				property_defined = true;
+				property_ids.Insert(id);
 				break;
 			}
 		}
-
-		if (property_defined)
-			property_names.insert((*i).first);
 	}
 }
 
 // Iterates over the properties in the definition.
-bool ElementDefinition::IterateProperties(int& index, const PseudoClassList& pseudo_classes, PseudoClassList& property_pseudo_classes, String& property_name, const Property*& property) const
+bool ElementDefinition::IterateProperties(int& index, const PseudoClassList& pseudo_classes, PseudoClassMask pseudo_class_mask, PseudoClassList& property_pseudo_classes, String& property_name, const Property*& property) const
 {
-	if (index < properties.GetNumProperties())
+	const LookupTables& tables = GetLookupTables();
+
+	// The base properties are iterated through the registered properties first, then the unregistered ones.
+	int num_registered_properties = tables.default_property_ids.Count();
+	if (index < num_registered_properties)
 	{
-		PropertyMap::const_iterator i = properties.GetProperties().begin();
+		PropertyId id = tables.default_property_ids.First();
 		for (int count = 0; count < index; ++count)
+			id = tables.default_property_ids.Next(id);
+
+		property_pseudo_classes.clear();
+		property_name = StyleSheetSpecification::GetPropertyName(id);
+		property = tables.property_index[id];
+		++index;
+
+		return true;
+	}
+
+	int property_count = num_registered_properties + (int) tables.unregistered_properties.size();
+	if (index < property_count)
+	{
+		PropertyPointerMap::const_iterator i = tables.unregistered_properties.begin();
+		for (int count = num_registered_properties; count < index; ++count)
 			++i;
 
 		property_pseudo_classes.clear();
 		property_name = (*i).first;
-		property = &((*i).second);
+		property = (*i).second;
 		++index;
 
 		return true;
 	}
 
 	// Not in the base properties; check for pseudo-class overrides.
-	int property_count = properties.GetNumProperties();
-	for (PseudoClassPropertyDictionary::const_iterator i = pseudo_class_properties.begin(); i != pseudo_class_properties.end(); ++i)
+	for (PseudoClassPropertyDictionary::const_iterator i = tables.pseudo_class_properties.begin(); i != tables.pseudo_class_properties.end(); ++i)
 	{
 		// Iterate over each pseudo-class set that has a definition for this property; if we find one that matches our
 		// pseudo-class, increment our index counter and either return that property (if we hit the requested index) or
 		// continue looking if we're still below it.
 		for (size_t j = 0; j < (*i).second.size(); ++j)
 		{
-			if (IsPseudoClassRuleApplicable((*i).second[j].first, pseudo_classes))
+			if ((*i).second[j].first->IsApplicable(pseudo_classes, pseudo_class_mask))
 			{
 				property_count++;
 				if (property_count > index)
 				{
 					// Copy the list of pseudo-classes.
+					const StringList& rule_pseudo_classes = (*i).second[j].first->GetPseudoClasses();
 					property_pseudo_classes.clear();
-					for (size_t k = 0; k < (*i).second[j].first.size(); ++k)
-						property_pseudo_classes.insert((*i).second[j].first[k]);
+					property_pseudo_classes.insert(rule_pseudo_classes.begin(), rule_pseudo_classes.end());
 
 					property_name = (*i).first;
-					property = &((*i).second[j].second);
+					property = (*i).second[j].second;
 					++index;
 
 					return true;
@@ -289,7 +309,7 @@ const PseudoClassDecoratorMap& ElementDefinition::GetPseudoClassDecorators() con
 }
 
 // Appends this definition's font effects into a provided map of effects.
-void ElementDefinition::GetFontEffects(FontEffectMap& applicable_font_effects, const PseudoClassList& pseudo_classes) const
+void ElementDefinition::GetFontEffects(FontEffectMap& applicable_font_effects, const PseudoClassList& pseudo_classes, PseudoClassMask pseudo_class_mask) const
 {
 	// Check each set of named effects, looking for applicable ones.
 	for (FontEffectIndex::const_iterator i = font_effect_index.begin(); i != font_effect_index.end(); ++i)
@@ -299,7 +319,7 @@ void ElementDefinition::GetFontEffects(FontEffectMap& applicable_font_effects, c
 		const PseudoClassFontEffectIndex& index = i->second;
 		for (size_t j = 0; j < index.size(); ++j)
 		{
-			if (IsPseudoClassRuleApplicable(index[j].first, pseudo_classes))
+			if (index[j].first.IsApplicable(pseudo_classes, pseudo_class_mask))
 			{
 				// This is the most specific valid font effect this element has under the name. If
 				// the map of effects already has an effect with the same name, the effect with the
@@ -431,7 +451,7 @@ int ElementDefinition::BuildPropertyGroupDictionary(PropertyDictionary& group_pr
 }
 
 // Builds decorator definitions from the parsed properties and instances decorators as appropriate.
-void ElementDefinition::InstanceDecorators(const PseudoClassPropertyMap& merged_pseudo_class_properties)
+void ElementDefinition::InstanceDecorators(const PropertyDictionary& properties, const PseudoClassPropertyMap& merged_pseudo_class_properties)
 {
 	// Now we have the complete property list, we can compile decorator properties and instance as appropriate.
 	PropertyGroupMap decorator_definitions;
@@ -482,7 +502,7 @@ bool ElementDefinition::InstanceDecorator(const String& name, const String& type
 }
 
 // Builds font effect definitions from the parsed properties and instances font effects as appropriate.
-void ElementDefinition::InstanceFontEffects(const PseudoClassPropertyMap& merged_pseudo_class_properties)
+void ElementDefinition::InstanceFontEffects(const PropertyDictionary& properties, const PseudoClassPropertyMap& merged_pseudo_class_properties)
 {
 	// Now we have the complete property list, we can compile font-effect properties and instance as appropriate.
 	PropertyGroupMap font_effect_definitions;
@@ -537,7 +557,7 @@ bool ElementDefinition::InstanceFontEffect(const String& name, const String& typ
 			break;
 	}
 
-	index->insert(insert_iterator, PseudoClassFontEffectIndex::value_type(pseudo_classes, effect_index));
+	index->insert(insert_iterator, PseudoClassFontEffectIndex::value_type(PseudoClassRule(pseudo_classes), effect_index));
 
 
 	// Mark the effect's pseudo-classes as volatile.
@@ -552,16 +572,129 @@ bool ElementDefinition::InstanceFontEffect(const String& name, const String& typ
 	return true;
 }
 
-// Returns true if the pseudo-class requirement of a rule is met by a list of an element's pseudo-classes.
-bool ElementDefinition::IsPseudoClassRuleApplicable(const StringList& rule_pseudo_classes, const PseudoClassList& element_pseudo_classes) const
+// Returns the lookup tables, flattening them from the layers if this is the first request.
+const ElementDefinition::LookupTables& ElementDefinition::GetLookupTables() const
 {
-	for (StringList::size_type i = 0; i < rule_pseudo_classes.size(); ++i)
+	if (lookup_tables == NULL)
 	{
-		if (element_pseudo_classes.find(rule_pseudo_classes[i]) == element_pseudo_classes.end())
-			return false;
+		lookup_tables = new LookupTables();
+		BuildLookupTables(*lookup_tables);
 	}
 
-	return true;
+	return *lookup_tables;
+}
+
+// Flattens the layers into a set of lookup tables.
+void ElementDefinition::BuildLookupTables(LookupTables& tables) const
+{
+	// Merge the default (non-pseudo-class) properties. As with merging dictionaries, a property replaces any earlier
+	// one unless that has a higher specificity.
+	for (size_t i = 0; i < layers.size(); ++i)
+	{
+		const PropertyMap& layer_properties = layers[i]->GetProperties().GetProperties();
+		for (PropertyMap::const_iterator j = layer_properties.begin(); j != layer_properties.end(); ++j)
+		{
+			const Property* property = &(*j).second;
+
+			PropertyId id = StyleSheetSpecification::GetPropertyId((*j).first);
+			const Property** slot;
+			if (id >= 0)
+			{
+				if (id >= (PropertyId) tables.property_index.size())
+					tables.property_index.resize(id + 1, NULL);
+				slot = &tables.property_index[id];
+				tables.default_property_ids.Insert(id);
+			}
+			else
+			{
+				slot = &tables.unregistered_properties.insert(PropertyPointerMap::value_type((*j).first, NULL)).first->second;
+			}
+
+			if (*slot == NULL ||
+				(*slot)->specificity <= property->specificity)
+				*slot = property;
+		}
+	}
+
+	// Merge the pseudo-class properties into our optimised list.
+	for (size_t i = 0; i < pseudo_class_layers.size(); ++i)
+	{
+		const PseudoClassRule* rule = &pseudo_class_layers[i]->GetPseudoClassRule();
+
+		const PropertyMap& rule_properties = pseudo_class_layers[i]->GetProperties().GetProperties();
+		for (PropertyMap::const_iterator j = rule_properties.begin(); j != rule_properties.end(); ++j)
+		{
+			const String& property_name = (*j).first;
+			const Property* property = &(*j).second;
+
+			// Skip this property if its specificity is lower than the base property's, as in
+			// this case it will never be used.
+			PropertyId id = StyleSheetSpecification::GetPropertyId(property_name);
+			const Property* default_property = NULL;
+			if (id >= 0)
+			{
+				if (id < (PropertyId) tables.property_index.size())
+					default_property = tables.property_index[id];
+			}
+			else
+			{
+				PropertyPointerMap::const_iterator l = tables.unregistered_properties.find(property_name);
+				if (l != tables.unregistered_properties.end())
+					default_property = (*l).second;
+			}
+
+			if (default_property != NULL &&
+				default_property->specificity >= property->specificity)
+				continue;
+
+			PseudoClassPropertyDictionary::iterator l = tables.pseudo_class_properties.find(property_name);
+			if (l == tables.pseudo_class_properties.end())
+				tables.pseudo_class_properties[property_name] = PseudoClassPropertyList(1, PseudoClassProperty(rule, property));
+			else
+			{
+				// Find the location to insert this entry in the map, based on property priorities.
+				int index = 0;
+				while (index < (int) (*l).second.size() &&
+					   (*l).second[index].second->specificity > property->specificity)
+					index++;
+
+				(*l).second.insert((*l).second.begin() + index, PseudoClassProperty(rule, property));
+			}
+		}
+	}
+
+	// Index the pseudo-class overrides of the registered properties, so an element changing definitions or
+	// pseudo-classes can find the properties that may have changed without searching through every definition.
+	for (PseudoClassPropertyDictionary::const_iterator i = tables.pseudo_class_properties.begin(); i != tables.pseudo_class_properties.end(); ++i)
+	{
+		PropertyId id = StyleSheetSpecification::GetPropertyId((*i).first);
+		if (id < 0)
+			continue;
+
+		if (id >= (PropertyId) tables.pseudo_class_property_index.size())
+			tables.pseudo_class_property_index.resize(id + 1, NULL);
+		tables.pseudo_class_property_index[id] = &(*i).second;
+
+		tables.pseudo_class_property_ids.Insert(id);
+		for (size_t j = 0; j < (*i).second.size(); ++j)
+		{
+			const StringList& rule_pseudo_classes = (*i).second[j].first->GetPseudoClasses();
+			for (size_t k = 0; k < rule_pseudo_classes.size(); ++k)
+				tables.pseudo_class_dependent_property_ids[rule_pseudo_classes[k]].Insert(id);
+		}
+	}
+}
+
+// Returns the first applicable pseudo-class override in a list of overrides.
+const Property* ElementDefinition::GetPseudoClassProperty(const PseudoClassPropertyList& property_list, const PseudoClassList& pseudo_classes, PseudoClassMask pseudo_class_mask) const
+{
+	for (size_t i = 0; i < property_list.size(); ++i)
+	{
+		if (property_list[i].first->IsApplicable(pseudo_classes, pseudo_class_mask))
+			return property_list[i].second;
+	}
+
+	return NULL;
 }
 
 }
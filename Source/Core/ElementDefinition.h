@@ -40,12 +40,14 @@ namespace Core {
 
 class Decorator;
 class FontEffect;
+class PropertyLayer;
 
 // Defines for the optimised version of the pseudo-class properties (note the difference from the
 // PseudoClassPropertyMap defined in StyleSheetNode.h ... bit clumsy). Here the properties are stored as a list
 // of definitions against each property name in specificity-order, along with the pseudo-class requirements for each
-// one. This makes it much more straight-forward to query at run-time.
-typedef std::pair< StringList, Property > PseudoClassProperty;
+// one. This makes it much more straight-forward to query at run-time. Both the rules and the properties are owned by
+// the property layers the definition was built from.
+typedef std::pair< const PseudoClassRule*, const Property* > PseudoClassProperty;
 typedef std::vector< PseudoClassProperty > PseudoClassPropertyList;
 typedef std::map< String, PseudoClassPropertyList > PseudoClassPropertyDictionary;
 
@@ -69,35 +71,47 @@ public:
 	ElementDefinition();
 	virtual ~ElementDefinition();
 
-	/// Initialises the element definition from a list of style sheet nodes.
+	/// Initialises the element definition from a list of style sheet nodes. The definition shares the nodes'
+	/// property layers rather than copying their properties; the lookup tables are only flattened from the layers
+	/// the first time a property is requested.
 	void Initialise(const std::vector< const StyleSheetNode* >& style_sheet_nodes, const PseudoClassList& volatile_pseudo_classes, bool structurally_volatile);
 
 	/// Returns a specific property from the element definition's base properties.
 	/// @param[in] name The name of the property to return.
 	/// @param[in] pseudo_classes The pseudo-classes currently active on the calling element.
+	/// @param[in] pseudo_class_mask The mask of the pseudo-classes currently active on the calling element.
 	/// @return The property defined against the give name, or NULL if no such property was found.
-	const Property* GetProperty(const String& name, const PseudoClassList& pseudo_classes) const;
+	const Property* GetProperty(const String& name, const PseudoClassList& pseudo_classes, PseudoClassMask pseudo_class_mask) const;
+	/// Returns a specific registered property from the element definition's base properties.
+	/// @param[in] id The identifier of the property to return.
+	/// @param[in] pseudo_classes The pseudo-classes currently active on the calling element.
+	/// @param[in] pseudo_class_mask The mask of the pseudo-classes currently active on the calling element.
+	/// @return The property defined against the given identifier, or NULL if no such property was found.
+	const Property* GetProperty(PropertyId id, const PseudoClassList& pseudo_classes, PseudoClassMask pseudo_class_mask) const;
 
-	/// Returns the list of properties this element definition defines for an element with the given set of
-	/// pseudo-classes.
-	/// @param[out] property_names The list to store the defined properties in.
+	/// Adds the registered properties this element definition defines for an element with the given set of
+	/// pseudo-classes to a set.
+	/// @param[out] property_ids The set to add the defined properties to.
 	/// @param[in] pseudo_classes The pseudo-classes defined on the querying element.
-	void GetDefinedProperties(PropertyNameList& property_names, const PseudoClassList& pseudo_classes) const;
-	/// Returns the list of properties this element definition has explicit definitions for involving the given
-	/// pseudo-class.
-	/// @param[out] property_names The list of store the newly defined / undefined properties in.
+	/// @param[in] pseudo_class_mask The mask of the pseudo-classes defined on the querying element.
+	void GetDefinedProperties(PropertyIdSet& property_ids, const PseudoClassList& pseudo_classes, PseudoClassMask pseudo_class_mask) const;
+	/// Adds the registered properties this element definition has explicit definitions for involving the given
+	/// pseudo-class to a set.
+	/// @param[out] property_ids The set to add the newly defined / undefined properties to.
 	/// @param[in] pseudo_classes The list of pseudo-classes currently set on the element (post-change).
+	/// @param[in] pseudo_class_mask The mask of the pseudo-classes currently set on the element (post-change).
 	/// @param[in] pseudo_class The pseudo-class that was just activated or deactivated.
-	void GetDefinedProperties(PropertyNameList& property_names, const PseudoClassList& pseudo_classes, const String& pseudo_class) const;
+	void GetDefinedProperties(PropertyIdSet& property_ids, const PseudoClassList& pseudo_classes, PseudoClassMask pseudo_class_mask, const String& pseudo_class) const;
 
 	/// Iterates over the properties in the definition.
 	/// @param[inout] index Index of the property to fetch. This is incremented to the next valid index after the fetch.
 	/// @param[in] pseudo_classes The pseudo-classes defined on the querying element.
+	/// @param[in] pseudo_class_mask The mask of the pseudo-classes defined on the querying element.
 	/// @param[out] property_pseudo_classes The pseudo-classes the property is defined by.
 	/// @param[out] property_name The name of the property at the specified index.
 	/// @param[out] property The property at the specified index.
 	/// @return True if a property was successfully fetched.
-	bool IterateProperties(int& index, const PseudoClassList& pseudo_classes, PseudoClassList& property_pseudo_classes, String& property_name, const Property*& property) const;
+	bool IterateProperties(int& index, const PseudoClassList& pseudo_classes, PseudoClassMask pseudo_class_mask, PseudoClassList& property_pseudo_classes, String& property_name, const Property*& property) const;
 
 	/// Returns the list of the element definition's instanced decorators in the default state.
 	/// @return The list of instanced decorators.
@@ -110,7 +124,8 @@ public:
 	/// provided map of effects.
 	/// @param[out] font_effects The outgoing map of font effects.
 	/// @param[in] pseudo_classes Pseudo-classes active on the querying element.
-	void GetFontEffects(FontEffectMap& font_effects, const PseudoClassList& pseudo_classes) const;
+	/// @param[in] pseudo_class_mask The mask of the pseudo-classes active on the querying element.
+	void GetFontEffects(FontEffectMap& font_effects, const PseudoClassList& pseudo_classes, PseudoClassMask pseudo_class_mask) const;
 
 	/// Returns the volatility of a pseudo-class.
 	/// @param[in] pseudo_class The name of the pseudo-class to check for volatility.
@@ -130,11 +145,16 @@ private:
 	typedef std::pair< String, PropertyDictionary > PropertyGroup;
 	typedef std::map< String, PropertyGroup > PropertyGroupMap;
 
-	typedef std::vector< std::pair< StringList, int > > PseudoClassFontEffectIndex;
+	typedef std::vector< std::pair< PseudoClassRule, int > > PseudoClassFontEffectIndex;
 	typedef std::map< String, PseudoClassFontEffectIndex > FontEffectIndex;
 
 	typedef std::map< String, PseudoClassVolatility > PseudoClassVolatilityMap;
 
+	typedef std::map< String, PropertyIdSet > PseudoClassPropertyIdMap;
+
+	typedef std::vector< PropertyLayer* > PropertyLayerList;
+	typedef std::map< String, const Property* > PropertyPointerMap;
+
 	// Finds all propery declarations for a group.
 	void BuildPropertyGroup(PropertyGroupMap& groups, const String& group_type, const PropertyDictionary& element_properties, const PropertyGroupMap* default_properties = NULL);
 	// Updates a property dictionary of all properties for a single group.
@@ -142,23 +162,49 @@ private:
 
 	// Builds decorator definitions from the parsed properties and instances decorators as
 	// appropriate.
-	void InstanceDecorators(const PseudoClassPropertyMap& merged_pseudo_class_properties);
+	void InstanceDecorators(const PropertyDictionary& properties, const PseudoClassPropertyMap& merged_pseudo_class_properties);
 	// Attempts to instance a decorator.
 	bool InstanceDecorator(const String& name, const String& type, const PropertyDictionary& properties, const StringList& pseudo_class = StringList());
 
 	// Builds font effect definitions from the parsed properties and instances font effects as
 	// appropriate.
-	void InstanceFontEffects(const PseudoClassPropertyMap& merged_pseudo_class_properties);
+	void InstanceFontEffects(const PropertyDictionary& properties, const PseudoClassPropertyMap& merged_pseudo_class_properties);
 	// Attempts to instance a font effect.
 	bool InstanceFontEffect(const String& name, const String& type, const PropertyDictionary& properties, const StringList& pseudo_class = StringList());
 
-	// Returns true if the pseudo-class requirement of a rule is met by a list of an element's pseudo-classes.
-	bool IsPseudoClassRuleApplicable(const StringList& rule_pseudo_classes, const PseudoClassList& element_pseudo_classes) const;
+	// Returns the first applicable pseudo-class override in a list of overrides, or NULL if none apply.
+	const Property* GetPseudoClassProperty(const PseudoClassPropertyList& property_list, const PseudoClassList& pseudo_classes, PseudoClassMask pseudo_class_mask) const;
+
+	// The flattened view of the layers, pointing into the layers' properties.
+	struct LookupTables
+	{
+		// The registered properties for the default state, indexed by property identifier.
+		std::vector< const Property* > property_index;
+		// The unregistered properties for the default state, such as decorator declarations.
+		PropertyPointerMap unregistered_properties;
+		// The overridden properties for the element's pseudo-classes.
+		PseudoClassPropertyDictionary pseudo_class_properties;
+		// The pseudo-class overrides of registered properties, indexed by property identifier.
+		std::vector< const PseudoClassPropertyList* > pseudo_class_property_index;
+
+		// The registered properties defined in the default state, and those with pseudo-class overrides.
+		PropertyIdSet default_property_ids;
+		PropertyIdSet pseudo_class_property_ids;
+		// For each pseudo-class, the registered properties with overrides that require it.
+		PseudoClassPropertyIdMap pseudo_class_dependent_property_ids;
+	};
 
-	// The attributes for the default state of the element, with no pseudo-classes.
-	PropertyDictionary properties;
-	// The overridden attributes for the element's pseudo-classes.
-	PseudoClassPropertyDictionary pseudo_class_properties;
+	// Returns the lookup tables, flattening them from the layers if this is the first request.
+	const LookupTables& GetLookupTables() const;
+	// Flattens the layers into a set of lookup tables.
+	void BuildLookupTables(LookupTables& tables) const;
+
+	// The shared property layers of the style sheet nodes the definition was built from, in order of specificity,
+	// and the layers of each of their pseudo-classes.
+	PropertyLayerList layers;
+	PropertyLayerList pseudo_class_layers;
+	// The lookup tables; built on demand.
+	mutable LookupTables* lookup_tables;
 
 	// The instanced decorators for this element definition.
 	DecoratorMap decorators;
@@ -33,6 +33,7 @@
 #include "ElementStyle.h"
 #include "EventDispatcher.h"
 #include "LayoutEngine.h"
+#include "LayoutStatisticsRecorder.h"
 #include "StreamFile.h"
 #include "StyleSheetFactory.h"
 #include "Template.h"
@@ -49,7 +50,9 @@ ElementDocument::ElementDocument(const String& tag) : Element(tag)
 
 	modal = false;
 	layout_dirty = true;
+	document_layout_dirty = true;
 	lock_layout = 0;
+	concurrent_layout = false;
 
 	ForceLocalStackingContext();
 
@@ -297,14 +300,36 @@ void ElementDocument::_UpdateLayout()
 	layout_dirty = false;
 	lock_layout++;
 
+	// If only some of our layout roots need formatting, they can be formatted on their own unless one of them changes
+	// size in a way that affects the rest of the document.
+	if (document_layout_dirty ||
+		!LayoutEngine::FormatDirtyLayoutRoots(this))
+		FormatDocument();
+	
+	lock_layout--;
+}
+
+// Formats the entire document.
+void ElementDocument::FormatDocument()
+{
+	document_layout_dirty = false;
+
 	Vector2f containing_block(0, 0);
 	if (GetParentNode() != NULL)
 		containing_block = GetParentNode()->GetBox().GetSize();
 
 	LayoutEngine layout_engine;
 	layout_engine.FormatElement(this, containing_block);
-	
-	lock_layout--;
+	ROCKET_LAYOUT_STATISTIC(OnDocumentLayout());
+}
+
+// Sets the dirty flag on the layout so the dirty layout roots within the document will be formatted.
+void ElementDocument::DirtyLayoutRoots()
+{
+	layout_dirty = true;
+
+	// Our layout is refreshed from our update.
+	DirtyUpdate();
 }
 
 // Updates the position of the document based on the style properties.
@@ -318,21 +343,21 @@ void ElementDocument::UpdatePosition()
 	// Work out our containing block; relative offsets are calculated against it.
 	Vector2f containing_block = GetParentNode()->GetBox().GetSize(Box::CONTENT);
 
-	const Property *left = GetLocalProperty(LEFT);
-	const Property *right = GetLocalProperty(RIGHT);
+	const Property *left = GetLocalProperty(PROPERTY_LEFT);
+	const Property *right = GetLocalProperty(PROPERTY_RIGHT);
 	if (left != NULL && left->unit != Property::KEYWORD)
-		position.x = ResolveProperty(LEFT, containing_block.x);
+		position.x = ResolveProperty(PROPERTY_LEFT, containing_block.x);
 	else if (right != NULL && right->unit != Property::KEYWORD)
-		position.x = (containing_block.x - GetBox().GetSize(Box::MARGIN).x) - ResolveProperty(RIGHT, containing_block.x);
+		position.x = (containing_block.x - GetBox().GetSize(Box::MARGIN).x) - ResolveProperty(PROPERTY_RIGHT, containing_block.x);
 	else
 		position.x = GetBox().GetEdge(Box::MARGIN, Box::LEFT);
 
-	const Property *top = GetLocalProperty(TOP);
-	const Property *bottom = GetLocalProperty(BOTTOM);
+	const Property *top = GetLocalProperty(PROPERTY_TOP);
+	const Property *bottom = GetLocalProperty(PROPERTY_BOTTOM);
 	if (top != NULL && top->unit != Property::KEYWORD)
-		position.y = ResolveProperty(TOP, containing_block.y);
+		position.y = ResolveProperty(PROPERTY_TOP, containing_block.y);
 	else if (bottom != NULL && bottom->unit != Property::KEYWORD)
-		position.y = (containing_block.y - GetBox().GetSize(Box::MARGIN).y) - ResolveProperty(BOTTOM, containing_block.y);
+		position.y = (containing_block.y - GetBox().GetSize(Box::MARGIN).y) - ResolveProperty(PROPERTY_BOTTOM, containing_block.y);
 	else
 		position.y = GetBox().GetEdge(Box::MARGIN, Box::TOP);
 
@@ -352,28 +377,39 @@ void ElementDocument::LockLayout(bool lock)
 void ElementDocument::DirtyLayout()
 {
 	layout_dirty = true;
+	document_layout_dirty = true;
+
+	// Our layout is refreshed from our update.
+	DirtyUpdate();
 }
 
 bool ElementDocument::IsLayoutDirty()
 {
-	return layout_dirty;
+	return document_layout_dirty;
 }
 
 // Refreshes the document layout if required.
 void ElementDocument::OnUpdate()
 {
+	// If our context formats its documents concurrently, we're formatted along with the others once its update is
+	// complete.
+	Context* context = GetContext();
+	if (context != NULL &&
+		context->GetConcurrentLayout())
+		return;
+
 	UpdateLayout();
 }
 
 // Repositions the document if necessary.
-void ElementDocument::OnPropertyChange(const PropertyNameList& changed_properties)
+void ElementDocument::OnPropertyChange(const PropertyIdSet& changed_properties)
 {
 	Element::OnPropertyChange(changed_properties);
 
-	if (changed_properties.find(TOP) != changed_properties.end() ||
-		changed_properties.find(RIGHT) != changed_properties.end() ||
-		changed_properties.find(BOTTOM) != changed_properties.end() ||
-		changed_properties.find(LEFT) != changed_properties.end())
+	if (changed_properties.Contains(PROPERTY_TOP) ||
+		changed_properties.Contains(PROPERTY_RIGHT) ||
+		changed_properties.Contains(PROPERTY_BOTTOM) ||
+		changed_properties.Contains(PROPERTY_LEFT))
 		UpdatePosition();
 }
 
@@ -68,8 +68,8 @@ void ElementScroll::EnableScrollbar(Orientation orientation, float element_width
 	if (!scrollbars[orientation].enabled)
 	{
 		CreateScrollbar(orientation);
-		scrollbars[orientation].element->SetProperty(VISIBILITY, "visible");
 		scrollbars[orientation].enabled = true;
+		element->UpdateScrollbarVisibility();
 	}
 
 	// Determine the size of the scrollbar.
@@ -83,7 +83,7 @@ void ElementScroll::EnableScrollbar(Orientation orientation, float element_width
 		if (box.GetSize().y < 0)
 			scrollbars[orientation].size = box.GetCumulativeEdge(Box::CONTENT, Box::LEFT) +
 										   box.GetCumulativeEdge(Box::CONTENT, Box::RIGHT) +
-										   scrollbars[orientation].element->ResolveProperty(HEIGHT, element_width);
+										   scrollbars[orientation].element->ResolveProperty(PROPERTY_HEIGHT, element_width);
 		else
 			scrollbars[orientation].size = box.GetSize(Box::MARGIN).y;
 	}
@@ -94,8 +94,40 @@ void ElementScroll::DisableScrollbar(Orientation orientation)
 {
 	if (scrollbars[orientation].enabled)
 	{
-		scrollbars[orientation].element->SetProperty(VISIBILITY, "hidden");
 		scrollbars[orientation].enabled = false;
+		element->UpdateScrollbarVisibility();
+	}
+}
+
+// Creates, hidden, any scrollbars that may be enabled on the element given its overflow properties.
+void ElementScroll::CreateScrollbars()
+{
+	int overflow_properties[2];
+	element->GetOverflow(&overflow_properties[HORIZONTAL], &overflow_properties[VERTICAL]);
+
+	for (int i = 0; i < 2; i++)
+	{
+		if (scrollbars[i].element != NULL ||
+			(overflow_properties[i] != OVERFLOW_AUTO &&
+			 overflow_properties[i] != OVERFLOW_SCROLL))
+			continue;
+
+		CreateScrollbar((Orientation) i);
+		scrollbars[i].element->SetProperty(VISIBILITY, Property(VISIBILITY_HIDDEN, Property::KEYWORD));
+	}
+}
+
+// Shows the enabled scrollbars and hides the disabled ones.
+void ElementScroll::UpdateScrollbarVisibility()
+{
+	for (int i = 0; i < 2; i++)
+	{
+		if (scrollbars[i].element == NULL ||
+			scrollbars[i].visible == scrollbars[i].enabled)
+			continue;
+
+		scrollbars[i].visible = scrollbars[i].enabled;
+		scrollbars[i].element->SetProperty(VISIBILITY, Property(scrollbars[i].visible ? VISIBILITY_VISIBLE : VISIBILITY_HIDDEN, Property::KEYWORD));
 	}
 }
 
@@ -178,7 +210,7 @@ void ElementScroll::FormatScrollbars()
 		}
 
 		float slider_length = containing_block[1 - i];
-		float user_scrollbar_margin = scrollbars[i].element->ResolveProperty(SCROLLBAR_MARGIN, slider_length);
+		float user_scrollbar_margin = scrollbars[i].element->ResolveProperty(PROPERTY_SCROLLBAR_MARGIN, slider_length);
 		float min_scrollbar_margin = GetScrollbarSize(i == VERTICAL ? HORIZONTAL : VERTICAL);
 		slider_length -= Math::Max(user_scrollbar_margin, min_scrollbar_margin);
 
@@ -265,6 +297,7 @@ ElementScroll::Scrollbar::Scrollbar()
 	element = NULL;
 	widget = NULL;
 	enabled = false;
+	visible = false;
 	size = 0;
 }
 
@@ -28,6 +28,8 @@
 #include "precompiled.h"
 #include "ElementStyle.h"
 #include "ElementStyleCache.h"
+#include "AncestorFilter.h"
+#include "DefinitionUpdateBatch.h"
 #include <algorithm>
 #include <Rocket/Core/ElementDocument.h>
 #include <Rocket/Core/ElementUtilities.h>
@@ -36,33 +38,44 @@
 #include <Rocket/Core/PropertyDefinition.h>
 #include <Rocket/Core/PropertyDictionary.h>
 #include <Rocket/Core/StyleSheetSpecification.h>
+#include <Rocket/Core/SystemInterface.h>
 #include "ElementBackground.h"
 #include "ElementBorder.h"
 #include "ElementDecoration.h"
 #include "ElementDefinition.h"
 #include "FontFaceHandle.h"
+#include "PropertyShorthandDefinition.h"
+#include "StyleSharingCache.h"
+#include "StyleStatisticsRecorder.h"
 
 namespace Rocket {
 namespace Core {
 
+// The number of elements that need to be matched before an update matches them concurrently.
+static const int MIN_CONCURRENT_DEFINITION_MATCHES = 256;
+
 ElementStyle::ElementStyle(Element* _element)
 {
 	local_properties = NULL;
-	em_properties = NULL;
+	em_properties_valid = false;
 	definition = NULL;
 	element = _element;
+	pseudo_class_mask = 0;
+	pseudo_class_mask_complete = true;
 	cache = new ElementStyleCache(this);
 
 	definition_dirty = true;
 	child_definition_dirty = true;
+	computed_style_dirty = true;
+
+	update_depth = 0;
+	update_clear_em_properties = false;
 }
 
 ElementStyle::~ElementStyle()
 {
 	if (local_properties != NULL)
 		delete local_properties;
-	if (em_properties != NULL)
-		delete em_properties;
 
 	if (definition != NULL)
 		definition->RemoveReference();
@@ -70,13 +83,6 @@ ElementStyle::~ElementStyle()
 	delete cache;
 }
 
-static PropCounter prop_counter;
-
-PropCounter &ElementStyle::GetPropCounter()
-{
-	return prop_counter;
-}
-
 // Returns the element's definition, updating if necessary.
 const ElementDefinition* ElementStyle::GetDefinition()
 {
@@ -89,34 +95,112 @@ const ElementDefinition* ElementStyle::GetDefinition()
 }
 	
 void ElementStyle::UpdateDefinition()
+{
+	if (!definition_dirty &&
+		!child_definition_dirty)
+		return;
+
+	// Build the filter of our ancestors; it is maintained as the update descends through our children.
+	AncestorFilter ancestor_filter;
+	int depth = 0;
+	for (Element* ancestor = element->GetParentNode(); ancestor != NULL; ancestor = ancestor->GetParentNode())
+	{
+		ancestor_filter.Push(ancestor->GetTagName(), ancestor->GetId(), ancestor->GetStyle()->classes);
+		depth++;
+	}
+
+	// If the application can run tasks concurrently and enough elements need to be matched against their style
+	// sheets, match them all concurrently first; their definitions are then resolved and applied as normal.
+	int max_concurrent_tasks = GetSystemInterface()->GetMaxConcurrentTasks();
+	if (max_concurrent_tasks > 1)
+	{
+		DefinitionUpdateBatch batch;
+		GatherDefinitionUpdates(batch, depth);
+
+		if (batch.GetNumMatches() >= MIN_CONCURRENT_DEFINITION_MATCHES)
+		{
+			batch.Match(max_concurrent_tasks);
+			UpdateDefinition(NULL, NULL, &ancestor_filter, &batch);
+			return;
+		}
+	}
+
+	UpdateDefinition(NULL, NULL, &ancestor_filter, NULL);
+}
+
+// Adds this element and its descendants into a batch of elements being updated.
+void ElementStyle::GatherDefinitionUpdates(DefinitionUpdateBatch& batch, int depth)
+{
+	// Elements matching structural selectors look at their siblings' properties while being matched, so they can't
+	// be matched concurrently.
+	const StyleSheet* style_sheet = NULL;
+	if (definition_dirty)
+	{
+		style_sheet = GetStyleSheet();
+		if (style_sheet != NULL &&
+			style_sheet->IsStructurallyVolatile(element->GetTagName()))
+			style_sheet = NULL;
+	}
+
+	batch.AddElement(element, style_sheet, depth);
+
+	// The descendants of a skipped element won't be updated. If our definition is about to change, we can't yet
+	// tell if we'll be skipped; our descendants are then matched as normal.
+	if (child_definition_dirty &&
+		(definition_dirty || !element->IsUpdateSkipped()))
+	{
+		for (int i = 0; i < element->GetNumChildren(true); i++)
+			element->GetChild(i)->GetStyle()->GatherDefinitionUpdates(batch, depth + 1);
+	}
+}
+
+// Updates this definition if required, sharing definitions through the sharing caches.
+void ElementStyle::UpdateDefinition(StyleSharingCache* sharing_cache, StyleSharingCache* child_sharing_cache, AncestorFilter* ancestor_filter, const DefinitionUpdateBatch* batch)
 {
 	if (definition_dirty)
 	{
 		definition_dirty = false;
+
+		// A style sheet loaded since our pseudo-classes were set may have interned some of them.
+		if (!pseudo_class_mask_complete)
+			UpdatePseudoClassMask();
 		
 		ElementDefinition* new_definition = NULL;
 		
 		const StyleSheet* style_sheet = GetStyleSheet();
 		if (style_sheet != NULL)
 		{
-			new_definition = style_sheet->GetElementDefinition(element);
+			// If a sibling or cousin would match exactly the same selectors as us, we can take its definition
+			// instead of matching the style sheet again.
+			if (sharing_cache == NULL ||
+				!sharing_cache->Find(new_definition, this, style_sheet))
+			{
+				const DefinitionMatch* match = batch != NULL ? batch->GetMatch(element, style_sheet) : NULL;
+				if (match != NULL)
+					new_definition = style_sheet->GetElementDefinition(*match);
+				else
+					new_definition = style_sheet->GetElementDefinition(element, ancestor_filter);
+
+				if (sharing_cache != NULL)
+					sharing_cache->Insert(this, style_sheet, new_definition);
+			}
 		}
 		
 		// Switch the property definitions if the definition has changed.
 		if (new_definition != definition || new_definition == NULL)
 		{
-			PropertyNameList properties;
+			PropertyIdSet properties;
 			
 			if (definition != NULL)
 			{
-				definition->GetDefinedProperties(properties, pseudo_classes);
+				definition->GetDefinedProperties(properties, pseudo_classes, pseudo_class_mask);
 				definition->RemoveReference();
 			}
 			
 			definition = new_definition;
 			
 			if (definition != NULL)
-				definition->GetDefinedProperties(properties, pseudo_classes);
+				definition->GetDefinedProperties(properties, pseudo_classes, pseudo_class_mask);
 			
 			DirtyProperties(properties);
 			element->GetElementDecoration()->ReloadDecorators();
@@ -127,17 +211,94 @@ void ElementStyle::UpdateDefinition()
 		}
 	}
 	
-	if (child_definition_dirty)
+	// If our element is skipped by the update, our descendants' definitions are left dirty until it is shown.
+	if (child_definition_dirty &&
+		!element->IsUpdateSkipped())
 	{
+		// Our children can share definitions with each other, and our grandchildren with their cousins. If we
+		// weren't given a cache for our children, they can only share with each other.
+		StyleSharingCache local_child_sharing_cache;
+		if (child_sharing_cache == NULL)
+			child_sharing_cache = &local_child_sharing_cache;
+
+		StyleSharingCache grandchild_sharing_cache;
+
+		ancestor_filter->Push(element->GetTagName(), element->GetId(), classes);
+
 		for (int i = 0; i < element->GetNumChildren(true); i++)
 		{
-			element->GetChild(i)->GetStyle()->UpdateDefinition();
+			element->GetChild(i)->GetStyle()->UpdateDefinition(child_sharing_cache, &grandchild_sharing_cache, ancestor_filter, batch);
 		}
+
+		ancestor_filter->Pop(element->GetTagName(), element->GetId(), classes);
 		
 		child_definition_dirty = false;
 	}
 }
 
+// Checks if this element is guaranteed to match exactly the same selectors as another element.
+bool ElementStyle::CanShareDefinition(const ElementStyle& other) const
+{
+	if (&other == this)
+		return true;
+
+	if (!HasSameSelectorInputs(other))
+		return false;
+
+	Element* parent = element->GetParentNode();
+	Element* other_parent = other.element->GetParentNode();
+	if (parent == other_parent)
+		return true;
+
+	// Cousins can share if their parents are equivalent siblings.
+	if (parent == NULL ||
+		other_parent == NULL ||
+		parent->GetParentNode() != other_parent->GetParentNode())
+		return false;
+
+	const ElementStyle* parent_style = parent->GetStyle();
+	const ElementStyle* other_parent_style = other_parent->GetStyle();
+	return !parent_style->definition_dirty &&
+		   !other_parent_style->definition_dirty &&
+		   parent_style->definition == other_parent_style->definition &&
+		   parent_style->HasSameSelectorInputs(*other_parent_style);
+}
+
+// Checks if this element has the same tag, id, classes and pseudo-classes as another element.
+bool ElementStyle::HasSameSelectorInputs(const ElementStyle& other) const
+{
+	if (element->GetTagName() != other.element->GetTagName() ||
+		element->GetId() != other.element->GetId() ||
+		classes.size() != other.classes.size() ||
+		pseudo_class_mask != other.pseudo_class_mask ||
+		pseudo_classes != other.pseudo_classes)
+		return false;
+
+	for (size_t i = 0; i < classes.size(); ++i)
+	{
+		if (std::find(other.classes.begin(), other.classes.end(), classes[i]) == other.classes.end())
+			return false;
+	}
+
+	return true;
+}
+
+// Rebuilds the mask of the active pseudo-classes from their names.
+void ElementStyle::UpdatePseudoClassMask()
+{
+	pseudo_class_mask = 0;
+	pseudo_class_mask_complete = true;
+
+	for (PseudoClassList::const_iterator i = pseudo_classes.begin(); i != pseudo_classes.end(); ++i)
+	{
+		int pseudo_class_id = PseudoClassRegistry::FindId(*i);
+		if (pseudo_class_id < 0)
+			pseudo_class_mask_complete = false;
+		else
+			pseudo_class_mask |= PseudoClassRegistry::GetMask(pseudo_class_id);
+	}
+}
+
 // Sets or removes a pseudo-class on the element.
 void ElementStyle::SetPseudoClass(const String& pseudo_class, bool activate)
 {
@@ -150,13 +311,29 @@ void ElementStyle::SetPseudoClass(const String& pseudo_class, bool activate)
 
 	if (pseudo_classes.size() != num_pseudo_classes)
 	{
+		// Only the pseudo-classes referred to by a style sheet need to be in the mask, so applications are free to
+		// set as many others as they like without using up the registry.
+		int pseudo_class_id = PseudoClassRegistry::FindId(pseudo_class);
+		PseudoClassMask pseudo_class_bit = PseudoClassRegistry::GetMask(pseudo_class_id);
+		if (activate)
+		{
+			pseudo_class_mask |= pseudo_class_bit;
+			if (pseudo_class_id < 0)
+				pseudo_class_mask_complete = false;
+		}
+		else
+			pseudo_class_mask &= ~pseudo_class_bit;
+
 		element->GetElementDecoration()->DirtyDecorators();
 
+#ifdef ROCKET_ENABLE_STYLE_STATS
+		int num_restyles = 0;
+#endif
 		const ElementDefinition* definition = element->GetDefinition();
 		if (definition != NULL)
 		{
-			PropertyNameList properties;
-			definition->GetDefinedProperties(properties, pseudo_classes, pseudo_class);
+			PropertyIdSet properties;
+			definition->GetDefinedProperties(properties, pseudo_classes, pseudo_class_mask, pseudo_class);
 			DirtyProperties(properties);
 
 			switch (definition->GetPseudoClassVolatility(pseudo_class))
@@ -166,13 +343,21 @@ void ElementStyle::SetPseudoClass(const String& pseudo_class, bool activate)
 					break;
 
 				case ElementDefinition::STRUCTURE_VOLATILE:
-					DirtyChildDefinitions();
+#ifdef ROCKET_ENABLE_STYLE_STATS
+					num_restyles = DirtyDependentDefinitions(InvalidationMap::PSEUDO_CLASS, pseudo_class);
+#else
+					DirtyDependentDefinitions(InvalidationMap::PSEUDO_CLASS, pseudo_class);
+#endif
 					break;
 
 				default:
 					break;
 			}
 		}
+
+#ifdef ROCKET_ENABLE_STYLE_STATS
+		ROCKET_STYLE_STATISTIC(OnPseudoClassChange(num_restyles));
+#endif
 	}
 }
 
@@ -187,6 +372,12 @@ const PseudoClassList& ElementStyle::GetActivePseudoClasses() const
 	return pseudo_classes;
 }
 
+// Gets the mask of the current active pseudo classes.
+PseudoClassMask ElementStyle::GetActivePseudoClassMask() const
+{
+	return pseudo_class_mask;
+}
+
 // Sets or removes a class on the element.
 void ElementStyle::SetClass(const String& class_name, bool activate)
 {
@@ -197,7 +388,7 @@ void ElementStyle::SetClass(const String& class_name, bool activate)
 		if (class_location == classes.end())
 		{
 			classes.push_back(class_name);
-			DirtyDefinition();
+			DirtyDefinition(InvalidationMap::CLASS, class_name);
 		}
 	}
 	else
@@ -205,7 +396,7 @@ void ElementStyle::SetClass(const String& class_name, bool activate)
 		if (class_location != classes.end())
 		{
 			classes.erase(class_location);
-			DirtyDefinition();
+			DirtyDefinition(InvalidationMap::CLASS, class_name);
 		}
 	}
 }
@@ -219,9 +410,30 @@ bool ElementStyle::IsClassSet(const String& class_name) const
 // Specifies the entire list of classes for this element. This will replace any others specified.
 void ElementStyle::SetClassNames(const String& class_names)
 {
-	classes.clear();
-	StringUtilities::ExpandString(classes, class_names, ' ');
-	DirtyDefinition();
+	StringList old_classes;
+	old_classes.swap(classes);
+
+	// Each class is only kept once, as SetClass() does, so a repeated class doesn't match its rules twice.
+	StringList new_classes;
+	StringUtilities::ExpandString(new_classes, class_names, ' ');
+	for (size_t i = 0; i < new_classes.size(); ++i)
+	{
+		if (std::find(classes.begin(), classes.end(), new_classes[i]) == classes.end())
+			classes.push_back(new_classes[i]);
+	}
+
+	// Only the classes we've gained or lost can change our definition or our descendants'.
+	for (size_t i = 0; i < old_classes.size(); ++i)
+	{
+		if (std::find(classes.begin(), classes.end(), old_classes[i]) == classes.end())
+			DirtyDefinition(InvalidationMap::CLASS, old_classes[i]);
+	}
+
+	for (size_t i = 0; i < classes.size(); ++i)
+	{
+		if (std::find(old_classes.begin(), old_classes.end(), classes[i]) == old_classes.end())
+			DirtyDefinition(InvalidationMap::CLASS, classes[i]);
+	}
 }
 
 // Returns the list of classes specified for this element.
@@ -240,13 +452,19 @@ String ElementStyle::GetClassNames() const
 	return class_names;
 }
 
+// Returns the active class list.
+const StringList& ElementStyle::GetClassNameList() const
+{
+	return classes;
+}
+
 // Sets a local property override on the element.
 bool ElementStyle::SetProperty(const String& name, const String& value)
 {
 	if (local_properties == NULL)
 		local_properties = new PropertyDictionary();
 
-	if (StyleSheetSpecification::ParsePropertyDeclaration(*local_properties, name, value))
+	if (StyleSheetSpecification::ParseCachedPropertyDeclaration(*local_properties, name, value))
 	{
 		DirtyProperty(name);
 		return true;
@@ -271,11 +489,41 @@ bool ElementStyle::SetProperty(const String& name, const Property& property)
 		local_properties = new PropertyDictionary();
 
 	local_properties->SetProperty(name, new_property);
-	DirtyProperty(name);
+	DirtyProperty(new_property.definition->GetId());
 
 	return true;
 }
 
+// Sets a number of local property overrides on the element to pre-parsed values.
+bool ElementStyle::SetProperties(const PropertyDictionary& properties)
+{
+	bool success = true;
+	PropertyIdSet dirty_properties;
+
+	const PropertyMap& property_map = properties.GetProperties();
+	for (PropertyMap::const_iterator i = property_map.begin(); i != property_map.end(); ++i)
+	{
+		Property new_property = (*i).second;
+
+		new_property.definition = StyleSheetSpecification::GetProperty((*i).first);
+		if (new_property.definition == NULL)
+		{
+			success = false;
+			continue;
+		}
+
+		if (local_properties == NULL)
+			local_properties = new PropertyDictionary();
+
+		local_properties->SetProperty((*i).first, new_property);
+		dirty_properties.Insert(new_property.definition->GetId());
+	}
+
+	DirtyProperties(dirty_properties);
+
+	return success;
+}
+
 // Removes a local property override on the element.
 void ElementStyle::RemoveProperty(const String& name)
 {
@@ -289,43 +537,102 @@ void ElementStyle::RemoveProperty(const String& name)
 	}
 }
 
+// Begins a batch of changes to the element's style.
+void ElementStyle::BeginUpdate()
+{
+	update_depth++;
+}
+
+// Ends a batch of changes to the element's style, dirtying all properties changed during it.
+void ElementStyle::EndUpdate()
+{
+	ROCKET_ASSERT(update_depth > 0);
+	if (update_depth <= 0 ||
+		--update_depth > 0)
+		return;
+
+	PropertyIdSet properties = update_dirty_properties;
+	update_dirty_properties.Clear();
+
+	bool clear_em_properties = update_clear_em_properties;
+	update_clear_em_properties = false;
+
+	DirtyProperties(properties, clear_em_properties);
+}
+
 // Returns one of this element's properties.
 const Property* ElementStyle::GetProperty(const String& name)
 {
-	if (prop_counter.find(name) == prop_counter.end())
-		prop_counter[name] = 0;
-	prop_counter[name] = prop_counter[name] + 1;
+	PropertyId id = StyleSheetSpecification::GetPropertyId(name);
+	if (id != PROPERTY_INVALID)
+		return GetProperty(id);
+
+	// Unregistered properties have no default and can't be inherited, so they can only be defined locally.
+	return GetLocalProperty(name);
+}
 
-	const Property* local_property = GetLocalProperty(name);
+// Returns one of this element's registered properties.
+const Property* ElementStyle::GetProperty(PropertyId id)
+{
+	ROCKET_STYLE_STATISTIC(OnPropertyLookup(id));
+
+	const Property* local_property = GetLocalProperty(id);
 	if (local_property != NULL)
 		return local_property;
 
 	// Fetch the property specification.
-	const PropertyDefinition* property = StyleSheetSpecification::GetProperty(name);
+	const PropertyDefinition* property = StyleSheetSpecification::GetProperty(id);
 	if (property == NULL)
 		return NULL;
 
 	// If we can inherit this property, return our parent's property.
 	if (property->IsInherited())
-	{
-		Element* parent = element->GetParentNode();
-		while (parent != NULL)
-		{
-			const Property* parent_property = parent->style->GetLocalProperty(name);
-			if (parent_property)
-				return parent_property;
-			
-			parent = parent->GetParentNode();
-		}
-	}
+		return GetInheritedProperty(id, property);
 
 	// No property available! Return the default value.
 	return property->GetDefaultValue();
 }
 
+// Returns the value of an inherited property that isn't defined locally on this element.
+const Property* ElementStyle::GetInheritedProperty(PropertyId id, const PropertyDefinition* definition)
+{
+	if (id < (int) inherited_values.size() &&
+		inherited_values[id] != NULL)
+	{
+		ROCKET_STYLE_STATISTIC(OnInheritedLookup(0));
+		return inherited_values[id];
+	}
+
+	// Our parent's value is either defined locally on it or memoised from its own parent, so we only need to step
+	// up a single level to resolve this.
+	const Property* inherited_property;
+
+	Element* parent = element->GetParentNode();
+	if (parent != NULL)
+	{
+		ROCKET_STYLE_STATISTIC(OnInheritedLookup(1));
+		inherited_property = parent->style->GetProperty(id);
+	}
+	else
+	{
+		ROCKET_STYLE_STATISTIC(OnInheritedLookup(0));
+		inherited_property = definition->GetDefaultValue();
+	}
+
+	if (id >= (int) inherited_values.size())
+		inherited_values.resize(id + 1, NULL);
+	inherited_values[id] = inherited_property;
+
+	return inherited_property;
+}
+
 // Returns one of this element's properties.
 const Property* ElementStyle::GetLocalProperty(const String& name)
 {
+	PropertyId id = StyleSheetSpecification::GetPropertyId(name);
+	if (id != PROPERTY_INVALID)
+		return GetLocalProperty(id);
+
 	// Check for overriding local properties.
 	if (local_properties != NULL)
 	{
@@ -336,7 +643,25 @@ const Property* ElementStyle::GetLocalProperty(const String& name)
 
 	// Check for a property defined in an RCSS rule.
 	if (definition != NULL)
-		return definition->GetProperty(name, pseudo_classes);
+		return definition->GetProperty(name, pseudo_classes, pseudo_class_mask);
+
+	return NULL;
+}
+
+// Returns one of this element's registered properties.
+const Property* ElementStyle::GetLocalProperty(PropertyId id)
+{
+	// Check for overriding local properties.
+	if (local_properties != NULL)
+	{
+		const Property* property = local_properties->GetProperty(id);
+		if (property != NULL)
+			return property;
+	}
+
+	// Check for a property defined in an RCSS rule.
+	if (definition != NULL)
+		return definition->GetProperty(id, pseudo_classes, pseudo_class_mask);
 
 	return NULL;
 }
@@ -387,67 +712,69 @@ float ElementStyle::ResolveProperty(const Property* property, float base_value)
 // Resolves one of this element's properties.
 float ElementStyle::ResolveProperty(const String& name, float base_value)
 {
-	const Property* property = GetProperty(name);
+	PropertyId id = StyleSheetSpecification::GetPropertyId(name);
+	if (id != PROPERTY_INVALID)
+		return ResolveProperty(id, base_value);
+
+	// An unregistered property can only be set locally, so it can't be relative to an inherited value.
+	const Property* property = GetLocalProperty(name);
 	if (!property)
 	{
 		ROCKET_ERROR;
 		return 0.0f;
 	}
 
-	if (property->unit & Property::RELATIVE_UNIT)
+	return ResolveProperty(property, base_value);
+}
+
+// Resolves one of this element's registered properties.
+float ElementStyle::ResolveProperty(PropertyId id, float base_value)
+{
+	// Reuse the value from a previous call if it was resolved against the same font size or base value; relayouts
+	// that don't change either then don't need to look up the property at all.
+	ResolvedLength* resolved_length = NULL;
+	for (size_t i = 0; i < resolved_lengths.size(); ++i)
 	{
-		// The calculated value of the font-size property is inherited, so we need to check if this
-		// is an inherited property. If so, then we return our parent's font size instead.
-		if (name == FONT_SIZE)
+		if (resolved_lengths[i].id == id)
 		{
-			Rocket::Core::Element* parent = element->GetParentNode();
-			if (parent == NULL)
-				return 0;
-
-			if (GetLocalProperty(FONT_SIZE) == NULL)
-				return parent->ResolveProperty(FONT_SIZE, 0);
+			resolved_length = &resolved_lengths[i];
 
-			// The base value for font size is always the height of *this* element's parent's font.
-			base_value = parent->ResolveProperty(FONT_SIZE, 0);
-		}
+			float key;
+			if (GetResolvedLengthKey(key, id, resolved_length->unit, base_value) &&
+				resolved_length->key == key)
+				return resolved_length->value;
 
-		if (property->unit & Property::PERCENT)
-			return base_value * property->value.Get< float >() * 0.01f;
-		else if (property->unit & Property::EM)
-		{
-			// If an em-relative font size is specified, it is expressed relative to the parent's
-			// font height.
-			if (name == FONT_SIZE)
-				return property->value.Get< float >() * base_value;
-			else
-				return property->value.Get< float >() * ElementUtilities::GetFontSize(element);
+			break;
 		}
 	}
 
-	if (property->unit & Property::NUMBER || property->unit & Property::PX)
+	const Property* property = GetProperty(id);
+	if (!property)
 	{
-		return property->value.Get< float >();
+		ROCKET_ERROR;
+		return 0.0f;
 	}
-    
-    // Values based on pixels-per-inch.
-	if (property->unit & Property::PPI_UNIT)
-	{
-		float inch = property->value.Get< float >() * element->GetRenderInterface()->GetPixelsPerInch();
 
-		if (property->unit & Property::INCH) // inch
-			return inch;
-		if (property->unit & Property::CM) // centimeter
-			return inch / 2.54f;
-		if (property->unit & Property::MM) // millimeter
-			return inch / 25.4f;
-		if (property->unit & Property::PT) // point
-			return inch / 72.0f;
-		if (property->unit & Property::PC) // pica
-			return inch / 6.0f;
+	float value = ResolveLength(id, property, base_value);
+
+	// Resolving the value has resolved anything its key depends on, so the key is available unless the element
+	// has been detached from its parent in the meantime.
+	float key;
+	if (!GetResolvedLengthKey(key, id, property->unit, base_value))
+		return value;
+
+	if (resolved_length == NULL)
+	{
+		resolved_lengths.push_back(ResolvedLength());
+		resolved_length = &resolved_lengths.back();
+		resolved_length->id = id;
 	}
 
-	// We're not a numeric property; return 0.
-	return 0.0f;
+	resolved_length->unit = property->unit;
+	resolved_length->key = key;
+	resolved_length->value = value;
+
+	return value;
 }
 
 // Iterates over the properties defined on the element.
@@ -481,7 +808,7 @@ bool ElementStyle::IterateProperties(int& index, PseudoClassList& property_pseud
 		// Offset the index to be relative to the definition before we start indexing. When we do get a property back,
 		// check that it hasn't been overridden by the element's local properties; if so, continue on to the next one.
 		index -= index_offset;
-		while (definition->IterateProperties(index, pseudo_classes, property_pseudo_classes, name, property))
+		while (definition->IterateProperties(index, pseudo_classes, pseudo_class_mask, property_pseudo_classes, name, property))
 		{
 			if (local_properties == NULL ||
 				local_properties->GetProperty(name) == NULL)
@@ -510,6 +837,8 @@ StyleSheet* ElementStyle::GetStyleSheet() const
 void ElementStyle::DirtyDefinition()
 {
 	definition_dirty = true;
+	computed_style_dirty = true;
+	element->DirtyUpdate();
 	DirtyChildDefinitions();
 	
 	// Dirty the child definition update the element tree
@@ -527,37 +856,114 @@ void ElementStyle::DirtyChildDefinitions()
 		element->GetChild(i)->GetStyle()->DirtyDefinition();
 }
 
+// Marks the definitions dirty that may change when a class or id is set on or removed from the element.
+void ElementStyle::DirtyDefinition(InvalidationMap::SelectorInput input_type, const String& input)
+{
+	definition_dirty = true;
+	computed_style_dirty = true;
+	element->DirtyUpdate();
+	DirtyDependentDefinitions(input_type, input);
+
+	Element* parent = element->GetParentNode();
+	while (parent)
+	{
+		parent->GetStyle()->child_definition_dirty = true;
+		parent = parent->GetParentNode();
+	}
+}
+
+// Marks the definitions of the descendants dirty that may be matched by rules depending on an input set on this
+// element.
+int ElementStyle::DirtyDependentDefinitions(InvalidationMap::SelectorInput input_type, const String& input)
+{
+	// Without the style sheet's index, we can't tell which of our descendants depend on the input.
+	const StyleSheet* style_sheet = GetStyleSheet();
+	const InvalidationMap* invalidation_map = style_sheet != NULL ? style_sheet->GetInvalidationMap() : NULL;
+	if (invalidation_map == NULL)
+	{
+		DirtyChildDefinitions();
+		return element->GetNumChildren(true);
+	}
+
+	if (!invalidation_map->HasDescendantDependencies(input_type, input))
+		return 0;
+
+	int num_dirtied = 0;
+	for (int i = 0; i < element->GetNumChildren(true); i++)
+		num_dirtied += element->GetChild(i)->GetStyle()->DirtyDependentDefinitions(*invalidation_map, input_type, input);
+
+	if (num_dirtied > 0)
+	{
+		for (Element* ancestor = element; ancestor != NULL; ancestor = ancestor->GetParentNode())
+			ancestor->GetStyle()->child_definition_dirty = true;
+	}
+
+	return num_dirtied;
+}
+
+// Marks this element's definition dirty if it may be matched by a rule depending on an input set on one of its
+// ancestors, then does the same for its children.
+int ElementStyle::DirtyDependentDefinitions(const InvalidationMap& invalidation_map, InvalidationMap::SelectorInput input_type, const String& input)
+{
+	// Documents are matched against their own style sheets, so we can't tell which of their elements depend on
+	// the input.
+	if (element->GetOwnerDocument() == element)
+	{
+		DirtyDefinition();
+		return 1;
+	}
+
+	int num_dirtied = 0;
+	if (invalidation_map.IsDescendantDependent(input_type, input, element))
+	{
+		definition_dirty = true;
+		computed_style_dirty = true;
+		element->DirtyUpdate();
+		num_dirtied++;
+	}
+
+	int num_child_dirtied = 0;
+	for (int i = 0; i < element->GetNumChildren(true); i++)
+		num_child_dirtied += element->GetChild(i)->GetStyle()->DirtyDependentDefinitions(invalidation_map, input_type, input);
+
+	if (num_child_dirtied > 0)
+		child_definition_dirty = true;
+
+	return num_dirtied + num_child_dirtied;
+}
+
 // Dirties every property.
 void ElementStyle::DirtyProperties()
 {
-	const PropertyNameList &properties = StyleSheetSpecification::GetRegisteredProperties();
-	DirtyProperties(properties);
+	DirtyProperties(StyleSheetSpecification::GetRegisteredPropertyIds());
 }
 
 // Dirties em-relative properties.
 void ElementStyle::DirtyEmProperties()
 {
-	const PropertyNameList &properties = StyleSheetSpecification::GetRegisteredProperties();
-
-	if (!em_properties)
+	if (!em_properties_valid)
 	{
 		// Check if any of these are currently em-relative. If so, dirty them.
-		em_properties = new PropertyNameList;
-		for (PropertyNameList::const_iterator list_iterator = properties.begin(); list_iterator != properties.end(); ++list_iterator)
+		const PropertyIdSet& properties = StyleSheetSpecification::GetRegisteredPropertyIds();
+
+		em_properties.Clear();
+		for (PropertyId id = properties.First(); id != PROPERTY_INVALID; id = properties.Next(id))
 		{
 			// Skip font-size; this is relative to our parent's em, not ours.
-			if (*list_iterator == FONT_SIZE)
+			if (id == PROPERTY_FONT_SIZE)
 				continue;
 
 			// Get this property from this element. If this is em-relative, then add it to the list to
 			// dirty.
-			if (element->GetProperty(*list_iterator)->unit == Property::EM)
-				em_properties->insert(*list_iterator);
+			if (element->GetProperty(id)->unit == Property::EM)
+				em_properties.Insert(id);
 		}
+
+		em_properties_valid = true;
 	}
 
-	if (!em_properties->empty())
-		DirtyProperties(*em_properties, false);
+	if (!em_properties.Empty())
+		DirtyProperties(em_properties, false);
 
 	// Now dirty all of our descendant's font-size properties that are relative to ems.
 	int num_children = element->GetNumChildren(true);
@@ -568,7 +974,7 @@ void ElementStyle::DirtyEmProperties()
 // Dirties font-size on child elements if appropriate.
 void ElementStyle::DirtyInheritedEmProperties()
 {
-	const Property* font_size = element->GetLocalProperty(FONT_SIZE);
+	const Property* font_size = element->GetLocalProperty(PROPERTY_FONT_SIZE);
 	if (font_size == NULL)
 	{
 		int num_children = element->GetNumChildren(true);
@@ -578,111 +984,246 @@ void ElementStyle::DirtyInheritedEmProperties()
 	else
 	{
 		if (font_size->unit & Property::RELATIVE_UNIT)
-			DirtyProperty(FONT_SIZE);
+			DirtyProperty(PROPERTY_FONT_SIZE);
 	}
 }
 
-// Sets a single property as dirty.
+// Discards everything the element and its descendants have remembered from their ancestors, as the element's parent
+// has changed.
+void ElementStyle::DirtyParent()
+{
+	resolved_lengths.clear();
+
+	em_properties_valid = false;
+	cache->ClearInherited();
+	computed_style_dirty = true;
+
+	// Our descendants only memoise values from above us through our own memoised values, so if we have none then
+	// theirs all belong to elements that are moving with us.
+	if (inherited_values.empty())
+		return;
+
+	inherited_values.clear();
+
+	for (int i = 0; i < element->GetNumChildren(true); i++)
+		element->GetChild(i)->GetStyle()->DirtyParent();
+
+	for (size_t i = 0; i < element->deleted_children.size(); i++)
+	{
+		Element* child = element->deleted_children[i];
+		if (child->GetParentNode() == element)
+			child->GetStyle()->DirtyParent();
+	}
+}
+
+// Sets a single property as dirty. If the name is that of a shorthand, the properties it sets are dirtied instead.
 void ElementStyle::DirtyProperty(const String& property)
 {
-	PropertyNameList properties;
-	properties.insert(String(property));
+	PropertyIdSet properties;
+
+	PropertyId id = StyleSheetSpecification::GetPropertyId(property);
+	if (id != PROPERTY_INVALID)
+		properties.Insert(id);
+	else
+	{
+		const PropertyShorthandDefinition* shorthand = StyleSheetSpecification::GetShorthand(property);
+		if (shorthand != NULL)
+		{
+			for (size_t i = 0; i < shorthand->properties.size(); ++i)
+				properties.Insert(shorthand->properties[i].second->GetId());
+		}
+	}
+
+	DirtyProperties(properties);
+}
+
+// Sets a single registered property as dirty.
+void ElementStyle::DirtyProperty(PropertyId id)
+{
+	PropertyIdSet properties;
+	properties.Insert(id);
 
 	DirtyProperties(properties);
 }
 
-// Sets a list of properties as dirty.
-void ElementStyle::DirtyProperties(const PropertyNameList& properties, bool clear_em_properties)
+// Sets a set of properties as dirty.
+void ElementStyle::DirtyProperties(const PropertyIdSet& properties, bool clear_em_properties)
 {
-	if (properties.empty())
+	if (properties.Empty())
+		return;
+
+	ClearResolvedLengths(properties);
+
+	// While a style update is in progress, only cached values are discarded; dirtying our children and the change
+	// notification wait until the update ends so they happen once for all changes.
+	if (update_depth > 0)
+	{
+		update_dirty_properties |= properties;
+		ClearInheritedValues(properties);
+
+		// A removed property has already been destroyed, so our descendants can't keep their memoised values of it
+		// until the update ends even though they aren't told of the change until then.
+		PropertyIdSet inherited_properties = properties & StyleSheetSpecification::GetRegisteredInheritedPropertyIds();
+		if (!inherited_properties.Empty())
+			ClearChildInheritedValues(inherited_properties);
+
+		cache->Clear();
+		computed_style_dirty = true;
+
+		if (clear_em_properties)
+		{
+			update_clear_em_properties = true;
+			em_properties_valid = false;
+		}
+
 		return;
+	}
 
+	const PropertyIdSet& all_inherited_properties = StyleSheetSpecification::GetRegisteredInheritedPropertyIds();
 	bool all_inherited_dirty = 
-		StyleSheetSpecification::GetRegisteredProperties() == properties ||
-		StyleSheetSpecification::GetRegisteredInheritedProperties() == properties;
+		StyleSheetSpecification::GetRegisteredPropertyIds() == properties ||
+		all_inherited_properties == properties;
 
 	if (all_inherited_dirty)
 	{
-		const PropertyNameList &all_inherited_properties = StyleSheetSpecification::GetRegisteredInheritedProperties();
-		for (int i = 0; i < element->GetNumChildren(true); i++)
-			element->GetChild(i)->GetStyle()->DirtyInheritedProperties(all_inherited_properties);
+		// Discard our memoised inherited values before our children have a chance to pull them down again.
+		inherited_values.clear();
 
-		// Clear all cached properties.
-		cache->Clear();
+		DirtyChildInheritedProperties(all_inherited_properties);
 	}
 	else
 	{
-		PropertyNameList inherited_properties;
-
-		for (PropertyNameList::const_iterator i = properties.begin(); i != properties.end(); ++i)
+		// Pass those properties that are inherited onto our children. While we had a local value our memoised
+		// inherited value wasn't kept up to date, so we have to discard it in case the local value has gone.
+		PropertyIdSet inherited_properties = properties & all_inherited_properties;
+		if (!inherited_properties.Empty())
 		{
-			// If this property is an inherited property, then push it into the list to be passed onto our children.
-			const PropertyDefinition* property = StyleSheetSpecification::GetProperty(*i);
-			if (property != NULL &&
-				property->IsInherited())
-				inherited_properties.insert(*i);
-		}
+			ClearInheritedValues(inherited_properties);
 
-		// Pass the list of those properties that are inherited onto our children.
-		if (!inherited_properties.empty())
-		{
-			for (int i = 0; i < element->GetNumChildren(true); i++)
-				element->GetChild(i)->GetStyle()->DirtyInheritedProperties(inherited_properties);
+			DirtyChildInheritedProperties(inherited_properties);
 		}
-
-		// Clear cached properties.
-		cache->Clear();
 	}
 
+	// Clear cached properties.
+	cache->Clear();
+
 	// clear the list of EM-properties, we will refill it in DirtyEmProperties
-	if (clear_em_properties && em_properties != NULL)
-	{
-		delete em_properties;
-		em_properties = NULL;
-	}
+	if (clear_em_properties)
+		em_properties_valid = false;
+
+	computed_style_dirty = true;
 
 	// And send the event.
 	element->OnPropertyChange(properties);
 }
 
 // Sets a list of our potentially inherited properties as dirtied by an ancestor.
-void ElementStyle::DirtyInheritedProperties(const PropertyNameList& properties)
+void ElementStyle::DirtyInheritedProperties(const PropertyIdSet& properties)
 {
-	bool clear_em_properties = em_properties != NULL;
+	ClearInheritedValues(properties);
 
-	PropertyNameList inherited_properties;
-	for (PropertyNameList::const_iterator i = properties.begin(); i != properties.end(); ++i)
+	// Only those properties that we don't override ourselves have changed. The exception is a relative font size,
+	// which is resolved against our parent's font size and so has changed along with it.
+	PropertyIdSet inherited_properties;
+	for (PropertyId id = properties.First(); id != PROPERTY_INVALID; id = properties.Next(id))
 	{
-		const Property *property = GetLocalProperty((*i));
-		if (property == NULL)
-		{
-			inherited_properties.insert(*i);
-			if (!clear_em_properties && em_properties != NULL && em_properties->find((*i)) != em_properties->end()) {
-				clear_em_properties = true;
-			}
-		}
+		const Property* local_property = GetLocalProperty(id);
+		if (local_property == NULL ||
+			(id == PROPERTY_FONT_SIZE && (local_property->unit & Property::RELATIVE_UNIT)))
+			inherited_properties.Insert(id);
 	}
 
-	if (inherited_properties.empty())
+	if (inherited_properties.Empty())
 		return;
 
+	ClearResolvedLengths(inherited_properties);
+
 	// clear the list of EM-properties, we will refill it in DirtyEmProperties
-	if (clear_em_properties && em_properties != NULL)
-	{
-		delete em_properties;
-		em_properties = NULL;
-	}
+	em_properties_valid = false;
 
 	// Clear cached inherited properties.
 	cache->ClearInherited();
+	computed_style_dirty = true;
 
 	// Pass the list of those properties that this element doesn't override onto our children.
-	for (int i = 0; i < element->GetNumChildren(true); i++)
-		element->GetChild(i)->GetStyle()->DirtyInheritedProperties(inherited_properties);
+	DirtyChildInheritedProperties(inherited_properties);
 
 	element->OnPropertyChange(properties);
 }
 
+// Passes a set of dirtied inherited properties onto our children, including those removed but not yet released.
+void ElementStyle::DirtyChildInheritedProperties(const PropertyIdSet& properties)
+{
+	for (int i = 0; i < element->GetNumChildren(true); i++)
+		element->GetChild(i)->GetStyle()->DirtyInheritedProperties(properties);
+
+	// A removed child still looks up its inherited values through us until it is released, so it can't be left
+	// holding values we may be about to discard. It won't be notified of the change.
+	for (size_t i = 0; i < element->deleted_children.size(); i++)
+	{
+		Element* child = element->deleted_children[i];
+		if (child->GetParentNode() == element)
+			child->GetStyle()->DirtyParent();
+	}
+}
+
+// Discards the memoised values of a set of inherited properties on our descendants that don't define them locally,
+// without notifying them of the change.
+void ElementStyle::ClearChildInheritedValues(const PropertyIdSet& properties)
+{
+	for (int i = 0; i < element->GetNumChildren(true); i++)
+	{
+		ElementStyle* child_style = element->GetChild(i)->GetStyle();
+
+		// As in DirtyParent(), a child without memoised values has no descendants with values from above it.
+		if (child_style->inherited_values.empty())
+			continue;
+
+		PropertyIdSet child_properties;
+		for (PropertyId id = properties.First(); id != PROPERTY_INVALID; id = properties.Next(id))
+		{
+			if (child_style->GetLocalProperty(id) == NULL)
+				child_properties.Insert(id);
+		}
+
+		if (!child_properties.Empty())
+		{
+			child_style->ClearInheritedValues(child_properties);
+			child_style->cache->ClearInherited();
+			child_style->ClearChildInheritedValues(child_properties);
+		}
+	}
+
+	for (size_t i = 0; i < element->deleted_children.size(); i++)
+	{
+		Element* child = element->deleted_children[i];
+		if (child->GetParentNode() == element)
+			child->GetStyle()->DirtyParent();
+	}
+}
+
+// Discards the remembered resolved values of a set of properties.
+void ElementStyle::ClearResolvedLengths(const PropertyIdSet& properties)
+{
+	for (size_t i = 0; i < resolved_lengths.size(); )
+	{
+		if (properties.Contains(resolved_lengths[i].id))
+		{
+			resolved_lengths[i] = resolved_lengths.back();
+			resolved_lengths.pop_back();
+		}
+		else
+			++i;
+	}
+}
+
+// Discards the memoised inherited values of a set of properties.
+void ElementStyle::ClearInheritedValues(const PropertyIdSet& properties)
+{
+	for (PropertyId id = properties.First(); id != PROPERTY_INVALID && id < (int) inherited_values.size(); id = properties.Next(id))
+		inherited_values[id] = NULL;
+}
+
 void ElementStyle::GetBorderWidthProperties(const Property **border_top_width, const Property **border_bottom_width, const Property **border_left_width, const Property **bottom_right_width)
 {
 	cache->GetBorderWidthProperties(border_top_width, border_bottom_width, border_left_width, bottom_right_width);
@@ -753,5 +1294,213 @@ const Property *ElementStyle::GetVerticalAlignProperty()
 	return cache->GetVerticalAlignProperty();
 }
 
+// Returns the element's computed style block.
+const ComputedStyle& ElementStyle::GetComputedStyle()
+{
+	if (computed_style_dirty)
+		UpdateComputedStyle();
+
+	return computed_style;
+}
+
+// Rebuilds the computed style block from the element's properties.
+void ElementStyle::UpdateComputedStyle()
+{
+	computed_style_dirty = false;
+
+	computed_style.margin[Box::TOP] = ComputeLength(GetProperty(PROPERTY_MARGIN_TOP));
+	computed_style.margin[Box::RIGHT] = ComputeLength(GetProperty(PROPERTY_MARGIN_RIGHT));
+	computed_style.margin[Box::BOTTOM] = ComputeLength(GetProperty(PROPERTY_MARGIN_BOTTOM));
+	computed_style.margin[Box::LEFT] = ComputeLength(GetProperty(PROPERTY_MARGIN_LEFT));
+
+	computed_style.padding[Box::TOP] = ComputeLength(GetProperty(PROPERTY_PADDING_TOP));
+	computed_style.padding[Box::RIGHT] = ComputeLength(GetProperty(PROPERTY_PADDING_RIGHT));
+	computed_style.padding[Box::BOTTOM] = ComputeLength(GetProperty(PROPERTY_PADDING_BOTTOM));
+	computed_style.padding[Box::LEFT] = ComputeLength(GetProperty(PROPERTY_PADDING_LEFT));
+
+	computed_style.border_width[Box::TOP] = ComputeLength(GetProperty(PROPERTY_BORDER_TOP_WIDTH));
+	computed_style.border_width[Box::RIGHT] = ComputeLength(GetProperty(PROPERTY_BORDER_RIGHT_WIDTH));
+	computed_style.border_width[Box::BOTTOM] = ComputeLength(GetProperty(PROPERTY_BORDER_BOTTOM_WIDTH));
+	computed_style.border_width[Box::LEFT] = ComputeLength(GetProperty(PROPERTY_BORDER_LEFT_WIDTH));
+
+	computed_style.border_colour[Box::TOP] = GetProperty(PROPERTY_BORDER_TOP_COLOR)->Get< Colourb >();
+	computed_style.border_colour[Box::RIGHT] = GetProperty(PROPERTY_BORDER_RIGHT_COLOR)->Get< Colourb >();
+	computed_style.border_colour[Box::BOTTOM] = GetProperty(PROPERTY_BORDER_BOTTOM_COLOR)->Get< Colourb >();
+	computed_style.border_colour[Box::LEFT] = GetProperty(PROPERTY_BORDER_LEFT_COLOR)->Get< Colourb >();
+
+	computed_style.width = ComputeLength(GetProperty(PROPERTY_WIDTH));
+	computed_style.height = ComputeLength(GetProperty(PROPERTY_HEIGHT));
+
+	// The minimum and maximum dimensions only apply if they have been explicitly set.
+	computed_style.min_width = ComputeLength(GetLocalProperty(PROPERTY_MIN_WIDTH), 0);
+	computed_style.max_width = ComputeLength(GetLocalProperty(PROPERTY_MAX_WIDTH), FLT_MAX);
+	computed_style.min_height = ComputeLength(GetLocalProperty(PROPERTY_MIN_HEIGHT), 0);
+	computed_style.max_height = ComputeLength(GetLocalProperty(PROPERTY_MAX_HEIGHT), FLT_MAX);
+
+	computed_style.display = GetProperty(PROPERTY_DISPLAY)->Get< int >();
+	computed_style.position = GetProperty(PROPERTY_POSITION)->Get< int >();
+	computed_style.float_ = GetProperty(PROPERTY_FLOAT)->Get< int >();
+	computed_style.clear = GetProperty(PROPERTY_CLEAR)->Get< int >();
+	computed_style.overflow_x = GetProperty(PROPERTY_OVERFLOW_X)->Get< int >();
+	computed_style.overflow_y = GetProperty(PROPERTY_OVERFLOW_Y)->Get< int >();
+	computed_style.visibility = GetProperty(PROPERTY_VISIBILITY)->Get< int >();
+
+	const Property* z_index_property = GetProperty(PROPERTY_Z_INDEX);
+	if (z_index_property->unit == Property::KEYWORD)
+	{
+		int z_index_keyword = z_index_property->Get< int >();
+		computed_style.z_index_auto = z_index_keyword == Z_INDEX_AUTO;
+		if (z_index_keyword == Z_INDEX_TOP)
+			computed_style.z_index = FLT_MAX;
+		else if (z_index_keyword == Z_INDEX_BOTTOM)
+			computed_style.z_index = -FLT_MAX;
+		else
+			computed_style.z_index = 0;
+	}
+	else
+	{
+		computed_style.z_index_auto = false;
+		computed_style.z_index = z_index_property->Get< float >();
+	}
+
+	computed_style.colour = GetProperty(PROPERTY_COLOR)->Get< Colourb >();
+	computed_style.background_colour = GetProperty(PROPERTY_BACKGROUND_COLOR)->Get< Colourb >();
+
+	computed_style.font_style = GetProperty(PROPERTY_FONT_STYLE)->Get< int >();
+	computed_style.font_weight = GetProperty(PROPERTY_FONT_WEIGHT)->Get< int >();
+	computed_style.text_align = GetProperty(PROPERTY_TEXT_ALIGN)->Get< int >();
+	computed_style.text_decoration = GetProperty(PROPERTY_TEXT_DECORATION)->Get< int >();
+	computed_style.text_transform = GetProperty(PROPERTY_TEXT_TRANSFORM)->Get< int >();
+	computed_style.white_space = GetProperty(PROPERTY_WHITE_SPACE)->Get< int >();
+}
+
+// Resolves a registered property into pixels.
+float ElementStyle::ResolveLength(PropertyId id, const Property* property, float base_value)
+{
+	if (property->unit & Property::RELATIVE_UNIT)
+	{
+		// The calculated value of the font-size property is inherited, so we need to check if this
+		// is an inherited property. If so, then we return our parent's font size instead.
+		if (id == PROPERTY_FONT_SIZE)
+		{
+			Rocket::Core::Element* parent = element->GetParentNode();
+			if (parent == NULL)
+				return 0;
+
+			if (GetLocalProperty(PROPERTY_FONT_SIZE) == NULL)
+				return parent->ResolveProperty(PROPERTY_FONT_SIZE, 0);
+
+			// The base value for font size is always the height of *this* element's parent's font.
+			base_value = parent->ResolveProperty(PROPERTY_FONT_SIZE, 0);
+		}
+
+		if (property->unit & Property::PERCENT)
+			return base_value * property->value.Get< float >() * 0.01f;
+		else if (property->unit & Property::EM)
+		{
+			// If an em-relative font size is specified, it is expressed relative to the parent's
+			// font height.
+			if (id == PROPERTY_FONT_SIZE)
+				return property->value.Get< float >() * base_value;
+			else
+				return property->value.Get< float >() * ElementUtilities::GetFontSize(element);
+		}
+	}
+
+	if (property->unit & Property::NUMBER || property->unit & Property::PX)
+	{
+		return property->value.Get< float >();
+	}
+    
+    // Values based on pixels-per-inch.
+	if (property->unit & Property::PPI_UNIT)
+	{
+		float inch = property->value.Get< float >() * element->GetRenderInterface()->GetPixelsPerInch();
+
+		if (property->unit & Property::INCH) // inch
+			return inch;
+		if (property->unit & Property::CM) // centimeter
+			return inch / 2.54f;
+		if (property->unit & Property::MM) // millimeter
+			return inch / 25.4f;
+		if (property->unit & Property::PT) // point
+			return inch / 72.0f;
+		if (property->unit & Property::PC) // pica
+			return inch / 6.0f;
+	}
+
+	// We're not a numeric property; return 0.
+	return 0.0f;
+}
+
+// Returns the value a resolved property depends on other than the property itself.
+bool ElementStyle::GetResolvedLengthKey(float& key, PropertyId id, int unit, float base_value) const
+{
+	key = 0;
+
+	// The calculated value of the font size is inherited, so it always depends on the parent's font size if it is
+	// relative, even if it isn't defined locally. We only look at the parent's remembered value rather than
+	// resolving it again; a change to any ancestor's font size discards the remembered font sizes of every
+	// descendant it affects, so if the parent's value is still remembered it is current.
+	if (id == PROPERTY_FONT_SIZE)
+	{
+		if (!(unit & Property::RELATIVE_UNIT))
+			return true;
+
+		Element* parent = element->GetParentNode();
+		if (parent == NULL)
+			return true;
+
+		const ResolvedLengthList& parent_resolved_lengths = parent->GetStyle()->resolved_lengths;
+		for (size_t i = 0; i < parent_resolved_lengths.size(); ++i)
+		{
+			if (parent_resolved_lengths[i].id == PROPERTY_FONT_SIZE)
+			{
+				key = parent_resolved_lengths[i].value;
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	// The element's font size is read from its font face, which is already up to date.
+	if (unit & Property::PERCENT)
+		key = base_value;
+	else if (unit & Property::EM)
+		key = (float) ElementUtilities::GetFontSize(element);
+
+	return true;
+}
+
+// Resolves a length property as far as is possible without knowing the element's containing block.
+ComputedLength ElementStyle::ComputeLength(const Property* property, float default_value)
+{
+	ComputedLength length;
+
+	if (property == NULL)
+	{
+		length.type = ComputedLength::PIXELS;
+		length.value = default_value;
+	}
+	else if (property->unit == Property::KEYWORD)
+	{
+		length.type = ComputedLength::AUTO;
+		length.value = 0;
+	}
+	else if (property->unit & Property::PERCENT)
+	{
+		length.type = ComputedLength::PERCENT;
+		length.value = property->value.Get< float >();
+	}
+	else
+	{
+		length.type = ComputedLength::PIXELS;
+		length.value = ResolveProperty(property, 0);
+	}
+
+	return length;
+}
+
 }
 }
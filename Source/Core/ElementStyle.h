@@ -29,14 +29,17 @@
 #define ROCKETCOREELEMENTSTYLE_H
 
 #include "ElementDefinition.h"
+#include "InvalidationMap.h"
+#include <Rocket/Core/ComputedStyle.h>
 #include <Rocket/Core/Types.h>
 
 namespace Rocket {
 namespace Core {
 
+class AncestorFilter;
+class DefinitionUpdateBatch;
 class ElementStyleCache;
-
-typedef std::map<String, int> PropCounter;
+class StyleSharingCache;
 
 /**
 	Manages an element's style and property information.
@@ -57,6 +60,13 @@ public:
 	/// Update this definition if required
 	void UpdateDefinition();
 
+	/// Checks if this element is guaranteed to match exactly the same style sheet selectors as another element,
+	/// ignoring structural selectors. This is the case if the elements share the same tag, id, classes and
+	/// pseudo-classes, and are either siblings or the children of equivalent siblings.
+	/// @param[in] other The style of the other element.
+	/// @return True if the elements can share a definition if it isn't structurally volatile.
+	bool CanShareDefinition(const ElementStyle& other) const;
+
 	/// Sets or removes a pseudo-class on the element.
 	/// @param[in] pseudo_class The pseudo class to activate or deactivate.
 	/// @param[in] activate True if the pseudo-class is to be activated, false to be deactivated.
@@ -67,6 +77,9 @@ public:
 	bool IsPseudoClassSet(const String& pseudo_class) const;
 	/// Gets a list of the current active pseudo classes
 	const PseudoClassList& GetActivePseudoClasses() const;
+	/// Gets the mask of the current active pseudo classes. Any pseudo-classes that no style sheet refers to, or that
+	/// couldn't be interned, are missing from the mask.
+	PseudoClassMask GetActivePseudoClassMask() const;
 
 	/// Sets or removes a class on the element.
 	/// @param[in] class_name The name of the class to add or remove from the class list.
@@ -82,6 +95,8 @@ public:
 	/// Return the active class list.
 	/// @return A string containing all the classes on the element, separated by spaces.
 	String GetClassNames() const;
+	/// Returns the active class list.
+	const StringList& GetClassNameList() const;
 
 	/// Sets a local property override on the element.
 	/// @param[in] name The name of the new property.
@@ -91,20 +106,44 @@ public:
 	/// @param[in] name The name of the new property.
 	/// @param[in] property The parsed property to set.
 	bool SetProperty(const String& name, const Property& property);
+	/// Sets a number of local property overrides on the element to pre-parsed values; the changes are propagated
+	/// once for the whole set.
+	/// @param[in] properties The parsed properties to set.
+	/// @return True if all properties were set, false if any were not registered.
+	bool SetProperties(const PropertyDictionary& properties);
 	/// Removes a local property override on the element; its value will revert to that defined in
 	/// the style sheet.
 	/// @param[in] name The name of the local property definition to remove.
 	void RemoveProperty(const String& name);
+
+	/// Begins a batch of changes to the element's style. Until the matching call to EndUpdate(), the properties
+	/// changed on the element are collected and only propagated to its descendants and the element itself once
+	/// the batch ends; only the values the descendants have memoised are discarded straight away. Calls may be
+	/// nested.
+	void BeginUpdate();
+	/// Ends a batch of changes begun with BeginUpdate(). When the outermost batch ends, all properties changed
+	/// during it are dirtied together.
+	void EndUpdate();
 	/// Returns one of this element's properties. If this element is not defined this property, or a parent cannot
 	/// be found that we can inherit the property from, the default value will be returned.
 	/// @param[in] name The name of the property to fetch the value for.
 	/// @return The value of this property for this element, or NULL if no property exists with the given name.
 	const Property* GetProperty(const String& name);
+	/// Returns one of this element's registered properties. If this element is not defined this property, or a
+	/// parent cannot be found that we can inherit the property from, the default value will be returned.
+	/// @param[in] id The identifier of the property to fetch the value for.
+	/// @return The value of this property for this element, or NULL if the identifier is invalid.
+	const Property* GetProperty(PropertyId id);
 	/// Returns one of this element's properties. If this element is not defined this property, NULL will be
 	/// returned.
 	/// @param[in] name The name of the property to fetch the value for.
 	/// @return The value of this property for this element, or NULL if this property has not been explicitly defined for this element.
 	const Property* GetLocalProperty(const String& name);
+	/// Returns one of this element's registered properties. If this element is not defined this property, NULL
+	/// will be returned.
+	/// @param[in] id The identifier of the property to fetch the value for.
+	/// @return The value of this property for this element, or NULL if this property has not been explicitly defined for this element.
+	const Property* GetLocalProperty(PropertyId id);
 	/// Resolves one of this element's properties. If the value is a number or px, this is returned. If it's a 
 	/// percentage then it is resolved based on the second argument (the base value).
 	/// @param[in] property Property to resolve the value for.
@@ -117,6 +156,13 @@ public:
 	/// @param[in] base_value The value that is scaled by the percentage value, if it is a percentage.
 	/// @return The value of this property for this element.
 	float ResolveProperty(const String& name, float base_value);
+	/// Resolves one of this element's registered properties. If the value is a number or px, this is returned. If
+	/// it's a percentage then it is resolved based on the second argument (the base value). The resolved value is
+	/// remembered until the property is dirtied, and reused while the font size and base value are unchanged.
+	/// @param[in] id The identifier of the property to resolve the value for.
+	/// @param[in] base_value The value that is scaled by the percentage value, if it is a percentage.
+	/// @return The value of this property for this element.
+	float ResolveProperty(PropertyId id, float base_value);
 
 	/// Iterates over the properties defined on the element.
 	/// @param[inout] index Index of the property to fetch. This is incremented to the next valid index after the fetch. Indices are not necessarily incremental.
@@ -133,6 +179,11 @@ public:
 	void DirtyDefinition();
 	/// Dirty all child definitions
 	void DirtyChildDefinitions();
+	/// Marks the definitions dirty that may change when a class or id is set on or removed from the element; its
+	/// own, and those of the descendants that may be matched by rules depending on it.
+	/// @param[in] input_type The type of the input; either CLASS or ID.
+	/// @param[in] input The name of the class or id.
+	void DirtyDefinition(InvalidationMap::SelectorInput input_type, const String& input);
 
 	// Dirties every property.
 	void DirtyProperties();
@@ -140,6 +191,9 @@ public:
 	void DirtyEmProperties();
 	// Dirties font-size on child elements if appropriate.
 	void DirtyInheritedEmProperties();
+	// Discards everything the element and its descendants have remembered from their ancestors, as the element's
+	// parent has changed.
+	void DirtyParent();
 
 	/// Returns 'border-width' properties from element's style or local cache.
 	void GetBorderWidthProperties(const Property **border_top_width, const Property **border_bottom_width, const Property **border_left_width, const Property **border_right_width);
@@ -172,28 +226,82 @@ public:
 	/// Returns 'vertical-align' property value from element's style or local cache.
 	const Property *GetVerticalAlignProperty();
 
-	static PropCounter &GetPropCounter();
+	/// Returns the element's computed style, rebuilding it first if any of the element's properties have been
+	/// dirtied since it was last built.
+	const ComputedStyle& GetComputedStyle();
 
 private:
-	// Sets a single property as dirty.
+	// Updates this definition if required, sharing definitions with the element's siblings and cousins through
+	// the sharing caches. The ancestor filter must contain all of the element's ancestors. If a batch is given,
+	// elements it has already matched take their matches from it.
+	void UpdateDefinition(StyleSharingCache* sharing_cache, StyleSharingCache* child_sharing_cache, AncestorFilter* ancestor_filter, const DefinitionUpdateBatch* batch);
+	// Adds this element and its descendants that are being updated into a batch to be matched concurrently.
+	void GatherDefinitionUpdates(DefinitionUpdateBatch& batch, int depth);
+	// Marks the definitions of the descendants dirty that may be matched by rules depending on an input set on this
+	// element. Returns the number of definitions dirtied.
+	int DirtyDependentDefinitions(InvalidationMap::SelectorInput input_type, const String& input);
+	// Marks this element's definition dirty if it may be matched by a rule depending on an input set on one of its
+	// ancestors, then does the same for its children. Returns the number of definitions dirtied.
+	int DirtyDependentDefinitions(const InvalidationMap& invalidation_map, InvalidationMap::SelectorInput input_type, const String& input);
+	// Checks if this element has the same tag, id, classes and pseudo-classes as another element.
+	bool HasSameSelectorInputs(const ElementStyle& other) const;
+	// Rebuilds the mask of the active pseudo-classes from their names.
+	void UpdatePseudoClassMask();
+
+	// Sets a single property as dirty, or the properties set by a shorthand.
 	void DirtyProperty(const String& property);
-	// Sets a list of properties as dirty.
-	void DirtyProperties(const PropertyNameList& properties, bool clear_em_properties = true);
-	// Sets a list of our potentially inherited properties as dirtied by an ancestor.
-	void DirtyInheritedProperties(const PropertyNameList& properties);
+	// Sets a single registered property as dirty.
+	void DirtyProperty(PropertyId id);
+	// Sets a set of properties as dirty.
+	void DirtyProperties(const PropertyIdSet& properties, bool clear_em_properties = true);
+	// Sets a set of our potentially inherited properties as dirtied by an ancestor.
+	void DirtyInheritedProperties(const PropertyIdSet& properties);
+	// Passes a set of dirtied inherited properties onto our children, including those removed but not yet released.
+	void DirtyChildInheritedProperties(const PropertyIdSet& properties);
+	// Discards the memoised values of a set of inherited properties on our descendants that don't define them
+	// locally, without notifying them of the change.
+	void ClearChildInheritedValues(const PropertyIdSet& properties);
+	// Discards the remembered resolved values of a set of properties.
+	void ClearResolvedLengths(const PropertyIdSet& properties);
+	// Discards the memoised inherited values of a set of properties.
+	void ClearInheritedValues(const PropertyIdSet& properties);
+
+	// Returns the value of an inherited property that isn't defined locally on this element, from either our
+	// memoised values or our parent.
+	const Property* GetInheritedProperty(PropertyId id, const PropertyDefinition* definition);
+
+	// Resolves a registered property into pixels.
+	float ResolveLength(PropertyId id, const Property* property, float base_value);
+	// Returns the value a resolved property depends on other than the property itself; the element's font size for
+	// em-relative properties, the base value for percentages and the parent's resolved font size for a relative font
+	// size. Returns false if the parent's font size hasn't been resolved, in which case a remembered value can't be
+	// trusted.
+	bool GetResolvedLengthKey(float& key, PropertyId id, int unit, float base_value) const;
+
+	// Rebuilds the computed style block from the element's properties.
+	void UpdateComputedStyle();
+	// Resolves a length property as far as is possible without knowing the element's containing block. If the
+	// property is NULL, the length resolves to the default value in pixels.
+	ComputedLength ComputeLength(const Property* property, float default_value = 0);
 
 	// Element these properties belong to
 	Element* element;
 
 	// The list of classes applicable to this object.
 	StringList classes;
-	// This element's current pseudo-classes.
+	// This element's current pseudo-classes, and their interned mask.
 	PseudoClassList pseudo_classes;
+	PseudoClassMask pseudo_class_mask;
+	// False if some of the pseudo-classes hadn't been interned when they were set, and so may be missing from the
+	// mask after a style sheet referring to them has been loaded.
+	bool pseudo_class_mask_complete;
 
 	// Any properties that have been overridden in this element.
 	PropertyDictionary* local_properties;
-	// All properties (including inherited) that are EM-relative.
-	PropertyNameList* em_properties;
+	// All properties (including inherited) that are EM-relative, if they have been gathered since they were last
+	// dirtied.
+	PropertyIdSet em_properties;
+	bool em_properties_valid;
 	// The definition of this element; if this is NULL one will be fetched from the element's style.
 	ElementDefinition* definition;
 	// Set if a new element definition should be fetched from the style.
@@ -202,6 +310,35 @@ private:
 	bool child_definition_dirty;
 	// cached non-inherited properties
 	ElementStyleCache *cache;
+	// The values of inherited properties not defined locally on this element, indexed by property id; these are
+	// pushed down from our parent on first use and discarded as the ancestors' properties are dirtied.
+	std::vector< const Property* > inherited_values;
+
+	// A registered property resolved into pixels, with the unit it was resolved from and the value it was resolved
+	// against.
+	struct ResolvedLength
+	{
+		PropertyId id;
+		int unit;
+		float key;
+		float value;
+	};
+	typedef std::vector< ResolvedLength > ResolvedLengthList;
+
+	// The properties resolved through ResolveProperty() since they were last dirtied.
+	ResolvedLengthList resolved_lengths;
+
+	// The resolved values of the element's properties.
+	ComputedStyle computed_style;
+	// Set if the computed style needs to be rebuilt before it is next used.
+	bool computed_style_dirty;
+
+	// The depth of nested style updates in progress on the element.
+	int update_depth;
+	// The properties dirtied during the current style update, to be propagated when it ends.
+	PropertyIdSet update_dirty_properties;
+	// Set if the em-relative property list should be rebuilt when the current style update ends.
+	bool update_clear_em_properties;
 };
 
 }
@@ -28,6 +28,7 @@
 #include "precompiled.h"
 #include "ElementStyle.h"
 #include "ElementStyleCache.h"
+#include "StyleStatisticsRecorder.h"
 
 namespace Rocket {
 namespace Core {
@@ -134,111 +135,55 @@ void ElementStyleCache::ClearVerticalAlign()
 void ElementStyleCache::GetBorderWidthProperties(const Property **o_border_top_width, const Property **o_border_bottom_width, const Property **o_border_left_width, const Property **o_border_right_width)
 {
 	if (o_border_top_width)
-	{
-		if (!border_top_width)
-			border_top_width = style->GetProperty(BORDER_TOP_WIDTH);
-		*o_border_top_width = border_top_width;
-	}
+		*o_border_top_width = GetCachedProperty(border_top_width, PROPERTY_BORDER_TOP_WIDTH);
 
 	if (o_border_bottom_width)
-	{
-		if (!border_bottom_width)
-			border_bottom_width = style->GetProperty(BORDER_BOTTOM_WIDTH);
-		*o_border_bottom_width = border_bottom_width;
-	}
+		*o_border_bottom_width = GetCachedProperty(border_bottom_width, PROPERTY_BORDER_BOTTOM_WIDTH);
 
 	if (o_border_left_width)
-	{
-		if (!border_left_width)
-			border_left_width = style->GetProperty(BORDER_LEFT_WIDTH);
-		*o_border_left_width = border_left_width;
-	}
+		*o_border_left_width = GetCachedProperty(border_left_width, PROPERTY_BORDER_LEFT_WIDTH);
 
 	if (o_border_right_width)
-	{
-		if (!border_right_width)
-			border_right_width = style->GetProperty(BORDER_RIGHT_WIDTH);
-		*o_border_right_width = border_right_width;
-	}
+		*o_border_right_width = GetCachedProperty(border_right_width, PROPERTY_BORDER_RIGHT_WIDTH);
 }
 
 void ElementStyleCache::GetMarginProperties(const Property **o_margin_top, const Property **o_margin_bottom, const Property **o_margin_left, const Property **o_margin_right)
 {
 	if (o_margin_top)
-	{
-		if (!margin_top)
-			margin_top = style->GetProperty(MARGIN_TOP);
-		*o_margin_top = margin_top;
-	}
+		*o_margin_top = GetCachedProperty(margin_top, PROPERTY_MARGIN_TOP);
 
 	if (o_margin_bottom)
-	{
-		if (!margin_bottom)
-			margin_bottom = style->GetProperty(MARGIN_BOTTOM);
-		*o_margin_bottom = margin_bottom;
-	}
+		*o_margin_bottom = GetCachedProperty(margin_bottom, PROPERTY_MARGIN_BOTTOM);
 
 	if (o_margin_left)
-	{
-		if (!margin_left)
-			margin_left = style->GetProperty(MARGIN_LEFT);
-		*o_margin_left = margin_left;
-	}
+		*o_margin_left = GetCachedProperty(margin_left, PROPERTY_MARGIN_LEFT);
 
 	if (o_margin_right)
-	{
-		if (!margin_right)
-			margin_right = style->GetProperty(MARGIN_RIGHT);
-		*o_margin_right = margin_right;
-	}
+		*o_margin_right = GetCachedProperty(margin_right, PROPERTY_MARGIN_RIGHT);
 }
 
 void ElementStyleCache::GetPaddingProperties(const Property **o_padding_top, const Property **o_padding_bottom, const Property **o_padding_left, const Property **o_padding_right)
 {
 	if (o_padding_top)
-	{
-		if (!padding_top)
-			padding_top = style->GetProperty(PADDING_TOP);
-		*o_padding_top = padding_top;
-	}
+		*o_padding_top = GetCachedProperty(padding_top, PROPERTY_PADDING_TOP);
 
 	if (o_padding_bottom)
-	{
-		if (!padding_bottom)
-			padding_bottom = style->GetProperty(PADDING_BOTTOM);
-		*o_padding_bottom = padding_bottom;
-	}
+		*o_padding_bottom = GetCachedProperty(padding_bottom, PROPERTY_PADDING_BOTTOM);
 
 	if (o_padding_left)
-	{
-		if (!padding_left)
-			padding_left = style->GetProperty(PADDING_LEFT);
-		*o_padding_left = padding_left;
-	}
+		*o_padding_left = GetCachedProperty(padding_left, PROPERTY_PADDING_LEFT);
 
 	if (o_padding_right)
-	{
-		if (!padding_right)
-			padding_right = style->GetProperty(PADDING_RIGHT);
-		*o_padding_right = padding_right;
-	}
+		*o_padding_right = GetCachedProperty(padding_right, PROPERTY_PADDING_RIGHT);
 }
 
 void ElementStyleCache::GetDimensionProperties(const Property **o_width, const Property **o_height)
 {
 	if (o_width)
-	{
-		if (!width)
-			width = style->GetProperty(WIDTH);
-		*o_width = width;
-	}
+		*o_width = GetCachedProperty(width, PROPERTY_WIDTH);
 
 	if (o_height)
-	{
-		if (!height)
-			height = style->GetProperty(HEIGHT);
-		*o_height = height;
-	}
+		*o_height = GetCachedProperty(height, PROPERTY_HEIGHT);
 }
 
 void ElementStyleCache::GetLocalDimensionProperties(const Property **o_width, const Property **o_height)
@@ -247,9 +192,12 @@ void ElementStyleCache::GetLocalDimensionProperties(const Property **o_width, co
 	{
 		if (!have_local_width)
 		{
+			ROCKET_STYLE_STATISTIC(OnCacheMiss());
 			have_local_width = true;
-			local_width = style->GetLocalProperty(WIDTH);
+			local_width = style->GetLocalProperty(PROPERTY_WIDTH);
 		}
+		else
+			ROCKET_STYLE_STATISTIC(OnCacheHit());
 		*o_width = local_width;
 	}
 
@@ -257,9 +205,12 @@ void ElementStyleCache::GetLocalDimensionProperties(const Property **o_width, co
 	{
 		if (!have_local_height)
 		{
+			ROCKET_STYLE_STATISTIC(OnCacheMiss());
 			have_local_height = true;
-			local_height = style->GetLocalProperty(HEIGHT);
+			local_height = style->GetLocalProperty(PROPERTY_HEIGHT);
 		}
+		else
+			ROCKET_STYLE_STATISTIC(OnCacheHit());
 		*o_height = local_height;
 	}
 }
@@ -267,74 +218,78 @@ void ElementStyleCache::GetLocalDimensionProperties(const Property **o_width, co
 void ElementStyleCache::GetOverflow(int *o_overflow_x, int *o_overflow_y)
 {
 	if (o_overflow_x)
-	{
-		if (overflow_x < 0)
-			overflow_x = style->GetProperty(OVERFLOW_X)->Get< int >();
-		*o_overflow_x = overflow_x;
-	}
+		*o_overflow_x = GetCachedKeyword(overflow_x, PROPERTY_OVERFLOW_X);
 
 	if (o_overflow_y)
-	{
-		if (overflow_y < 0)
-			overflow_y = style->GetProperty(OVERFLOW_Y)->Get< int >();
-		*o_overflow_y = overflow_y;
-	}
+		*o_overflow_y = GetCachedKeyword(overflow_y, PROPERTY_OVERFLOW_Y);
 }
 
 int ElementStyleCache::GetPosition()
 {
-	if (position < 0)
-		position = style->GetProperty(POSITION)->Get< int >();
-	return position;
+	return GetCachedKeyword(position, PROPERTY_POSITION);
 }
 
 int ElementStyleCache::GetFloat()
 {
-	if (float_ < 0)
-		float_ = style->GetProperty(FLOAT)->Get< int >();
-	return float_;
+	return GetCachedKeyword(float_, PROPERTY_FLOAT);
 }
 
 int ElementStyleCache::GetDisplay()
 {
-	if (display < 0)
-		display = style->GetProperty(DISPLAY)->Get< int >();
-	return display;
+	return GetCachedKeyword(display, PROPERTY_DISPLAY);
 }
 
 int ElementStyleCache::GetWhitespace()
 {
-	if (whitespace < 0)
-		whitespace = style->GetProperty(WHITE_SPACE)->Get< int >();
-	return whitespace;
+	return GetCachedKeyword(whitespace, PROPERTY_WHITE_SPACE);
 }
 
 const Property *ElementStyleCache::GetLineHeightProperty()
 {
-	if (!line_height)
-		line_height = style->GetProperty(LINE_HEIGHT);
-	return line_height;
+	return GetCachedProperty(line_height, PROPERTY_LINE_HEIGHT);
 }
 
 int ElementStyleCache::GetTextAlign()
 {
-	if (text_align < 0)
-		text_align = style->GetProperty(TEXT_ALIGN)->Get< int >();
-	return text_align;
+	return GetCachedKeyword(text_align, PROPERTY_TEXT_ALIGN);
 }
 
 int ElementStyleCache::GetTextTransform()
 {
-	if (text_transform < 0)
-		text_transform = style->GetProperty(TEXT_TRANSFORM)->Get< int >();
-	return text_transform;
+	return GetCachedKeyword(text_transform, PROPERTY_TEXT_TRANSFORM);
 }
 
 const Property *ElementStyleCache::GetVerticalAlignProperty()
 {
-	if (!vertical_align)
-		vertical_align = style->GetProperty(VERTICAL_ALIGN);
-	return vertical_align;
+	return GetCachedProperty(vertical_align, PROPERTY_VERTICAL_ALIGN);
+}
+
+// Returns a cached property, resolving it through the style if it has been invalidated.
+const Property* ElementStyleCache::GetCachedProperty(const Property*& cached_property, PropertyId id)
+{
+	if (!cached_property)
+	{
+		ROCKET_STYLE_STATISTIC(OnCacheMiss());
+		cached_property = style->GetProperty(id);
+	}
+	else
+		ROCKET_STYLE_STATISTIC(OnCacheHit());
+
+	return cached_property;
+}
+
+// Returns a cached keyword value, resolving it through the style if it has been invalidated.
+int ElementStyleCache::GetCachedKeyword(int& cached_keyword, PropertyId id)
+{
+	if (cached_keyword < 0)
+	{
+		ROCKET_STYLE_STATISTIC(OnCacheMiss());
+		cached_keyword = style->GetProperty(id)->Get< int >();
+	}
+	else
+		ROCKET_STYLE_STATISTIC(OnCacheHit());
+
+	return cached_keyword;
 }
 
 }
@@ -103,6 +103,11 @@ public:
 	const Property *GetVerticalAlignProperty();
 
 private:
+	/// Returns a cached property, resolving it through the style if it has been invalidated.
+	const Property* GetCachedProperty(const Property*& cached_property, PropertyId id);
+	/// Returns a cached keyword value, resolving it through the style if it has been invalidated.
+	int GetCachedKeyword(int& cached_keyword, PropertyId id);
+
 	/// Element style that owns this cache instance.
 	ElementStyle *style;
 
@@ -51,6 +51,7 @@ ElementTextDefault::ElementTextDefault(const String& tag) : ElementText(tag), co
 	decoration_property = TEXT_DECORATION_NONE;
 
 	geometry_dirty = true;
+	lines_dirty = false;
 
 	font_configuration = -1;
 	font_dirty = true;
@@ -91,10 +92,27 @@ void ElementTextDefault::OnRender()
 		geometry_dirty = true;
 	}
 
+	// If our lines were formatted concurrently, their geometry and decoration haven't been generated yet.
+	bool decoration_dirty = false;
+	if (lines_dirty)
+	{
+		lines_dirty = false;
+		geometry_dirty = true;
+
+		decoration.Release(true);
+		decoration_dirty = decoration_property != TEXT_DECORATION_NONE;
+	}
+
 	// Regenerate the geometry if the colour or font configuration has altered.
 	if (geometry_dirty)
 		GenerateGeometry(font_face_handle);
 
+	if (decoration_dirty)
+	{
+		for (size_t i = 0; i < lines.size(); ++i)
+			GenerateDecoration(font_face_handle, lines[i]);
+	}
+
 	Vector2f translation = GetAbsoluteOffset();
 	
 	bool render = true;
@@ -242,6 +260,15 @@ bool ElementTextDefault::GenerateLine(WString& line, int& line_length, float& li
 // Clears all lines of generated text and prepares the element for generating new lines.
 void ElementTextDefault::ClearLines()
 {
+	// While our document is formatted concurrently, our geometry can't be released through the render interface, so
+	// it is regenerated along with our new lines when we're next rendered.
+	if (IsLayoutDeferred())
+	{
+		lines.clear();
+		lines_dirty = true;
+		return;
+	}
+
 	// Clear the rendering information.
 	for (size_t i = 0; i < geometry.size(); ++i)
 		geometry[i].Release(true);
@@ -258,12 +285,20 @@ void ElementTextDefault::AddLine(const Vector2f& line_position, const WString& l
 	if (font_face_handle == NULL)
 		return;
 
-	if (font_dirty)
-		UpdateFontConfiguration();
-
 	Vector2f baseline_position = line_position + Vector2f(0.0f, (float) font_face_handle->GetLineHeight() - font_face_handle->GetBaseline());
 	lines.push_back(Line(line, baseline_position));
 
+	// Our font configuration is generated on the shared font face handle, and our geometry is registered globally, so
+	// while our document is formatted concurrently both are left until we're next rendered.
+	if (IsLayoutDeferred())
+	{
+		lines_dirty = true;
+		return;
+	}
+
+	if (font_dirty)
+		UpdateFontConfiguration();
+
 	GenerateGeometry(font_face_handle, lines.back());
 	geometry_dirty = false;
 
@@ -277,27 +312,27 @@ void ElementTextDefault::SuppressAutoLayout()
 	dirty_layout_on_change = false;
 }
 
-void ElementTextDefault::OnPropertyChange(const PropertyNameList& changed_properties)
+void ElementTextDefault::OnPropertyChange(const PropertyIdSet& changed_properties)
 {
 	Element::OnPropertyChange(changed_properties);
 
 	bool colour_changed = false;
 	bool font_face_changed = false;
 
-	if (changed_properties.find(COLOR) != changed_properties.end())
+	if (changed_properties.Contains(PROPERTY_COLOR))
 	{
 		// Fetch our (potentially) new colour.
-		Colourb new_colour = GetProperty(COLOR)->value.Get< Colourb >();
+		Colourb new_colour = GetComputedStyle().colour;
 		colour_changed = colour != new_colour;
 		if (colour_changed)
 			colour = new_colour;
 	}
 
-	if (changed_properties.find(FONT_FAMILY) != changed_properties.end() ||
-		changed_properties.find(FONT_CHARSET) != changed_properties.end() ||
-		changed_properties.find(FONT_WEIGHT) != changed_properties.end() ||
-		changed_properties.find(FONT_STYLE) != changed_properties.end() ||
-		changed_properties.find(FONT_SIZE) != changed_properties.end())
+	if (changed_properties.Contains(PROPERTY_FONT_FAMILY) ||
+		changed_properties.Contains(PROPERTY_FONT_CHARSET) ||
+		changed_properties.Contains(PROPERTY_FONT_WEIGHT) ||
+		changed_properties.Contains(PROPERTY_FONT_STYLE) ||
+		changed_properties.Contains(PROPERTY_FONT_SIZE))
 	{
 		font_face_changed = true;
 
@@ -305,9 +340,9 @@ void ElementTextDefault::OnPropertyChange(const PropertyNameList& changed_proper
 		font_dirty = true;
 	}
 
-	if (changed_properties.find(TEXT_DECORATION) != changed_properties.end())
+	if (changed_properties.Contains(PROPERTY_TEXT_DECORATION))
 	{
-		decoration_property = GetProperty< int >(TEXT_DECORATION);
+		decoration_property = GetComputedStyle().text_decoration;
 		if (decoration_property != TEXT_DECORATION_NONE)
 		{
 			if (decoration_property != generated_decoration)
@@ -373,7 +408,7 @@ bool ElementTextDefault::UpdateFontConfiguration()
 	{
 		const ElementDefinition* element_definition = element->GetDefinition();
 		if (element_definition != NULL)
-			element_definition->GetFontEffects(font_effects, element->GetStyle()->GetActivePseudoClasses());
+			element_definition->GetFontEffects(font_effects, element->GetStyle()->GetActivePseudoClasses(), element->GetStyle()->GetActivePseudoClassMask());
 
 		element = element->GetParentNode();
 	}
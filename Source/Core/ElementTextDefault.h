@@ -77,7 +77,7 @@ public:
 	virtual void SuppressAutoLayout();
 
 protected:
-	virtual void OnPropertyChange(const PropertyNameList& properties);
+	virtual void OnPropertyChange(const PropertyIdSet& properties);
 
 	/// Returns the RML of this element
 	/// @param content[out] The raw text.
@@ -120,6 +120,8 @@ private:
 
 	GeometryList geometry;
 	bool geometry_dirty;
+	// True if lines have been added or cleared without their geometry being updated.
+	bool lines_dirty;
 
 	Colourb colour;
 
@@ -113,11 +113,11 @@ void ElementUtilities::GetElementsByClassName(ElementList& elements, Element* ro
 FontFaceHandle* ElementUtilities::GetFontFaceHandle(Element* element)
 {
 	// Fetch the new font face.
-	String font_family = element->GetProperty(FONT_FAMILY)->value.Get< String >();
-	String font_charset = element->GetProperty(FONT_CHARSET)->value.Get< String >();
-	Font::Style font_style = (Font::Style) element->GetProperty(FONT_STYLE)->value.Get< int >();
-	Font::Weight font_weight = (Font::Weight) element->GetProperty(FONT_WEIGHT)->value.Get< int >();
-	int font_size = Math::RealToInteger(element->ResolveProperty(FONT_SIZE, 0));
+	String font_family = element->GetProperty(PROPERTY_FONT_FAMILY)->value.Get< String >();
+	String font_charset = element->GetProperty(PROPERTY_FONT_CHARSET)->value.Get< String >();
+	Font::Style font_style = (Font::Style) element->GetProperty(PROPERTY_FONT_STYLE)->value.Get< int >();
+	Font::Weight font_weight = (Font::Weight) element->GetProperty(PROPERTY_FONT_WEIGHT)->value.Get< int >();
+	int font_size = Math::RealToInteger(element->ResolveProperty(PROPERTY_FONT_SIZE, 0));
 
 	FontFaceHandle* font = FontDatabase::GetFontFaceHandle(font_family, font_charset, font_style, font_weight, font_size);
 	return font;
@@ -367,7 +367,7 @@ Decorator* Factory::InstanceDecorator(const String& name, const PropertyDictiona
 		if ((*i).first == Z_INDEX)
 			z_index = (*i).second.value.Get< float >();
 		else
-			property_specification.ParsePropertyDeclaration(parsed_properties, (*i).first, (*i).second.value.Get< String >(), (*i).second.source, (*i).second.source_line_number);
+			property_specification.ParsePropertyDeclaration(parsed_properties, (*i).first, (*i).second.value.Get< String >(), (*i).second.GetSource(), (*i).second.GetSourceLineNumber());
 	}
 
 	// Set the property defaults for all unset properties.
@@ -442,7 +442,7 @@ FontEffect* Factory::InstanceFontEffect(const String& name, const PropertyDictio
 		}
 		else
 		{
-			property_specification.ParsePropertyDeclaration(parsed_properties, (*i).first, (*i).second.value.Get< String >(), (*i).second.source, (*i).second.source_line_number);
+			property_specification.ParsePropertyDeclaration(parsed_properties, (*i).first, (*i).second.value.Get< String >(), (*i).second.GetSource(), (*i).second.GetSourceLineNumber());
 		}
 	}
 
@@ -44,7 +44,10 @@ public:
 	}
 };
 
-FontFaceHandle::FontFaceHandle()
+// The number of sets of entries in each handle's string width cache.
+static const size_t STRING_WIDTH_CACHE_SETS = 128;
+
+FontFaceHandle::FontFaceHandle() : string_width_cache(STRING_WIDTH_CACHE_SETS)
 {
 	size = 0;
 	average_advance = 0;
@@ -149,6 +152,22 @@ const FontGlyphList& FontFaceHandle::GetGlyphs() const
 
 // Returns the width a string will take up if rendered with this handle.
 int FontFaceHandle::GetStringWidth(const WString& string, word prior_character) const
+{
+	if (!FontStringWidthCache::IsCacheable(string))
+		return CalculateStringWidth(string, prior_character);
+
+	int width;
+	if (!string_width_cache.Find(width, string, prior_character))
+	{
+		width = CalculateStringWidth(string, prior_character);
+		string_width_cache.Insert(string, prior_character, width);
+	}
+
+	return width;
+}
+
+// Measures a string glyph-by-glyph.
+int FontFaceHandle::CalculateStringWidth(const WString& string, word prior_character) const
 {
 	int width = 0;
 
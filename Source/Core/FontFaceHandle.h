@@ -30,6 +30,7 @@
 
 #include <Rocket/Core/ReferenceCountable.h>
 #include "UnicodeRange.h"
+#include "FontStringWidthCache.h"
 #include <Rocket/Core/Font.h>
 #include <Rocket/Core/FontEffect.h>
 #include <Rocket/Core/FontGlyph.h>
@@ -135,6 +136,9 @@ private:
 	void BuildKerning(FT_Face ft_face);
 	int GetKerning(word lhs, word rhs) const;
 
+	// Measures a string glyph-by-glyph.
+	int CalculateStringWidth(const WString& string, word prior_character) const;
+
 	// Generates (or shares) a layer derived from a font effect.
 	FontFaceLayer* GenerateLayer(FontEffect* font_effect);
 
@@ -144,6 +148,9 @@ private:
 	FontGlyphList glyphs;
 	FontKerningList kerning;
 
+	// The widths of recently measured strings.
+	mutable FontStringWidthCache string_width_cache;
+
 	typedef std::map< const FontEffect*, FontFaceLayer* > FontLayerMap;
 	typedef std::map< String, FontFaceLayer* > FontLayerCache;
 	typedef std::vector< FontFaceLayer* > LayerConfiguration;
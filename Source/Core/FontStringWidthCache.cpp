@@ -0,0 +1,189 @@
+/*
+ * This source file is part of libRocket, the HTML/CSS Interface Middleware
+ *
+ * For the latest information, see http://www.librocket.com
+ *
+ * Copyright (c) 2008-2010 CodePoint Ltd, Shift Technology Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+#include "precompiled.h"
+#include "FontStringWidthCache.h"
+#include "AtomicCounter.h"
+
+namespace Rocket {
+namespace Core {
+
+// The number of entries in each set.
+static const size_t SET_SIZE = 4;
+// The length of the longest string that will be cached. This bounds the memory held by each cache.
+static const size_t MAX_STRING_LENGTH = 32;
+
+// The number of widths that can be held back while the caches are read-only; any more are measured again later.
+static const unsigned int MAX_PENDING_ENTRIES = 4096;
+
+// True while the caches are shared between threads.
+static bool read_only = false;
+
+// A width measured while the caches were read-only, waiting to be added to its cache.
+struct PendingEntry
+{
+	FontStringWidthCache* cache;
+	WString string;
+	word prior_character;
+	int width;
+};
+
+// The held back widths. Each thread claims the next slot by incrementing the count, so the slots are filled without
+// locking; the entries are only read once the threads have finished.
+static std::vector< PendingEntry > pending_entries;
+static volatile unsigned int num_pending_entries = 0;
+
+FontStringWidthCache::FontStringWidthCache(size_t num_sets) : entries(num_sets * SET_SIZE)
+{
+	ROCKET_ASSERT(num_sets > 0 && (num_sets & (num_sets - 1)) == 0);
+	set_mask = (Hash) (num_sets - 1);
+	clock = 0;
+}
+
+FontStringWidthCache::~FontStringWidthCache()
+{
+}
+
+// Returns true if a string is short enough to be cached.
+bool FontStringWidthCache::IsCacheable(const WString& string)
+{
+	return string.Length() <= MAX_STRING_LENGTH;
+}
+
+// Sets whether all caches are read-only.
+void FontStringWidthCache::SetReadOnly(bool _read_only)
+{
+	bool was_read_only = read_only;
+	read_only = _read_only;
+
+	if (read_only)
+	{
+		if (pending_entries.empty())
+			pending_entries.resize(MAX_PENDING_ENTRIES);
+	}
+	else if (was_read_only)
+	{
+		// Add the widths measured while we were read-only. Several threads may have measured the same string.
+		unsigned int num_entries = Math::Min(num_pending_entries, MAX_PENDING_ENTRIES);
+		for (unsigned int i = 0; i < num_entries; ++i)
+		{
+			PendingEntry& entry = pending_entries[i];
+
+			int width;
+			if (!entry.cache->Find(width, entry.string, entry.prior_character))
+				entry.cache->Insert(entry.string, entry.prior_character, entry.width);
+		}
+
+		num_pending_entries = 0;
+	}
+}
+
+// Looks up the width of a string, marking it as recently used.
+bool FontStringWidthCache::Find(int& width, const WString& string, word prior_character)
+{
+	Hash hash = GetHash(string, prior_character);
+	Entry* set = &entries[(hash & set_mask) * SET_SIZE];
+
+	for (size_t i = 0; i < SET_SIZE; ++i)
+	{
+		if (set[i].last_used != 0 &&
+			set[i].hash == hash &&
+			set[i].prior_character == prior_character &&
+			set[i].string.Length() == string.Length() &&
+			memcmp(set[i].string.CString(), string.CString(), string.Length() * sizeof(word)) == 0)
+		{
+			// The strings are compared by their characters, as comparing them directly could calculate and store the
+			// cached string's hash.
+			if (!read_only)
+				set[i].last_used = Tick();
+			width = set[i].width;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// Adds the width of a string to the cache.
+void FontStringWidthCache::Insert(const WString& string, word prior_character, int width)
+{
+	if (read_only)
+	{
+		unsigned int index = AtomicAdd(num_pending_entries, 1);
+		if (index < MAX_PENDING_ENTRIES)
+		{
+			PendingEntry& entry = pending_entries[index];
+			entry.cache = this;
+			entry.string = string;
+			entry.prior_character = prior_character;
+			entry.width = width;
+		}
+
+		return;
+	}
+
+	Hash hash = GetHash(string, prior_character);
+	Entry* set = &entries[(hash & set_mask) * SET_SIZE];
+
+	// Replace the least-recently-used entry in the set; empty entries will be picked first.
+	Entry* entry = &set[0];
+	for (size_t i = 1; i < SET_SIZE; ++i)
+	{
+		if (set[i].last_used < entry->last_used)
+			entry = &set[i];
+	}
+
+	entry->hash = hash;
+	entry->string = string;
+	entry->prior_character = prior_character;
+	entry->width = width;
+	entry->last_used = Tick();
+}
+
+// Advances the clock used to order entries by their use.
+unsigned int FontStringWidthCache::Tick()
+{
+	// If the clock wraps around, the cache is emptied rather than let the order of its entries become meaningless.
+	if (++clock == 0)
+	{
+		for (EntryList::iterator i = entries.begin(); i != entries.end(); ++i)
+			(*i).last_used = 0;
+
+		clock = 1;
+	}
+
+	return clock;
+}
+
+Hash FontStringWidthCache::GetHash(const WString& string, word prior_character)
+{
+	return string.Hash() * 31 + prior_character;
+}
+
+}
+}
@@ -0,0 +1,104 @@
+/*
+ * This source file is part of libRocket, the HTML/CSS Interface Middleware
+ *
+ * For the latest information, see http://www.librocket.com
+ *
+ * Copyright (c) 2008-2010 CodePoint Ltd, Shift Technology Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+#ifndef ROCKETCOREFONTSTRINGWIDTHCACHE_H
+#define ROCKETCOREFONTSTRINGWIDTHCACHE_H
+
+#include <Rocket/Core/String.h>
+#include <vector>
+
+namespace Rocket {
+namespace Core {
+
+/**
+	A bounded cache of the widths of strings measured by a font face handle, keyed on the string and the character
+	preceding it. Text is measured word-by-word every time it is formatted, so the same words are measured over and
+	over again.
+
+	Entries are grouped into small sets by their hash; when a set is full, its least-recently-used entry is replaced.
+ */
+
+class FontStringWidthCache
+{
+public:
+	/// Constructs the cache.
+	/// @param[in] num_sets The number of sets of entries in the cache; this must be a power of two.
+	FontStringWidthCache(size_t num_sets);
+	~FontStringWidthCache();
+
+	/// Returns true if a string is short enough to be cached.
+	/// @param[in] string The string to check.
+	/// @return True if the string can be cached, false if not.
+	static bool IsCacheable(const WString& string);
+	/// Sets whether all caches are read-only. While read-only, lookups don't modify the caches and insertions are
+	/// held back, so the caches can be shared between threads formatting text concurrently. The held back widths
+	/// are added to their caches when they are made writable again.
+	/// @param[in] read_only True to make the caches read-only, false to allow them to be updated again.
+	static void SetReadOnly(bool read_only);
+
+	/// Looks up the width of a string, marking it as recently used unless the caches are read-only.
+	/// @param[out] width The width of the string, if it is cached.
+	/// @param[in] string The measured string.
+	/// @param[in] prior_character The character preceding the string.
+	/// @return True if the width was cached, false if not.
+	bool Find(int& width, const WString& string, word prior_character);
+	/// Adds the width of a string to the cache, or holds it back until the caches are writable again.
+	/// @param[in] string The measured string.
+	/// @param[in] prior_character The character preceding the string.
+	/// @param[in] width The width of the string.
+	void Insert(const WString& string, word prior_character, int width);
+
+private:
+	struct Entry
+	{
+		Entry() : hash(0), prior_character(0), width(0), last_used(0) {}
+
+		Hash hash;
+		WString string;
+		word prior_character;
+		int width;
+		// The value of the cache's clock when the entry was last used, or zero if the entry is empty.
+		unsigned int last_used;
+	};
+
+	typedef std::vector< Entry > EntryList;
+
+	static Hash GetHash(const WString& string, word prior_character);
+	unsigned int Tick();
+
+	// The entries, in consecutive sets of SET_SIZE.
+	EntryList entries;
+	Hash set_mask;
+	// Incremented on every lookup and insertion.
+	unsigned int clock;
+};
+
+}
+}
+
+#endif
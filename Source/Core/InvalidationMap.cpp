@@ -0,0 +1,106 @@
+/*
+ * This source file is part of libRocket, the HTML/CSS Interface Middleware
+ *
+ * For the latest information, see http://www.librocket.com
+ *
+ * Copyright (c) 2008-2010 CodePoint Ltd, Shift Technology Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+#include "precompiled.h"
+#include "InvalidationMap.h"
+#include <Rocket/Core/Element.h>
+
+namespace Rocket {
+namespace Core {
+
+InvalidationMap::Dependents::Dependents()
+{
+	universal = false;
+}
+
+InvalidationMap::InvalidationMap()
+{
+}
+
+InvalidationMap::~InvalidationMap()
+{
+}
+
+// Records that a rule depends on an input being set on one of its subject's ancestors.
+void InvalidationMap::AddDependency(SelectorInput input_type, const String& input, SubjectKey subject_key_type, const String& subject_key)
+{
+	Dependents& input_dependents = dependents[input_type][input];
+
+	if (subject_key_type == SUBJECT_TAG &&
+		subject_key.Empty())
+		input_dependents.universal = true;
+	else
+		input_dependents.subject_keys[subject_key_type].insert(subject_key);
+}
+
+// Removes all dependencies.
+void InvalidationMap::Clear()
+{
+	for (int i = 0; i < NUM_SELECTOR_INPUTS; ++i)
+		dependents[i].clear();
+}
+
+// Returns true if any rule depends on an input being set on one of its subject's ancestors.
+bool InvalidationMap::HasDescendantDependencies(SelectorInput input_type, const String& input) const
+{
+	return dependents[input_type].find(input) != dependents[input_type].end();
+}
+
+// Returns true if an element may be the subject of a rule depending on an input being set on one of its ancestors.
+bool InvalidationMap::IsDescendantDependent(SelectorInput input_type, const String& input, const Element* element) const
+{
+	DependentMap::const_iterator iterator = dependents[input_type].find(input);
+	if (iterator == dependents[input_type].end())
+		return false;
+
+	const Dependents& input_dependents = (*iterator).second;
+	if (input_dependents.universal)
+		return true;
+
+	if (input_dependents.subject_keys[SUBJECT_TAG].find(element->GetTagName()) != input_dependents.subject_keys[SUBJECT_TAG].end())
+		return true;
+
+	if (!element->GetId().Empty() &&
+		input_dependents.subject_keys[SUBJECT_ID].find(element->GetId()) != input_dependents.subject_keys[SUBJECT_ID].end())
+		return true;
+
+	if (!input_dependents.subject_keys[SUBJECT_CLASS].empty())
+	{
+		const StringList& class_names = element->GetClassNameList();
+		for (size_t i = 0; i < class_names.size(); ++i)
+		{
+			if (input_dependents.subject_keys[SUBJECT_CLASS].find(class_names[i]) != input_dependents.subject_keys[SUBJECT_CLASS].end())
+				return true;
+		}
+	}
+
+	return false;
+}
+
+}
+}
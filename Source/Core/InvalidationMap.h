@@ -0,0 +1,102 @@
+/*
+ * This source file is part of libRocket, the HTML/CSS Interface Middleware
+ *
+ * For the latest information, see http://www.librocket.com
+ *
+ * Copyright (c) 2008-2010 CodePoint Ltd, Shift Technology Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+#ifndef ROCKETCOREINVALIDATIONMAP_H
+#define ROCKETCOREINVALIDATIONMAP_H
+
+#include <Rocket/Core/String.h>
+#include <set>
+
+namespace Rocket {
+namespace Core {
+
+class Element;
+
+/**
+	Records which of a style sheet's rules depend on a class, id or pseudo-class being set on one of the subject's
+	ancestors. When one of these inputs changes on an element, only the descendants that may be the subject of such a
+	rule need to have their definitions updated.
+
+	The subjects of the rules are identified by their index keys; their right-most id, class or tag.
+ */
+
+class InvalidationMap
+{
+public:
+	enum SelectorInput
+	{
+		CLASS = 0,
+		ID,
+		PSEUDO_CLASS,
+		NUM_SELECTOR_INPUTS
+	};
+
+	enum SubjectKey
+	{
+		SUBJECT_TAG = 0,
+		SUBJECT_CLASS,
+		SUBJECT_ID,
+		NUM_SUBJECT_KEYS
+	};
+
+	InvalidationMap();
+	~InvalidationMap();
+
+	/// Records that a rule depends on an input being set on one of its subject's ancestors.
+	/// @param[in] input_type The type of the input.
+	/// @param[in] input The name of the class, id or pseudo-class.
+	/// @param[in] subject_key_type The type of the rule's index key.
+	/// @param[in] subject_key The rule's index key; an empty tag for a rule indexed under the universal selector.
+	void AddDependency(SelectorInput input_type, const String& input, SubjectKey subject_key_type, const String& subject_key);
+	/// Removes all dependencies.
+	void Clear();
+
+	/// Returns true if any rule depends on an input being set on one of its subject's ancestors.
+	bool HasDescendantDependencies(SelectorInput input_type, const String& input) const;
+	/// Returns true if an element may be the subject of a rule depending on an input being set on one of its
+	/// ancestors.
+	bool IsDescendantDependent(SelectorInput input_type, const String& input, const Element* element) const;
+
+private:
+	struct Dependents
+	{
+		Dependents();
+
+		std::set< String > subject_keys[NUM_SUBJECT_KEYS];
+		// True if a rule indexed under the universal selector depends on the input, so any element may change.
+		bool universal;
+	};
+
+	typedef std::map< String, Dependents > DependentMap;
+	DependentMap dependents[NUM_SELECTOR_INPUTS];
+};
+
+}
+}
+
+#endif
@@ -0,0 +1,125 @@
+/*
+ * This source file is part of libRocket, the HTML/CSS Interface Middleware
+ *
+ * For the latest information, see http://www.librocket.com
+ *
+ * Copyright (c) 2008-2010 CodePoint Ltd, Shift Technology Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+#include "precompiled.h"
+#include "LayoutArena.h"
+
+namespace Rocket {
+namespace Core {
+
+// The granularity of the size classes, in bytes.
+static const size_t SIZE_CLASS_GRANULARITY = 16;
+// The number of size classes. Chunks bigger than the largest class are allocated individually.
+static const size_t NUM_SIZE_CLASSES = 32;
+// The size of the blocks chunks are carved from.
+static const size_t BLOCK_SIZE = 4096;
+
+LayoutArena::LayoutArena() : free_chunks(NUM_SIZE_CLASSES, NULL)
+{
+	block_cursor = NULL;
+	block_remaining = 0;
+}
+
+LayoutArena::~LayoutArena()
+{
+	for (BlockList::iterator i = blocks.begin(); i != blocks.end(); ++i)
+		free(*i);
+}
+
+// Allocates a zeroed chunk of memory.
+void* LayoutArena::Allocate(size_t size)
+{
+	size_t size_class = (size + SIZE_CLASS_GRANULARITY - 1) / SIZE_CLASS_GRANULARITY;
+
+	ChunkHeader* header;
+	if (size_class >= NUM_SIZE_CLASSES)
+	{
+		// Too big for any size class, so this chunk is allocated (and will be released) on its own.
+		header = (ChunkHeader*) malloc(sizeof(ChunkHeader) + size);
+		size_class = NUM_SIZE_CLASSES;
+	}
+	else if (free_chunks[size_class] != NULL)
+	{
+		FreeChunk* free_chunk = free_chunks[size_class];
+		free_chunks[size_class] = free_chunk->next;
+
+		header = ((ChunkHeader*) free_chunk) - 1;
+	}
+	else
+	{
+		size_t chunk_size = sizeof(ChunkHeader) + size_class * SIZE_CLASS_GRANULARITY;
+		if (block_remaining < chunk_size)
+			AllocateBlock(chunk_size);
+
+		header = (ChunkHeader*) block_cursor;
+		block_cursor += chunk_size;
+		block_remaining -= chunk_size;
+	}
+
+	header->arena = this;
+	header->size_class = size_class;
+
+	void* chunk = header + 1;
+	memset(chunk, 0, size);
+
+	return chunk;
+}
+
+// Returns a chunk to the arena it was allocated from.
+void LayoutArena::Deallocate(void* chunk)
+{
+	if (chunk == NULL)
+		return;
+
+	ChunkHeader* header = ((ChunkHeader*) chunk) - 1;
+	if (header->size_class == NUM_SIZE_CLASSES)
+	{
+		free(header);
+		return;
+	}
+
+	FreeChunkList& free_list = header->arena->free_chunks;
+
+	FreeChunk* free_chunk = (FreeChunk*) chunk;
+	free_chunk->next = free_list[header->size_class];
+	free_list[header->size_class] = free_chunk;
+}
+
+// Allocates a new block big enough for at least one chunk of the given size.
+void LayoutArena::AllocateBlock(size_t chunk_size)
+{
+	size_t block_size = chunk_size > BLOCK_SIZE ? chunk_size : BLOCK_SIZE;
+
+	block_cursor = (byte*) malloc(block_size);
+	block_remaining = block_size;
+
+	blocks.push_back(block_cursor);
+}
+
+}
+}
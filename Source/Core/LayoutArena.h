@@ -0,0 +1,93 @@
+/*
+ * This source file is part of libRocket, the HTML/CSS Interface Middleware
+ *
+ * For the latest information, see http://www.librocket.com
+ *
+ * Copyright (c) 2008-2010 CodePoint Ltd, Shift Technology Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+#ifndef ROCKETCORELAYOUTARENA_H
+#define ROCKETCORELAYOUTARENA_H
+
+#include <Rocket/Core/Types.h>
+#include <vector>
+
+namespace Rocket {
+namespace Core {
+
+/**
+	The memory arena a layout engine allocates its boxes from. Chunks are carved from large blocks and rounded up
+	into size classes; a deallocated chunk is kept for reuse by a later allocation in the same size class. All of the
+	arena's memory is released in bulk when it is destroyed.
+
+	An arena has no shared state, so engines formatting on different threads never contend over their allocations.
+ */
+
+class LayoutArena
+{
+public:
+	LayoutArena();
+	~LayoutArena();
+
+	/// Allocates a zeroed chunk of memory.
+	/// @param[in] size The size of the chunk, in bytes.
+	/// @return The new chunk.
+	void* Allocate(size_t size);
+	/// Returns a chunk to the arena it was allocated from.
+	/// @param[in] chunk The chunk to deallocate.
+	static void Deallocate(void* chunk);
+
+private:
+	// Prefixes every chunk, identifying where it needs to be returned to.
+	struct ChunkHeader
+	{
+		LayoutArena* arena;
+		size_t size_class;
+	};
+
+	// Links deallocated chunks within the same size class.
+	struct FreeChunk
+	{
+		FreeChunk* next;
+	};
+
+	// Allocates a new block big enough for at least one chunk of the given size.
+	void AllocateBlock(size_t chunk_size);
+
+	typedef std::vector< byte* > BlockList;
+	typedef std::vector< FreeChunk* > FreeChunkList;
+
+	// All blocks allocated by the arena.
+	BlockList blocks;
+	// The unused memory at the end of the latest block.
+	byte* block_cursor;
+	size_t block_remaining;
+
+	// The most-recently deallocated chunk of each size class.
+	FreeChunkList free_chunks;
+};
+
+}
+}
+
+#endif
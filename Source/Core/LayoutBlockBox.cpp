@@ -41,7 +41,7 @@ namespace Core {
 // Creates a new block box for rendering a block element.
 LayoutBlockBox::LayoutBlockBox(LayoutEngine* _layout_engine, LayoutBlockBox* _parent, Element* _element) : position(0, 0)
 {
-	space = new LayoutBlockBoxSpace(this);
+	space = new (_layout_engine) LayoutBlockBoxSpace(this);
 
 	layout_engine = _layout_engine;
 	parent = _parent;
@@ -90,7 +90,7 @@ LayoutBlockBox::LayoutBlockBox(LayoutEngine* _layout_engine, LayoutBlockBox* _pa
 			if (self_offset_parent != this)
 			{
 				// Get the next position within our offset parent's containing block.
-				parent->PositionBlockBox(position, box, element->GetProperty< int >(CLEAR));
+				parent->PositionBlockBox(position, box, element->GetProperty< int >(PROPERTY_CLEAR));
 				element->SetOffset(position - (self_offset_parent->GetPosition() - offset_root->GetPosition()), self_offset_parent->GetElement());
 			}
 			else
@@ -134,7 +134,7 @@ LayoutBlockBox::LayoutBlockBox(LayoutEngine* _layout_engine, LayoutBlockBox* _pa
 	space = _parent->space;
 
 	context = INLINE;
-	line_boxes.push_back(new LayoutLineBox(this));
+	line_boxes.push_back(new (layout_engine) LayoutLineBox(this));
 	wrap_content = parent->wrap_content;
 
 	element = NULL;
@@ -245,7 +245,7 @@ LayoutBlockBox::CloseResult LayoutBlockBox::Close()
 			element->SetContentBox(space->GetOffset(), content_box);
 
 			// Format any scrollbars which were enabled on this element.
-			element->GetElementScroll()->FormatScrollbars();
+			element->FormatScrollbars();
 		}
 		else
 			element->SetBox(box);
@@ -298,7 +298,7 @@ LayoutInlineBox* LayoutBlockBox::CloseLineBox(LayoutLineBox* child, LayoutInline
 	}
 
 	// Add a new line box.
-	line_boxes.push_back(new LayoutLineBox(this));
+	line_boxes.push_back(new (layout_engine) LayoutLineBox(this));
 
 	if (overflow_chain != NULL)
 		line_boxes.back()->AddChainedBox(overflow_chain);
@@ -341,7 +341,7 @@ LayoutBlockBox* LayoutBlockBox::AddBlockElement(Element* element)
 		}
 	}
 
-	block_boxes.push_back(new LayoutBlockBox(layout_engine, this, element));
+	block_boxes.push_back(new (layout_engine) LayoutBlockBox(layout_engine, this, element));
 	return block_boxes.back();
 }
 
@@ -360,7 +360,7 @@ LayoutInlineBox* LayoutBlockBox::AddInlineElement(Element* element, const Box& b
 		// No dice! Ah well, nothing for it but to open a new inline context block box.
 		else
 		{
-			block_boxes.push_back(new LayoutBlockBox(layout_engine, this));
+			block_boxes.push_back(new (layout_engine) LayoutBlockBox(layout_engine, this));
 
 			if (interrupted_chain != NULL)
 			{
@@ -464,8 +464,7 @@ void LayoutBlockBox::CloseAbsoluteElements()
 			absolute_position -= position - offset_root->GetPosition();
 
 			// Lay out the element.
-			LayoutEngine layout_engine;
-			layout_engine.FormatElement(absolute_element, containing_block);
+			LayoutEngine::FormatLayoutRoot(absolute_element, containing_block);
 
 			// Now that the element's box has been built, we can offset the position we determined was appropriate for
 			// it by the element's margin. This is necessary because the coordinate system for the box begins at the
@@ -539,6 +538,12 @@ LayoutBlockBox* LayoutBlockBox::GetParent() const
 	return parent;
 }
 
+// Returns the layout engine that created this block box.
+LayoutEngine* LayoutBlockBox::GetLayoutEngine() const
+{
+	return layout_engine;
+}
+
 // Returns the position of the block box, relative to its parent's content area.
 const Vector2f& LayoutBlockBox::GetPosition() const
 {
@@ -569,10 +574,14 @@ const Box& LayoutBlockBox::GetBox() const
 	return box;
 }
 
-void* LayoutBlockBox::operator new(size_t size)
+void* LayoutBlockBox::operator new(size_t size, LayoutEngine* layout_engine)
 {
-	void* memory = LayoutEngine::AllocateLayoutChunk(size);
-	return memory;
+	return layout_engine->AllocateLayoutChunk(size);
+}
+
+void LayoutBlockBox::operator delete(void* chunk, LayoutEngine* ROCKET_UNUSED(layout_engine))
+{
+	LayoutEngine::DeallocateLayoutChunk(chunk);
 }
 
 void LayoutBlockBox::operator delete(void* chunk)
@@ -624,7 +633,7 @@ bool LayoutBlockBox::CatchVerticalOverflow(float cursor)
 			block_boxes.clear();
 
 			delete space;
-			space = new LayoutBlockBoxSpace(this);
+			space = new (layout_engine) LayoutBlockBoxSpace(this);
 
 			box_cursor = 0;
 			interrupted_chain = NULL;
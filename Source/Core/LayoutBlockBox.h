@@ -137,6 +137,10 @@ public:
 	/// @return The block box's parent.
 	LayoutBlockBox* GetParent() const;
 
+	/// Returns the layout engine that created this block box.
+	/// @return The block box's layout engine.
+	LayoutEngine* GetLayoutEngine() const;
+
 	/// Returns the position of the block box, relative to its parent's content area.
 	/// @return The relative position of the block box.
 	const Vector2f& GetPosition() const;
@@ -155,7 +159,8 @@ public:
 	/// @return The block box's dimension box.
 	const Box& GetBox() const;
 
-	void* operator new(size_t size);
+	void* operator new(size_t size, LayoutEngine* layout_engine);
+	void operator delete(void* chunk, LayoutEngine* layout_engine);
 	void operator delete(void* chunk);
 
 private:
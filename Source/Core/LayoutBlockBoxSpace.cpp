@@ -76,7 +76,7 @@ float LayoutBlockBoxSpace::PositionBox(float cursor, Element* element)
 	}
 
 	// Shift the cursor down past to clear boxes, if necessary.
-	cursor = ClearBoxes(cursor, element->GetProperty< int >(CLEAR));
+	cursor = ClearBoxes(cursor, element->GetProperty< int >(PROPERTY_CLEAR));
 
 	// Find a place to put this box.
 	Vector2f element_offset;
@@ -267,9 +267,14 @@ Vector2f LayoutBlockBoxSpace::GetDimensions() const
 	return dimensions - offset;
 }
 
-void* LayoutBlockBoxSpace::operator new(size_t size)
+void* LayoutBlockBoxSpace::operator new(size_t size, LayoutEngine* layout_engine)
 {
-	return LayoutEngine::AllocateLayoutChunk(size);
+	return layout_engine->AllocateLayoutChunk(size);
+}
+
+void LayoutBlockBoxSpace::operator delete(void* chunk, LayoutEngine* ROCKET_UNUSED(layout_engine))
+{
+	LayoutEngine::DeallocateLayoutChunk(chunk);
 }
 
 void LayoutBlockBoxSpace::operator delete(void* chunk)
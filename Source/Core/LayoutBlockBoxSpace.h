@@ -35,6 +35,7 @@ namespace Core {
 
 class Element;
 class LayoutBlockBox;
+class LayoutEngine;
 
 /**
 	Each block box has a space object for managing the space occupied by its floating elements, and those of its
@@ -81,7 +82,8 @@ public:
 	/// @return The space's dimensions.
 	Vector2f GetDimensions() const;
 
-	void* operator new(size_t size);
+	void* operator new(size_t size, LayoutEngine* layout_engine);
+	void operator delete(void* chunk, LayoutEngine* layout_engine);
 	void operator delete(void* chunk);
 
 private:
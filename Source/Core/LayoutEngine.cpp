@@ -28,9 +28,9 @@
 #include "precompiled.h"
 #include "LayoutEngine.h"
 #include <Rocket/Core/Math.h>
-#include "Pool.h"
 #include "LayoutBlockBoxSpace.h"
 #include "LayoutInlineBoxText.h"
+#include "LayoutStatisticsRecorder.h"
 #include <Rocket/Core/Element.h>
 #include <Rocket/Core/ElementScroll.h>
 #include <Rocket/Core/ElementText.h>
@@ -42,21 +42,6 @@
 namespace Rocket {
 namespace Core {
 
-#define MAX(a, b) (a > b ? a : b)
-
-struct LayoutChunk
-{
-	LayoutChunk()
-	{
-		memset(buffer, 0, size);
-	}
-
-	static const unsigned int size = MAX(sizeof(LayoutBlockBox), MAX(sizeof(LayoutInlineBox), MAX(sizeof(LayoutInlineBoxText), MAX(sizeof(LayoutLineBox), sizeof(LayoutBlockBoxSpace)))));
-	char buffer[size];
-};
-
-static Pool< LayoutChunk > layout_chunk_pool(200, true);
-
 LayoutEngine::LayoutEngine()
 {
 	block_box = NULL;
@@ -70,7 +55,13 @@ LayoutEngine::~LayoutEngine()
 // Formats the contents for a root-level element (usually a document or floating element).
 bool LayoutEngine::FormatElement(Element* element, const Vector2f& containing_block)
 {
-	block_box = new LayoutBlockBox(this, NULL, NULL);
+	ROCKET_LAYOUT_STATISTIC(OnFormatElement());
+
+	element->subtree_layout_dirty = false;
+	element->layout_root_dirty = false;
+	element->child_layout_root_dirty = false;
+
+	block_box = new (this) LayoutBlockBox(this, NULL, NULL);
 	block_box->GetBox().SetContent(containing_block);
 
 	block_context_box = block_box->AddBlockElement(element);
@@ -84,12 +75,93 @@ bool LayoutEngine::FormatElement(Element* element, const Vector2f& containing_bl
 	block_context_box->Close();
 	block_context_box->CloseAbsoluteElements();
 
-	element->OnLayout();
+	element->OnLayoutComplete();
 
 	delete block_box;
 	return true;
 }
 
+// Formats an element that is laid out independently of its surroundings, marking it as a layout root.
+void LayoutEngine::FormatLayoutRoot(Element* element, const Vector2f& containing_block)
+{
+	// If nothing within our hierarchy has changed since we were last formatted against the same containing block, the
+	// boxes and offsets we were given then are still valid.
+	if (element->layout_root &&
+		!element->subtree_layout_dirty &&
+		element->layout_root_containing_block == containing_block)
+	{
+		ROCKET_LAYOUT_STATISTIC(OnReuseLayout());
+		return;
+	}
+
+	element->layout_root = true;
+	element->layout_root_containing_block = containing_block;
+
+	LayoutEngine layout_engine;
+	layout_engine.FormatElement(element, containing_block);
+}
+
+// Formats again the dirty layout roots within an element's hierarchy.
+bool LayoutEngine::FormatDirtyLayoutRoots(Element* element)
+{
+	ElementList layout_roots;
+	GetDirtyLayoutRoots(layout_roots, element);
+
+	for (size_t i = 0; i < layout_roots.size(); i++)
+	{
+		// A root may have already been formatted as part of an earlier root's ancestor.
+		if (layout_roots[i]->layout_root_dirty &&
+			!FormatDirtyLayoutRoot(layout_roots[i]))
+			return false;
+	}
+
+	return true;
+}
+
+// Collects the outer-most dirty layout roots within an element's hierarchy.
+void LayoutEngine::GetDirtyLayoutRoots(ElementList& layout_roots, Element* element)
+{
+	if (!element->child_layout_root_dirty)
+		return;
+
+	element->child_layout_root_dirty = false;
+
+	for (int i = 0; i < element->GetNumChildren(true); i++)
+	{
+		Element* child = element->GetChild(i);
+		if (child->layout_root_dirty)
+			layout_roots.push_back(child);
+		else
+			GetDirtyLayoutRoots(layout_roots, child);
+	}
+}
+
+// Formats a dirty layout root on its own against the containing block it was last formatted in.
+bool LayoutEngine::FormatLayoutRootAgain(Element* element)
+{
+	ROCKET_ASSERT(element->layout_root);
+
+	Box box = element->GetBox();
+
+	LayoutEngine layout_engine;
+	layout_engine.FormatElement(element, element->layout_root_containing_block);
+	ROCKET_LAYOUT_STATISTIC(OnSubtreeLayout());
+
+	// Our surroundings only depend on our box.
+	return element->GetBox() == box;
+}
+
+// Formats again the layout root enclosing an element whose size has changed.
+bool LayoutEngine::FormatParentLayoutRoot(Element* element)
+{
+	// If we have no enclosing root, the entire document has to be formatted.
+	Element* parent_layout_root = element->GetParentLayoutRoot();
+	if (parent_layout_root == NULL)
+		return false;
+
+	return FormatDirtyLayoutRoot(parent_layout_root);
+}
+
 // Generates the box for an element.
 void LayoutEngine::BuildBox(Box& box, const Vector2f& containing_block, Element* element, bool inline_element)
 {
@@ -99,31 +171,15 @@ void LayoutEngine::BuildBox(Box& box, const Vector2f& containing_block, Element*
 		return;
 	}
 
+	const ComputedStyle& computed = element->GetComputedStyle();
+
 	// Calculate the padding area.
-	const Property *padding_top, *padding_bottom, *padding_left, *padding_right;
-	element->GetPaddingProperties (&padding_top, &padding_bottom, &padding_left, &padding_right);
-
-	float padding = element->ResolveProperty(padding_top, containing_block.x);
-	box.SetEdge(Box::PADDING, Box::TOP, Math::Max(0.0f, padding));
-	padding = element->ResolveProperty(padding_right, containing_block.x);
-	box.SetEdge(Box::PADDING, Box::RIGHT, Math::Max(0.0f, padding));
-	padding = element->ResolveProperty(padding_bottom, containing_block.x);
-	box.SetEdge(Box::PADDING, Box::BOTTOM, Math::Max(0.0f, padding));
-	padding = element->ResolveProperty(padding_left, containing_block.x);
-	box.SetEdge(Box::PADDING, Box::LEFT, Math::Max(0.0f, padding));
+	for (int i = 0; i < Box::NUM_EDGES; i++)
+		box.SetEdge(Box::PADDING, (Box::Edge) i, Math::Max(0.0f, computed.padding[i].Resolve(containing_block.x)));
 
 	// Calculate the border area.
-	const Property *border_top_width, *border_bottom_width, *border_left_width, *border_right_width;
-	element->GetBorderWidthProperties (&border_top_width, &border_bottom_width, &border_left_width, &border_right_width);
-
-	float border = element->ResolveProperty(border_top_width, containing_block.x);
-	box.SetEdge(Box::BORDER, Box::TOP, Math::Max(0.0f, border));
-	border = element->ResolveProperty(border_right_width, containing_block.x);
-	box.SetEdge(Box::BORDER, Box::RIGHT, Math::Max(0.0f, border));
-	border = element->ResolveProperty(border_bottom_width, containing_block.x);
-	box.SetEdge(Box::BORDER, Box::BOTTOM, Math::Max(0.0f, border));
-	border = element->ResolveProperty(border_left_width, containing_block.x);
-	box.SetEdge(Box::BORDER, Box::LEFT, Math::Max(0.0f, border));
+	for (int i = 0; i < Box::NUM_EDGES; i++)
+		box.SetEdge(Box::BORDER, (Box::Edge) i, Math::Max(0.0f, computed.border_width[i].Resolve(containing_block.x)));
 
 	// Calculate the size of the content area.
 	Vector2f content_area(-1, -1);
@@ -140,17 +196,14 @@ void LayoutEngine::BuildBox(Box& box, const Vector2f& containing_block, Element*
 		// The element has resized itself, so we only resize it if a RCSS width or height was set explicitly. A value of
 		// 'auto' (or 'auto-fit', ie, both keywords) means keep (or adjust) the intrinsic dimensions.
 		bool auto_width = false, auto_height = false;
-		const Property* width_property, *height_property;
-
-		element->GetDimensionProperties(&width_property, &height_property);
 
-		if (width_property->unit != Property::KEYWORD)
-			content_area.x = element->ResolveProperty(width_property, containing_block.x);
+		if (computed.width.type != ComputedLength::AUTO)
+			content_area.x = computed.width.Resolve(containing_block.x);
 		else
 			auto_width = true;
 
-		if (height_property->unit != Property::KEYWORD)
-			content_area.y = element->ResolveProperty(height_property, containing_block.y);
+		if (computed.height.type != ComputedLength::AUTO)
+			content_area.y = computed.height.Resolve(containing_block.y);
 		else
 			auto_height = true;
 
@@ -189,13 +242,8 @@ void LayoutEngine::BuildBox(Box& box, const Vector2f& containing_block, Element*
 		box.SetContent(content_area);
 
 		// Evaluate the margins. Any declared as 'auto' will resolve to 0.
-		const Property *margin_top, *margin_bottom, *margin_left, *margin_right;
-		element->GetMarginProperties(&margin_top, &margin_bottom, &margin_left, &margin_right);
-
-		box.SetEdge(Box::MARGIN, Box::TOP, element->ResolveProperty(margin_top, containing_block.x));
-		box.SetEdge(Box::MARGIN, Box::RIGHT, element->ResolveProperty(margin_right, containing_block.x));
-		box.SetEdge(Box::MARGIN, Box::BOTTOM, element->ResolveProperty(margin_bottom, containing_block.x));
-		box.SetEdge(Box::MARGIN, Box::LEFT, element->ResolveProperty(margin_left, containing_block.x));
+		for (int i = 0; i < Box::NUM_EDGES; i++)
+			box.SetEdge(Box::MARGIN, (Box::Edge) i, computed.margin[i].Resolve(containing_block.x));
 	}
 
 	// The element is block, so we need to run the box through the ringer to potentially evaluate auto margins and
@@ -217,15 +265,9 @@ void LayoutEngine::BuildBox(Box& box, float& min_height, float& max_height, Layo
 	float box_height = box.GetSize().y;
 	if (box_height < 0)
 	{
-		if (element->GetLocalProperty(MIN_HEIGHT) != NULL)
-			min_height = element->ResolveProperty(MIN_HEIGHT, containing_block.y);
-		else
-			min_height = 0;
-
-		if (element->GetLocalProperty(MAX_HEIGHT) != NULL)
-			max_height = element->ResolveProperty(MAX_HEIGHT, containing_block.y);
-		else
-			max_height = FLT_MAX;
+		const ComputedStyle& computed = element->GetComputedStyle();
+		min_height = computed.min_height.Resolve(containing_block.y);
+		max_height = computed.max_height.Resolve(containing_block.y);
 	}
 	else
 	{
@@ -237,17 +279,9 @@ void LayoutEngine::BuildBox(Box& box, float& min_height, float& max_height, Layo
 // Clamps the width of an element based from its min-width and max-width properties.
 float LayoutEngine::ClampWidth(float width, Element* element, float containing_block_width)
 {
-	float min_width, max_width;
-
-	if (element->GetLocalProperty(MIN_WIDTH) != NULL)
-		min_width = element->ResolveProperty(MIN_WIDTH, containing_block_width);
-	else
-		min_width = 0;
-
-	if (element->GetLocalProperty(MAX_WIDTH) != NULL)
-		max_width = element->ResolveProperty(MAX_WIDTH, containing_block_width);
-	else
-		max_width = FLT_MAX;
+	const ComputedStyle& computed = element->GetComputedStyle();
+	float min_width = computed.min_width.Resolve(containing_block_width);
+	float max_width = computed.max_width.Resolve(containing_block_width);
 
 	return Math::Clamp(width, min_width, max_width);
 }
@@ -255,17 +289,9 @@ float LayoutEngine::ClampWidth(float width, Element* element, float containing_b
 // Clamps the height of an element based from its min-height and max-height properties.
 float LayoutEngine::ClampHeight(float height, Element* element, float containing_block_height)
 {
-	float min_height, max_height;
-
-	if (element->GetLocalProperty(MIN_HEIGHT) != NULL)
-		min_height = element->ResolveProperty(MIN_HEIGHT, containing_block_height);
-	else
-		min_height = 0;
-
-	if (element->GetLocalProperty(MAX_HEIGHT) != NULL)
-		max_height = element->ResolveProperty(MAX_HEIGHT, containing_block_height);
-	else
-		max_height = FLT_MAX;
+	const ComputedStyle& computed = element->GetComputedStyle();
+	float min_height = computed.min_height.Resolve(containing_block_height);
+	float max_height = computed.max_height.Resolve(containing_block_height);
 
 	return Math::Clamp(height, min_height, max_height);
 }
@@ -285,22 +311,25 @@ float LayoutEngine::Round(float value)
 	return ceilf(value);
 }
 
+// Allocates memory for a layout box from this engine's arena.
 void* LayoutEngine::AllocateLayoutChunk(size_t size)
 {
-	(size);
-	ROCKET_ASSERT(size <= LayoutChunk::size);
-
-	return layout_chunk_pool.AllocateObject();
+	return arena.Allocate(size);
 }
 
+// Returns memory allocated for a layout box to the engine that allocated it.
 void LayoutEngine::DeallocateLayoutChunk(void* chunk)
 {
-	layout_chunk_pool.DeallocateObject((LayoutChunk*) chunk);
+	LayoutArena::Deallocate(chunk);
 }
 
 // Positions a single element and its children within this layout.
 bool LayoutEngine::FormatElement(Element* element)
 {
+	// We're being formatted as part of our parent's layout, so anything pending on us will be done now.
+	element->layout_root_dirty = false;
+	element->child_layout_root_dirty = false;
+
 	// Check if we have to do any special formatting for any elements that don't fit into the standard layout scheme.
 	if (FormatElementSpecial(element))
 		return true;
@@ -308,7 +337,10 @@ bool LayoutEngine::FormatElement(Element* element)
 	// Fetch the display property, and don't lay this element out if it is set to a display type of none.
 	int display_property = element->GetDisplay();
 	if (display_property == DISPLAY_NONE)
+	{
+		element->layout_root = false;
 		return true;
+	}
 
 	// Check for an absolute position; if this has been set, then we remove it from the flow and add it to the current
 	// block box to be laid out and positioned once the block has been closed and sized.
@@ -326,8 +358,7 @@ bool LayoutEngine::FormatElement(Element* element)
 	if (float_property != FLOAT_NONE)
 	{
 		// Format the element as a block element.
-		LayoutEngine layout_engine;
-		layout_engine.FormatElement(element, GetContainingBlock(block_context_box));
+		FormatLayoutRoot(element, GetContainingBlock(block_context_box));
 
 		return block_context_box->AddFloatElement(element);
 	}
@@ -347,6 +378,11 @@ bool LayoutEngine::FormatElement(Element* element)
 // Formats and positions an element as a block element.
 bool LayoutEngine::FormatElementBlock(Element* element)
 {
+	ROCKET_LAYOUT_STATISTIC(OnFormatElement());
+
+	element->layout_root = false;
+	element->subtree_layout_dirty = false;
+
 	LayoutBlockBox* new_block_context_box = block_context_box->AddBlockElement(element);
 	if (new_block_context_box == NULL)
 		return false;
@@ -373,7 +409,7 @@ bool LayoutEngine::FormatElementBlock(Element* element)
 
 			if (block_context_box->Close() == LayoutBlockBox::OK)
 			{
-				element->OnLayout();
+				element->OnLayoutComplete();
 				break;
 			}
 		}
@@ -387,7 +423,7 @@ bool LayoutEngine::FormatElementBlock(Element* element)
 		break;
 
 		default:
-			element->OnLayout();
+			element->OnLayoutComplete();
 	}
 
 	block_context_box = new_block_context_box;
@@ -397,6 +433,11 @@ bool LayoutEngine::FormatElementBlock(Element* element)
 // Formats and positions an element as an inline element.
 bool LayoutEngine::FormatElementInline(Element* element)
 {
+	ROCKET_LAYOUT_STATISTIC(OnFormatElement());
+
+	element->layout_root = false;
+	element->subtree_layout_dirty = false;
+
 	Box box;
 	float min_height, max_height;
 	BuildBox(box, min_height, max_height, block_context_box, element, true);
@@ -419,8 +460,7 @@ bool LayoutEngine::FormatElementInline(Element* element)
 void LayoutEngine::FormatElementReplaced(Element* element)
 {
 	// Format the element separately as a block element, then position it inside our own layout as an inline element.
-	LayoutEngine layout_engine;
-	layout_engine.FormatElement(element, GetContainingBlock(block_context_box));
+	FormatLayoutRoot(element, GetContainingBlock(block_context_box));
 
 	block_context_box->AddInlineElement(element, element->GetBox())->Close();
 }
@@ -434,13 +474,28 @@ bool LayoutEngine::FormatElementSpecial(Element* element)
 	if (element->GetTagName() == br)
 	{
 		block_context_box->AddBreak();
-		element->OnLayout();
+		element->OnLayoutComplete();
 		return true;
 	}
 
 	return false;
 }
 
+// Formats a dirty layout root on its own, then any of its ancestor roots affected by a change in its size.
+bool LayoutEngine::FormatDirtyLayoutRoot(Element* element)
+{
+	// If we've been moved since we were last formatted, we have no idea what we'd be formatted against.
+	if (!element->layout_root)
+		return false;
+
+	// If our box hasn't changed, nothing outside of us needs to be formatted. Otherwise, the next root up has to be
+	// formatted again, or if we have none, the entire document.
+	if (FormatLayoutRootAgain(element))
+		return true;
+
+	return FormatParentLayoutRoot(element);
+}
+
 // Returns the fully-resolved, fixed-width and -height containing block from a block box.
 Vector2f LayoutEngine::GetContainingBlock(const LayoutBlockBox* containing_box)
 {
@@ -473,38 +528,28 @@ Vector2f LayoutEngine::GetContainingBlock(const LayoutBlockBox* containing_box)
 void LayoutEngine::BuildBoxWidth(Box& box, Element* element, float containing_block_width)
 {
 	Vector2f content_area = box.GetSize();
+	const ComputedStyle& computed = element->GetComputedStyle();
 
 	// Determine if the element has an automatic width, and if not calculate it.
 	bool width_auto;
 	if (content_area.x >= 0)
 		width_auto = false;
+	else if (computed.width.type == ComputedLength::AUTO)
+		width_auto = true;
 	else
 	{
-		const Property* width_property;
-		element->GetDimensionProperties(&width_property, NULL);
-		if (width_property->unit == Property::KEYWORD)
-		{
-			width_auto = true;
-		}
-		else
-		{
-			width_auto = false;
-			content_area.x = element->ResolveProperty(width_property, containing_block_width);
-		}
+		width_auto = false;
+		content_area.x = computed.width.Resolve(containing_block_width);
 	}
 
 	// Determine if the element has automatic margins.
 	bool margins_auto[2];
 	int num_auto_margins = 0;
 
-	const Property *margin_left, *margin_right;
-	element->GetMarginProperties(NULL, NULL, &margin_left, &margin_right);
-
 	for (int i = 0; i < 2; ++i)
 	{
-		const Property* margin_property = i == 0 ? margin_left : margin_right;
-		if (margin_property != NULL &&
-			margin_property->unit == Property::KEYWORD)
+		Box::Edge edge = i == 0 ? Box::LEFT : Box::RIGHT;
+		if (computed.margin[edge].type == ComputedLength::AUTO)
 		{
 			margins_auto[i] = true;
 			num_auto_margins++;
@@ -512,7 +557,7 @@ void LayoutEngine::BuildBoxWidth(Box& box, Element* element, float containing_bl
 		else
 		{
 			margins_auto[i] = false;
-			box.SetEdge(Box::MARGIN, i == 0 ? Box::LEFT : Box::RIGHT, element->ResolveProperty(margin_property, containing_block_width));
+			box.SetEdge(Box::MARGIN, edge, computed.margin[edge].Resolve(containing_block_width));
 		}
 	}
 
@@ -569,42 +614,28 @@ void LayoutEngine::BuildBoxWidth(Box& box, Element* element, float containing_bl
 void LayoutEngine::BuildBoxHeight(Box& box, Element* element, float containing_block_height)
 {
 	Vector2f content_area = box.GetSize();
+	const ComputedStyle& computed = element->GetComputedStyle();
 
 	// Determine if the element has an automatic height, and if not calculate it.
 	bool height_auto;
 	if (content_area.y >= 0)
 		height_auto = false;
+	else if (computed.height.type == ComputedLength::AUTO)
+		height_auto = true;
 	else
 	{
-		const Property* height_property;
-		element->GetDimensionProperties(NULL, &height_property);
-		if (height_property == NULL)
-		{
-			height_auto = false;		
-		}
-		else if (height_property->unit == Property::KEYWORD)
-		{
-			height_auto = true;
-		}
-		else
-		{
-			height_auto = false;
-			content_area.y = element->ResolveProperty(height_property, containing_block_height);
-		}
+		height_auto = false;
+		content_area.y = computed.height.Resolve(containing_block_height);
 	}
 
 	// Determine if the element has automatic margins.
 	bool margins_auto[2];
 	int num_auto_margins = 0;
 
-	const Property *margin_top, *margin_bottom;
-	element->GetMarginProperties(&margin_top, &margin_bottom, NULL, NULL);
-
 	for (int i = 0; i < 2; ++i)
 	{
-		const Property* margin_property = i == 0 ? margin_top : margin_bottom;
-		if (margin_property != NULL &&
-			margin_property->unit == Property::KEYWORD)
+		Box::Edge edge = i == 0 ? Box::TOP : Box::BOTTOM;
+		if (computed.margin[edge].type == ComputedLength::AUTO)
 		{
 			margins_auto[i] = true;
 			num_auto_margins++;
@@ -612,7 +643,7 @@ void LayoutEngine::BuildBoxHeight(Box& box, Element* element, float containing_b
 		else
 		{
 			margins_auto[i] = false;
-			box.SetEdge(Box::MARGIN, i == 0 ? Box::TOP : Box::BOTTOM, element->ResolveProperty(margin_property, containing_block_height));
+			box.SetEdge(Box::MARGIN, edge, computed.margin[edge].Resolve(containing_block_height));
 		}
 	}
 
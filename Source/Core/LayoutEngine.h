@@ -28,6 +28,7 @@
 #ifndef ROCKETCORELAYOUTENGINE_H
 #define ROCKETCORELAYOUTENGINE_H
 
+#include "LayoutArena.h"
 #include "LayoutBlockBox.h"
 
 namespace Rocket {
@@ -51,6 +52,33 @@ public:
 	/// @param containing_block[in] The size of the containing block.
 	bool FormatElement(Element* element, const Vector2f& containing_block);
 
+	/// Formats an element that is laid out independently of its surroundings (a floating, inline-block or
+	/// absolutely-positioned element), marking it as a layout root that can later be formatted again on its own.
+	/// @param element[in] The element to lay out.
+	/// @param containing_block[in] The size of the containing block.
+	static void FormatLayoutRoot(Element* element, const Vector2f& containing_block);
+	/// Formats again the layout roots within an element's hierarchy that have been marked as dirty, along with any
+	/// of their ancestor roots affected by changes in their sizes.
+	/// @param element[in] The element to search for dirty layout roots; this is usually a document.
+	/// @return False if a change in size has propagated past the outer-most layout root, in which case the entire
+	/// document needs to be formatted.
+	static bool FormatDirtyLayoutRoots(Element* element);
+	/// Collects the outer-most dirty layout roots within an element's hierarchy, clearing the flags that lead to them.
+	/// The roots' hierarchies don't overlap, so they can be formatted independently of each other.
+	/// @param[out] layout_roots The list to add the roots to.
+	/// @param[in] element The element to search for dirty layout roots; this is usually a document.
+	static void GetDirtyLayoutRoots(ElementList& layout_roots, Element* element);
+	/// Formats a dirty layout root on its own against the containing block it was last formatted in. The root must
+	/// have been formatted as a layout root before.
+	/// @param[in] element The layout root.
+	/// @return True if the root's box is unchanged, false if its surroundings may need to be formatted again.
+	static bool FormatLayoutRootAgain(Element* element);
+	/// Formats again the layout root enclosing an element whose size has changed, along with any of its ancestor
+	/// roots affected by a change in its own size.
+	/// @param[in] element The element whose size has changed.
+	/// @return False if the entire document needs to be formatted.
+	static bool FormatParentLayoutRoot(Element* element);
+
 	/// Generates the box for an element.
 	/// @param[out] box The box to be built.
 	/// @param[in] containing_block The dimensions of the content area of the block containing the element.
@@ -88,7 +116,13 @@ public:
 	/// @return The rounded value.
 	static float Round(float value);
 
-	static void* AllocateLayoutChunk(size_t size);
+	/// Allocates memory for a layout box from this engine's arena. The memory is released when the engine is
+	/// destroyed, so no box can outlive the engine that formatted it.
+	/// @param[in] size The size of the box.
+	/// @return The box's memory.
+	void* AllocateLayoutChunk(size_t size);
+	/// Returns memory allocated for a layout box to the engine that allocated it.
+	/// @param[in] chunk The box's memory.
 	static void DeallocateLayoutChunk(void* chunk);
 
 private:
@@ -110,6 +144,11 @@ private:
 	/// @return True if the element was parsed as a special element, false otherwise.
 	bool FormatElementSpecial(Element* element);
 
+	/// Formats a dirty layout root on its own, then any of its ancestor roots affected by a change in its size.
+	/// @param[in] element The layout root.
+	/// @return False if the entire document needs to be formatted.
+	static bool FormatDirtyLayoutRoot(Element* element);
+
 	/// Returns the fully-resolved, fixed-width and -height containing block from a block box.
 	/// @param[in] containing_box The leaf box.
 	/// @return The dimensions of the content area, using the latest fixed dimensions for width and height in the hierarchy.
@@ -131,6 +170,9 @@ private:
 
 	// The open block box containing displaying in a block-context.
 	LayoutBlockBox* block_context_box;
+
+	// The arena all of the engine's boxes are allocated from.
+	LayoutArena arena;
 };
 
 }
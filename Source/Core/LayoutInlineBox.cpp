@@ -349,12 +349,12 @@ void LayoutInlineBox::SizeElement(bool split)
 		element->AddBox(element_box);
 
 		if (chain != NULL)
-			element->OnLayout();
+			element->OnLayoutComplete();
 	}
 	else
 	{
 		element->SetBox(element_box);
-		element->OnLayout();
+		element->OnLayoutComplete();
 	}
 }
 
@@ -394,9 +394,14 @@ float LayoutInlineBox::GetBaseline() const
 	return baseline;
 }
 
-void* LayoutInlineBox::operator new(size_t size)
+void* LayoutInlineBox::operator new(size_t size, LayoutEngine* layout_engine)
 {
-	return LayoutEngine::AllocateLayoutChunk(size);
+	return layout_engine->AllocateLayoutChunk(size);
+}
+
+void LayoutInlineBox::operator delete(void* chunk, LayoutEngine* ROCKET_UNUSED(layout_engine))
+{
+	LayoutEngine::DeallocateLayoutChunk(chunk);
 }
 
 void LayoutInlineBox::operator delete(void* chunk)
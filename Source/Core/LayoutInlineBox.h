@@ -37,6 +37,7 @@ class Element;
 class ElementText;
 class FontFaceHandle;
 class LayoutBlockBox;
+class LayoutEngine;
 class LayoutLineBox;
 
 /**
@@ -133,7 +134,8 @@ public:
 	/// @return The box's baseline.
 	float GetBaseline() const;
 
-	void* operator new(size_t size);
+	void* operator new(size_t size, LayoutEngine* layout_engine);
+	void operator delete(void* chunk, LayoutEngine* layout_engine);
 	void operator delete(void* chunk);
 
 protected:
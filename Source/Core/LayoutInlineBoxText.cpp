@@ -75,7 +75,7 @@ LayoutInlineBox* LayoutInlineBoxText::FlowContent(bool first_box, float availabl
 	LayoutInlineBox::FlowContent(first_box, available_width, right_spacing_width);
 
 	if (overflow)
-		return new LayoutInlineBoxText(element, line_begin + line_length);
+		return new (line->GetBlockBox()->GetLayoutEngine()) LayoutInlineBoxText(element, line_begin + line_length);
 
 	return NULL;
 }
@@ -126,9 +126,14 @@ void LayoutInlineBoxText::SizeElement(bool ROCKET_UNUSED(split))
 {
 }
 
-void* LayoutInlineBoxText::operator new(size_t size)
+void* LayoutInlineBoxText::operator new(size_t size, LayoutEngine* layout_engine)
 {
-	return LayoutEngine::AllocateLayoutChunk(size);
+	return layout_engine->AllocateLayoutChunk(size);
+}
+
+void LayoutInlineBoxText::operator delete(void* chunk, LayoutEngine* ROCKET_UNUSED(layout_engine))
+{
+	LayoutEngine::DeallocateLayoutChunk(chunk);
 }
 
 void LayoutInlineBoxText::operator delete(void* chunk)
@@ -72,7 +72,8 @@ public:
 	/// Sizes the inline box's element.
 	virtual void SizeElement(bool split);
 
-	void* operator new(size_t size);
+	void* operator new(size_t size, LayoutEngine* layout_engine);
+	void operator delete(void* chunk, LayoutEngine* layout_engine);
 	void operator delete(void* chunk);
 
 private:
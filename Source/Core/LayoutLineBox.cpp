@@ -196,9 +196,9 @@ void LayoutLineBox::CloseInlineBox(LayoutInlineBox* inline_box)
 LayoutInlineBox* LayoutLineBox::AddElement(Element* element, const Box& box)
 {
 	if (dynamic_cast< ElementText* >(element) != NULL)
-		return AddBox(new LayoutInlineBoxText(element));
+		return AddBox(new (parent->GetLayoutEngine()) LayoutInlineBoxText(element));
 	else
-		return AddBox(new LayoutInlineBox(element, box));
+		return AddBox(new (parent->GetLayoutEngine()) LayoutInlineBox(element, box));
 }
 
 // Attempts to add a new inline box to this line.
@@ -323,7 +323,7 @@ void LayoutLineBox::AddChainedBox(LayoutInlineBox* chained_box)
 
 	while (!hierarchy.empty())
 	{
-		AddBox(new LayoutInlineBox(hierarchy.top()));
+		AddBox(new (parent->GetLayoutEngine()) LayoutInlineBox(hierarchy.top()));
 		hierarchy.pop();
 	}
 }
@@ -358,9 +358,14 @@ LayoutBlockBox* LayoutLineBox::GetBlockBox()
 	return parent;
 }
 
-void* LayoutLineBox::operator new(size_t size)
+void* LayoutLineBox::operator new(size_t size, LayoutEngine* layout_engine)
 {
-	return LayoutEngine::AllocateLayoutChunk(size);
+	return layout_engine->AllocateLayoutChunk(size);
+}
+
+void LayoutLineBox::operator delete(void* chunk, LayoutEngine* ROCKET_UNUSED(layout_engine))
+{
+	LayoutEngine::DeallocateLayoutChunk(chunk);
 }
 
 void LayoutLineBox::operator delete(void* chunk)
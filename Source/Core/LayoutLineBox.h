@@ -34,6 +34,7 @@ namespace Rocket {
 namespace Core {
 
 class LayoutBlockBox;
+class LayoutEngine;
 
 /**
 	@author Peter Curry
@@ -88,7 +89,8 @@ public:
 	/// @return The line's block box.
 	LayoutBlockBox* GetBlockBox();
 
-	void* operator new(size_t size);
+	void* operator new(size_t size, LayoutEngine* layout_engine);
+	void operator delete(void* chunk, LayoutEngine* layout_engine);
 	void operator delete(void* chunk);
 
 private:
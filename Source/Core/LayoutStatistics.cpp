@@ -0,0 +1,135 @@
+/*
+ * This source file is part of libRocket, the HTML/CSS Interface Middleware
+ *
+ * For the latest information, see http://www.librocket.com
+ *
+ * Copyright (c) 2008-2010 CodePoint Ltd, Shift Technology Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include "precompiled.h"
+#include <Rocket/Core/LayoutStatistics.h>
+#include "AtomicCounter.h"
+#include "LayoutStatisticsRecorder.h"
+
+namespace Rocket {
+namespace Core {
+
+#ifdef ROCKET_ENABLE_LAYOUT_STATS
+
+// The counters are updated from layout tasks, which may be running concurrently.
+static volatile unsigned int formatted_elements = 0;
+static volatile unsigned int document_layouts = 0;
+static volatile unsigned int subtree_layouts = 0;
+static volatile unsigned int reused_layouts = 0;
+
+// Records an element being formatted.
+void LayoutStatisticsRecorder::OnFormatElement()
+{
+	AtomicAdd(formatted_elements, 1);
+}
+
+// Records a document being formatted in its entirety.
+void LayoutStatisticsRecorder::OnDocumentLayout()
+{
+	AtomicAdd(document_layouts, 1);
+}
+
+// Records a layout root being formatted on its own.
+void LayoutStatisticsRecorder::OnSubtreeLayout()
+{
+	AtomicAdd(subtree_layouts, 1);
+}
+
+// Records a layout root keeping its previous layout.
+void LayoutStatisticsRecorder::OnReuseLayout()
+{
+	AtomicAdd(reused_layouts, 1);
+}
+
+bool LayoutStatistics::IsEnabled()
+{
+	return true;
+}
+
+void LayoutStatistics::Reset()
+{
+	formatted_elements = 0;
+	document_layouts = 0;
+	subtree_layouts = 0;
+	reused_layouts = 0;
+}
+
+unsigned int LayoutStatistics::GetFormattedElements()
+{
+	return formatted_elements;
+}
+
+unsigned int LayoutStatistics::GetDocumentLayouts()
+{
+	return document_layouts;
+}
+
+unsigned int LayoutStatistics::GetSubtreeLayouts()
+{
+	return subtree_layouts;
+}
+
+unsigned int LayoutStatistics::GetReusedLayouts()
+{
+	return reused_layouts;
+}
+
+#else
+
+bool LayoutStatistics::IsEnabled()
+{
+	return false;
+}
+
+void LayoutStatistics::Reset()
+{
+}
+
+unsigned int LayoutStatistics::GetFormattedElements()
+{
+	return 0;
+}
+
+unsigned int LayoutStatistics::GetDocumentLayouts()
+{
+	return 0;
+}
+
+unsigned int LayoutStatistics::GetSubtreeLayouts()
+{
+	return 0;
+}
+
+unsigned int LayoutStatistics::GetReusedLayouts()
+{
+	return 0;
+}
+
+#endif
+
+}
+}
@@ -0,0 +1,61 @@
+/*
+ * This source file is part of libRocket, the HTML/CSS Interface Middleware
+ *
+ * For the latest information, see http://www.librocket.com
+ *
+ * Copyright (c) 2008-2010 CodePoint Ltd, Shift Technology Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef ROCKETCORELAYOUTSTATISTICSRECORDER_H
+#define ROCKETCORELAYOUTSTATISTICSRECORDER_H
+
+namespace Rocket {
+namespace Core {
+
+/**
+	Internal recording points for LayoutStatistics. Call sites should use ROCKET_LAYOUT_STATISTIC() so the recording
+	compiles to nothing unless ROCKET_ENABLE_LAYOUT_STATS is defined.
+ */
+
+class LayoutStatisticsRecorder
+{
+public:
+	/// Records an element being formatted.
+	static void OnFormatElement();
+	/// Records a document being formatted in its entirety.
+	static void OnDocumentLayout();
+	/// Records a layout root being formatted on its own.
+	static void OnSubtreeLayout();
+	/// Records a layout root keeping its previous layout.
+	static void OnReuseLayout();
+};
+
+}
+}
+
+#ifdef ROCKET_ENABLE_LAYOUT_STATS
+#define ROCKET_LAYOUT_STATISTIC(statement) Rocket::Core::LayoutStatisticsRecorder::statement
+#else
+#define ROCKET_LAYOUT_STATISTIC(statement) ((void) 0)
+#endif
+
+#endif
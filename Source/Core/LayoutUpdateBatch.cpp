@@ -0,0 +1,200 @@
+/*
+ * This source file is part of libRocket, the HTML/CSS Interface Middleware
+ *
+ * For the latest information, see http://www.librocket.com
+ *
+ * Copyright (c) 2008-2010 CodePoint Ltd, Shift Technology Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+#include "precompiled.h"
+#include "LayoutUpdateBatch.h"
+#include <Rocket/Core/ElementDocument.h>
+#include <Rocket/Core/StyleSheetSpecification.h>
+#include <Rocket/Core/SystemInterface.h>
+#include "FontStringWidthCache.h"
+#include "LayoutEngine.h"
+#include "PropertySourceTable.h"
+
+namespace Rocket {
+namespace Core {
+
+LayoutUpdateBatch::LayoutUpdateBatch()
+{
+}
+
+LayoutUpdateBatch::~LayoutUpdateBatch()
+{
+}
+
+// Adds a document into the batch if its layout needs to be updated.
+void LayoutUpdateBatch::AddDocument(ElementDocument* document)
+{
+	if (document->layout_dirty &&
+		document->lock_layout == 0)
+		documents.push_back(document);
+}
+
+// Formats the batch's documents.
+void LayoutUpdateBatch::Format(int max_concurrent_tasks)
+{
+	for (size_t i = 0; i < documents.size(); ++i)
+	{
+		documents[i]->layout_dirty = false;
+		documents[i]->lock_layout++;
+
+		GatherTasks(documents[i]);
+	}
+
+	bool concurrent = max_concurrent_tasks > 1 && tasks.size() > 1;
+	if (concurrent)
+	{
+		ElementSet prepared_ancestors;
+		for (size_t i = 0; i < tasks.size(); ++i)
+		{
+			tasks[i].element->PrepareConcurrentLayout();
+			PrepareAncestors(tasks[i].element->GetParentNode(), prepared_ancestors);
+		}
+
+		for (size_t i = 0; i < documents.size(); ++i)
+			documents[i]->concurrent_layout = true;
+
+		FontStringWidthCache::SetReadOnly(true);
+		PropertySourceTable::SetReadOnly(true);
+		GetSystemInterface()->RunTasks(FormatTask, this, (int) tasks.size());
+		PropertySourceTable::SetReadOnly(false);
+		FontStringWidthCache::SetReadOnly(false);
+	}
+	else
+	{
+		for (size_t i = 0; i < tasks.size(); ++i)
+			FormatTask(this, (int) i);
+	}
+
+	FormatParentLayoutRoots();
+
+	for (size_t i = 0; i < documents.size(); ++i)
+	{
+		if (documents[i]->concurrent_layout)
+		{
+			documents[i]->concurrent_layout = false;
+			documents[i]->ProcessDeferredLayout();
+		}
+
+		documents[i]->lock_layout--;
+	}
+
+	documents.clear();
+	tasks.clear();
+}
+
+// Formats one of the batch's tasks.
+void LayoutUpdateBatch::FormatTask(void* data, int task_index)
+{
+	Task& task = ((LayoutUpdateBatch*) data)->tasks[task_index];
+
+	if (task.element == task.document)
+	{
+		task.document->FormatDocument();
+		task.box_unchanged = true;
+	}
+	else
+		task.box_unchanged = LayoutEngine::FormatLayoutRootAgain(task.element);
+}
+
+// Resolves everything a task may look up on an element and its ancestors.
+void LayoutUpdateBatch::PrepareAncestors(Element* element, ElementSet& prepared_ancestors)
+{
+	const PropertyIdSet& inherited_properties = StyleSheetSpecification::GetRegisteredInheritedPropertyIds();
+
+	// Each of these is otherwise resolved on first use and remembered on the element: our elements memoise the
+	// inherited values they look up on their parents, and a relative font size is resolved against the parent's
+	// remembered font size, which is in turn resolved against its parent's.
+	for (; element != NULL && prepared_ancestors.insert(element).second; element = element->GetParentNode())
+	{
+		element->GetDefinition();
+		element->GetComputedStyle();
+		element->ResolveProperty(PROPERTY_FONT_SIZE, 0);
+
+		for (PropertyId id = inherited_properties.First(); id != PROPERTY_INVALID; id = inherited_properties.Next(id))
+			element->GetProperty(id);
+	}
+}
+
+// Adds the tasks required to update a document's layout.
+void LayoutUpdateBatch::GatherTasks(ElementDocument* document)
+{
+	Task task;
+	task.element = document;
+	task.document = document;
+	task.box_unchanged = false;
+
+	if (document->document_layout_dirty)
+	{
+		tasks.push_back(task);
+		return;
+	}
+
+	ElementList layout_roots;
+	LayoutEngine::GetDirtyLayoutRoots(layout_roots, document);
+
+	// If any of the roots has been moved since it was last formatted, the entire document has to be formatted.
+	for (size_t i = 0; i < layout_roots.size(); ++i)
+	{
+		if (!layout_roots[i]->layout_root)
+		{
+			tasks.push_back(task);
+			return;
+		}
+	}
+
+	for (size_t i = 0; i < layout_roots.size(); ++i)
+	{
+		task.element = layout_roots[i];
+		tasks.push_back(task);
+	}
+}
+
+// Formats again the surroundings of any layout roots whose boxes changed when they were formatted.
+void LayoutUpdateBatch::FormatParentLayoutRoots()
+{
+	// The tasks of each document are consecutive, so once a document has been formatted in its entirety, the rest of
+	// its tasks can be skipped.
+	ElementDocument* formatted_document = NULL;
+
+	for (size_t i = 0; i < tasks.size(); ++i)
+	{
+		const Task& task = tasks[i];
+		if (task.box_unchanged ||
+			task.document == formatted_document)
+			continue;
+
+		if (!LayoutEngine::FormatParentLayoutRoot(task.element))
+		{
+			task.document->FormatDocument();
+			formatted_document = task.document;
+		}
+	}
+}
+
+}
+}
@@ -0,0 +1,95 @@
+/*
+ * This source file is part of libRocket, the HTML/CSS Interface Middleware
+ *
+ * For the latest information, see http://www.librocket.com
+ *
+ * Copyright (c) 2008-2010 CodePoint Ltd, Shift Technology Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+#ifndef ROCKETCORELAYOUTUPDATEBATCH_H
+#define ROCKETCORELAYOUTUPDATEBATCH_H
+
+#include <Rocket/Core/Types.h>
+
+namespace Rocket {
+namespace Core {
+
+class ElementDocument;
+
+/**
+	A batch of documents whose layouts are being updated together. Each document is formatted as a task through the
+	system interface, unless only some of its layout roots are dirty, in which case each of those roots is formatted as
+	a task of its own.
+
+	Everything a task would otherwise resolve from shared state is resolved before the tasks are run, and anything a
+	task's elements would do that affects elements outside of it (such as dispatching events) is deferred until every
+	task has completed.
+ */
+
+class LayoutUpdateBatch
+{
+public:
+	LayoutUpdateBatch();
+	~LayoutUpdateBatch();
+
+	/// Adds a document into the batch if its layout needs to be updated.
+	/// @param[in] document The document.
+	void AddDocument(ElementDocument* document);
+
+	/// Formats the batch's documents, concurrently if there is more than one independent task.
+	/// @param[in] max_concurrent_tasks The number of tasks the system interface can run concurrently.
+	void Format(int max_concurrent_tasks);
+
+private:
+	struct Task
+	{
+		// The element to format; this is either a layout root or the entire document.
+		Element* element;
+		ElementDocument* document;
+		// True once the element has been formatted if its box hasn't changed.
+		bool box_unchanged;
+	};
+
+	typedef std::vector< Task > TaskList;
+	typedef std::vector< ElementDocument* > DocumentList;
+	typedef std::set< Element* > ElementSet;
+
+	// Formats one of the batch's tasks; this is run as a task.
+	static void FormatTask(void* data, int task_index);
+	// Resolves everything a task may look up on an element and its ancestors, as they may be shared with other
+	// tasks. Elements already in the set of prepared ancestors, and their ancestors, are skipped.
+	static void PrepareAncestors(Element* element, ElementSet& prepared_ancestors);
+
+	// Adds the tasks required to update a document's layout.
+	void GatherTasks(ElementDocument* document);
+	// Formats again the surroundings of any layout roots whose boxes changed when they were formatted.
+	void FormatParentLayoutRoots();
+
+	DocumentList documents;
+	TaskList tasks;
+};
+
+}
+}
+
+#endif
@@ -28,6 +28,7 @@
 #include "precompiled.h"
 #include <Rocket/Core/Property.h>
 #include <Rocket/Core/PropertyDefinition.h>
+#include "PropertySourceTable.h"
 
 namespace Rocket {
 namespace Core {
@@ -36,6 +37,8 @@ Property::Property() : unit(UNKNOWN), specificity(-1)
 {
 	definition = NULL;
 	parser_index = -1;
+
+	source_index = PropertySourceTable::NO_SOURCE;
 }
 
 Property::~Property()
@@ -52,5 +55,23 @@ String Property::ToString() const
 	return string;
 }
 
+// Sets the source the property was declared in.
+void Property::SetSource(const String& source, int source_line_number)
+{
+	source_index = PropertySourceTable::GetIndex(source, source_line_number);
+}
+
+// Returns the file the property was declared in.
+String Property::GetSource() const
+{
+	return PropertySourceTable::GetSource(source_index);
+}
+
+// Returns the line the property was declared on.
+int Property::GetSourceLineNumber() const
+{
+	return PropertySourceTable::GetSourceLineNumber(source_index);
+}
+
 }
 }
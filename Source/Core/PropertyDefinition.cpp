@@ -33,8 +33,9 @@
 namespace Rocket {
 namespace Core {
 
-PropertyDefinition::PropertyDefinition(const String& _default_value, bool _inherited, bool _forces_layout) : default_value(_default_value, Property::UNKNOWN)
+PropertyDefinition::PropertyDefinition(PropertyId _id, const String& _default_value, bool _inherited, bool _forces_layout) : default_value(_default_value, Property::UNKNOWN)
 {
+	id = _id;
 	inherited = _inherited;
 	forces_layout = _forces_layout;
 }
@@ -47,6 +48,7 @@ PropertyDefinition::~PropertyDefinition()
 PropertyDefinition& PropertyDefinition::AddParser(const String& parser_name, const String& parser_parameters)
 {
 	ParserState new_parser;
+	new_parser.name = parser_name;
 
 	// Fetch the parser.
 	new_parser.parser = StyleSheetSpecification::GetParser(parser_name);
@@ -163,5 +165,29 @@ const Property* PropertyDefinition::GetDefaultValue() const
 	return &default_value;
 }
 
+// Returns the identifier the property was registered under.
+PropertyId PropertyDefinition::GetId() const
+{
+	return id;
+}
+
+// Returns the number of parsers registered on this definition.
+int PropertyDefinition::GetNumParsers() const
+{
+	return (int) parsers.size();
+}
+
+// Returns the name of one of this definition's parsers.
+const String& PropertyDefinition::GetParserName(int index) const
+{
+	return parsers[index].name;
+}
+
+// Returns the validation parameters of one of this definition's parsers.
+const ParameterMap& PropertyDefinition::GetParserParameters(int index) const
+{
+	return parsers[index].parameters;
+}
+
 }
 }
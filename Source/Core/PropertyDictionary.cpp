@@ -27,6 +27,7 @@
 
 #include "precompiled.h"
 #include <Rocket/Core/PropertyDictionary.h>
+#include <Rocket/Core/StyleSheetSpecification.h>
 
 namespace Rocket {
 namespace Core {
@@ -35,22 +36,62 @@ PropertyDictionary::PropertyDictionary()
 {
 }
 
+PropertyDictionary::PropertyDictionary(const PropertyDictionary& copy) : properties(copy.properties)
+{
+	BuildIndex();
+}
+
 PropertyDictionary::~PropertyDictionary()
 {
 }
 
+PropertyDictionary& PropertyDictionary::operator=(const PropertyDictionary& copy)
+{
+	if (this != &copy)
+	{
+		properties = copy.properties;
+		BuildIndex();
+	}
+
+	return *this;
+}
+
 // Sets a property on the dictionary. Any existing property with a similar name will be overwritten.
 void PropertyDictionary::SetProperty(const String& name, const Property& property)
 {
-	properties[name] = property;
+	StoreProperty(StyleSheetSpecification::GetPropertyId(name), name, property);
+}
+
+// Sets a registered property on the dictionary.
+void PropertyDictionary::SetProperty(PropertyId id, const Property& property)
+{
+	const String& name = StyleSheetSpecification::GetPropertyName(id);
+	if (name.Empty())
+		return;
+
+	StoreProperty(id, name, property);
 }
 
 // Removes a property from the dictionary, if it exists.
 void PropertyDictionary::RemoveProperty(const String& name)
 {
+	PropertyId id = StyleSheetSpecification::GetPropertyId(name);
+	if (id >= 0 && id < (PropertyId) property_index.size())
+		property_index[id] = NULL;
+
 	properties.erase(name);
 }
 
+// Removes a registered property from the dictionary, if it exists.
+void PropertyDictionary::RemoveProperty(PropertyId id)
+{
+	if (GetProperty(id) == NULL)
+		return;
+
+	property_index[id] = NULL;
+	properties.erase(StyleSheetSpecification::GetPropertyName(id));
+}
+
 // Returns the value of the property with the requested name, if one exists.
 const Property* PropertyDictionary::GetProperty(const String& name) const
 {
@@ -61,6 +102,15 @@ const Property* PropertyDictionary::GetProperty(const String& name) const
 	return &(*iterator).second;
 }
 
+// Returns the value of the registered property with the requested identifier, if one exists.
+const Property* PropertyDictionary::GetProperty(PropertyId id) const
+{
+	if (id < 0 || id >= (PropertyId) property_index.size())
+		return NULL;
+
+	return property_index[id];
+}
+
 // Returns the number of properties in the dictionary.
 int PropertyDictionary::GetNumProperties() const
 {
@@ -101,9 +151,41 @@ void PropertyDictionary::SetProperty(const String& name, const Rocket::Core::Pro
 		iterator->second.specificity > specificity)
 		return;
 
-	Property& new_property = (properties[name] = property);
+	Property& new_property = StoreProperty(StyleSheetSpecification::GetPropertyId(name), name, property);
 	new_property.specificity = specificity;
 }
 
+// Stores a property under its name and identifier.
+Property& PropertyDictionary::StoreProperty(PropertyId id, const String& name, const Property& property)
+{
+	Property& new_property = (properties[name] = property);
+
+	if (id >= 0)
+	{
+		if (id >= (PropertyId) property_index.size())
+			property_index.resize(id + 1, NULL);
+		property_index[id] = &new_property;
+	}
+
+	return new_property;
+}
+
+// Rebuilds the identifier index from the property map.
+void PropertyDictionary::BuildIndex()
+{
+	property_index.clear();
+
+	for (PropertyMap::iterator iterator = properties.begin(); iterator != properties.end(); ++iterator)
+	{
+		PropertyId id = StyleSheetSpecification::GetPropertyId(iterator->first);
+		if (id < 0)
+			continue;
+
+		if (id >= (PropertyId) property_index.size())
+			property_index.resize(id + 1, NULL);
+		property_index[id] = &iterator->second;
+	}
+}
+
 }
 }
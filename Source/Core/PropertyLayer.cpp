@@ -0,0 +1,103 @@
+/*
+ * This source file is part of libRocket, the HTML/CSS Interface Middleware
+ *
+ * For the latest information, see http://www.librocket.com
+ *
+ * Copyright (c) 2008-2010 CodePoint Ltd, Shift Technology Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+#include "precompiled.h"
+#include "PropertyLayer.h"
+
+namespace Rocket {
+namespace Core {
+
+PropertyLayer::PropertyLayer(const StringList& pseudo_classes) : pseudo_class_rule(pseudo_classes)
+{
+	declares_property_groups = -1;
+}
+
+PropertyLayer::PropertyLayer(const PropertyLayer& copy) : ReferenceCountable(), properties(copy.properties), pseudo_class_rule(copy.pseudo_class_rule)
+{
+	declares_property_groups = copy.declares_property_groups;
+}
+
+PropertyLayer::~PropertyLayer()
+{
+}
+
+// Returns the layer's properties.
+const PropertyDictionary& PropertyLayer::GetProperties() const
+{
+	return properties;
+}
+
+// Returns the layer's properties for modification.
+PropertyDictionary& PropertyLayer::GetWritableProperties()
+{
+	ROCKET_ASSERT(GetReferenceCount() <= 1);
+
+	declares_property_groups = -1;
+	return properties;
+}
+
+// Returns the pseudo-classes an element must have for the layer to apply.
+const PseudoClassRule& PropertyLayer::GetPseudoClassRule() const
+{
+	return pseudo_class_rule;
+}
+
+// Returns true if the layer declares any decorators or font effects.
+bool PropertyLayer::DeclaresPropertyGroups() const
+{
+	if (declares_property_groups < 0)
+	{
+		static const String group_suffixes[] = { "-decorator", "-font-effect" };
+
+		declares_property_groups = 0;
+		for (PropertyMap::const_iterator i = properties.GetProperties().begin(); i != properties.GetProperties().end() && declares_property_groups == 0; ++i)
+		{
+			const String& property_name = (*i).first;
+			for (int j = 0; j < 2; ++j)
+			{
+				if (property_name.Length() > group_suffixes[j].Length() &&
+					strcasecmp(property_name.CString() + (property_name.Length() - group_suffixes[j].Length()), group_suffixes[j].CString()) == 0)
+				{
+					declares_property_groups = 1;
+					break;
+				}
+			}
+		}
+	}
+
+	return declares_property_groups != 0;
+}
+
+// Destroys the layer.
+void PropertyLayer::OnReferenceDeactivate()
+{
+	delete this;
+}
+
+}
+}
@@ -0,0 +1,82 @@
+/*
+ * This source file is part of libRocket, the HTML/CSS Interface Middleware
+ *
+ * For the latest information, see http://www.librocket.com
+ *
+ * Copyright (c) 2008-2010 CodePoint Ltd, Shift Technology Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+#ifndef ROCKETCOREPROPERTYLAYER_H
+#define ROCKETCOREPROPERTYLAYER_H
+
+#include <Rocket/Core/PropertyDictionary.h>
+#include <Rocket/Core/ReferenceCountable.h>
+#include "PseudoClassRegistry.h"
+
+namespace Rocket {
+namespace Core {
+
+/**
+	The properties declared by a single style sheet node, along with the pseudo-classes the node requires. A node's
+	layer is shared with every element definition the node applies to, so definitions only reference the layers of
+	their nodes rather than each holding a copy of the properties. The layer is copied on write; if the node changes
+	its properties while the layer is shared, the node takes a private copy and the definitions keep the original.
+ */
+
+class PropertyLayer : public ReferenceCountable
+{
+public:
+	/// Constructs an empty layer.
+	/// @param[in] pseudo_classes The pseudo-classes an element must have for the layer to apply.
+	PropertyLayer(const StringList& pseudo_classes);
+	/// Constructs a layer with a copy of another layer's properties.
+	PropertyLayer(const PropertyLayer& copy);
+	virtual ~PropertyLayer();
+
+	/// Returns the layer's properties.
+	const PropertyDictionary& GetProperties() const;
+	/// Returns the layer's properties for modification. This must only be called by the owner of an unshared layer.
+	PropertyDictionary& GetWritableProperties();
+
+	/// Returns the pseudo-classes an element must have for the layer to apply.
+	const PseudoClassRule& GetPseudoClassRule() const;
+
+	/// Returns true if the layer declares any decorators or font effects.
+	bool DeclaresPropertyGroups() const;
+
+protected:
+	/// Destroys the layer.
+	virtual void OnReferenceDeactivate();
+
+private:
+	PropertyDictionary properties;
+	PseudoClassRule pseudo_class_rule;
+
+	// Whether the properties declare any decorators or font effects; -1 if not yet known.
+	mutable int declares_property_groups;
+};
+
+}
+}
+
+#endif
@@ -0,0 +1,114 @@
+/*
+ * This source file is part of libRocket, the HTML/CSS Interface Middleware
+ *
+ * For the latest information, see http://www.librocket.com
+ *
+ * Copyright (c) 2008-2010 CodePoint Ltd, Shift Technology Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+#include "precompiled.h"
+#include "PropertyParseCache.h"
+
+namespace Rocket {
+namespace Core {
+
+PropertyParseCache::PropertyParseCache(size_t _max_entries) : max_entries(_max_entries)
+{
+	num_entries = 0;
+}
+
+PropertyParseCache::~PropertyParseCache()
+{
+}
+
+// Looks up a parsed declaration, marking it as recently used.
+const PropertyDictionary* PropertyParseCache::Find(const String& name, const String& value)
+{
+	Hash hash = GetHash(name, value);
+
+	std::pair< EntryIndex::iterator, EntryIndex::iterator > range = index.equal_range(hash);
+	for (EntryIndex::iterator i = range.first; i != range.second; ++i)
+	{
+		EntryList::iterator entry = (*i).second;
+		if ((*entry).name == name &&
+			(*entry).value == value)
+		{
+			entries.splice(entries.begin(), entries, entry);
+			return &(*entry).properties;
+		}
+	}
+
+	return NULL;
+}
+
+// Adds a successfully parsed declaration to the cache.
+void PropertyParseCache::Insert(const String& name, const String& value, const PropertyDictionary& properties)
+{
+	if (max_entries == 0)
+		return;
+
+	// Evict the least-recently-used entry if we're full.
+	if (num_entries >= max_entries)
+	{
+		EntryList::iterator oldest = --entries.end();
+
+		std::pair< EntryIndex::iterator, EntryIndex::iterator > range = index.equal_range((*oldest).hash);
+		for (EntryIndex::iterator i = range.first; i != range.second; ++i)
+		{
+			if ((*i).second == oldest)
+			{
+				index.erase(i);
+				break;
+			}
+		}
+
+		entries.erase(oldest);
+		num_entries--;
+	}
+
+	entries.push_front(Entry());
+	Entry& entry = entries.front();
+	entry.hash = GetHash(name, value);
+	entry.name = name;
+	entry.value = value;
+	entry.properties = properties;
+
+	index.insert(EntryIndex::value_type(entry.hash, entries.begin()));
+	num_entries++;
+}
+
+// Removes every declaration from the cache.
+void PropertyParseCache::Clear()
+{
+	index.clear();
+	entries.clear();
+	num_entries = 0;
+}
+
+Hash PropertyParseCache::GetHash(const String& name, const String& value)
+{
+	return name.Hash() * 31 + value.Hash();
+}
+
+}
+}
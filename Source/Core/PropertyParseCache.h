@@ -0,0 +1,88 @@
+/*
+ * This source file is part of libRocket, the HTML/CSS Interface Middleware
+ *
+ * For the latest information, see http://www.librocket.com
+ *
+ * Copyright (c) 2008-2010 CodePoint Ltd, Shift Technology Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+#ifndef ROCKETCOREPROPERTYPARSECACHE_H
+#define ROCKETCOREPROPERTYPARSECACHE_H
+
+#include <Rocket/Core/PropertyDictionary.h>
+#include <list>
+
+namespace Rocket {
+namespace Core {
+
+/**
+	A least-recently-used cache of parsed property declarations, keyed on the declaration's name and value. This
+	lets values set repeatedly from code, such as positions or colours updated every frame, skip the property parsers.
+ */
+
+class PropertyParseCache
+{
+public:
+	/// Constructs the cache.
+	/// @param[in] max_entries The number of declarations the cache will hold before evicting the oldest.
+	PropertyParseCache(size_t max_entries);
+	~PropertyParseCache();
+
+	/// Looks up a parsed declaration, marking it as recently used.
+	/// @param[in] name The name of the declared property.
+	/// @param[in] value The value of the declaration.
+	/// @return The properties the declaration was parsed into, or NULL if it isn't cached.
+	const PropertyDictionary* Find(const String& name, const String& value);
+	/// Adds a successfully parsed declaration to the cache.
+	/// @param[in] name The name of the declared property.
+	/// @param[in] value The value of the declaration.
+	/// @param[in] properties The properties the declaration was parsed into.
+	void Insert(const String& name, const String& value, const PropertyDictionary& properties);
+	/// Removes every declaration from the cache.
+	void Clear();
+
+private:
+	struct Entry
+	{
+		Hash hash;
+		String name;
+		String value;
+		PropertyDictionary properties;
+	};
+
+	// The entries, most-recently-used first.
+	typedef std::list< Entry > EntryList;
+	typedef std::multimap< Hash, EntryList::iterator > EntryIndex;
+
+	static Hash GetHash(const String& name, const String& value);
+
+	EntryList entries;
+	EntryIndex index;
+	size_t num_entries;
+	size_t max_entries;
+};
+
+}
+}
+
+#endif
@@ -31,6 +31,8 @@
 namespace Rocket {
 namespace Core {
 
+typedef std::pair< const char*, const char* > ComponentRange;
+
 PropertyParserColour::PropertyParserColour()
 {
 	html_colours["black"] = Colourb(0, 0, 0);
@@ -58,6 +60,55 @@ PropertyParserColour::~PropertyParserColour()
 {
 }
 
+// Splits a comma-separated list of colour components in place, as StringUtilities::ExpandString() would split it.
+// Returns the number of components found, which may be more than could be stored.
+static int SplitComponents(ComponentRange* components, int max_components, const char* begin, const char* end)
+{
+	int num_components = 0;
+
+	char quote = 0;
+	bool last_char_delimiter = true;
+	const char* start_ptr = NULL;
+	const char* end_ptr = begin;
+
+	for (const char* ptr = begin; ptr < end && *ptr; ++ptr)
+	{
+		if (last_char_delimiter && !quote && (*ptr == '"' || *ptr == '\''))
+		{
+			quote = *ptr;
+		}
+		else if (*ptr == quote && *(ptr - 1) != '\\')
+		{
+			quote = 0;
+		}
+		else if (*ptr == ',' && !quote)
+		{
+			if (num_components < max_components)
+				components[num_components] = start_ptr != NULL ? ComponentRange(start_ptr, end_ptr + 1) : ComponentRange(ptr, ptr);
+			num_components++;
+
+			last_char_delimiter = true;
+			start_ptr = NULL;
+		}
+		else if (!isspace(*ptr) || quote)
+		{
+			if (!start_ptr)
+				start_ptr = ptr;
+			end_ptr = ptr;
+			last_char_delimiter = false;
+		}
+	}
+
+	if (start_ptr)
+	{
+		if (num_components < max_components)
+			components[num_components] = ComponentRange(start_ptr, end_ptr + 1);
+		num_components++;
+	}
+
+	return num_components;
+}
+
 // Called to parse a RCSS colour declaration.
 bool PropertyParserColour::ParseValue(Property& property, const String& value, const ParameterMap& ROCKET_UNUSED(parameters)) const
 {
@@ -109,38 +160,52 @@ bool PropertyParserColour::ParseValue(Property& property, const String& value, c
 			colour[i] = (byte) (tens * 16 + ones);
 		}
 	}
-	else if (value.Substring(0, 3) == "rgb")
+	else if (strncmp(value.CString(), "rgb", 3) == 0)
 	{
-		StringList values;
+		// Find the component list between the brackets, and split it in place.
+		const char* components_begin = value.CString();
+		const char* components_end = value.CString() + value.Length();
+
+		size_t open_bracket = value.Find("(");
+		if (open_bracket != String::npos)
+			components_begin += open_bracket + 1;
+
+		size_t close_bracket = value.RFind(")");
+		if (close_bracket != String::npos &&
+			value.CString() + close_bracket >= components_begin)
+			components_end = value.CString() + close_bracket;
 
-		int find = value.Find("(") + 1;
-		StringUtilities::ExpandString(values, value.Substring(find, value.RFind(")") - find), ',');
+		ComponentRange components[5];
+		int num_components = SplitComponents(components, 5, components_begin, components_end);
 
 		// Check if we're parsing an 'rgba' or 'rgb' colour declaration.
 		if (value.Length() > 3 && value[3] == 'a')
 		{
-			if (values.size() != 4)
+			if (num_components != 4)
 				return false;
 		}
 		else
 		{
-			if (values.size() != 3)
+			if (num_components != 3)
 				return false;
-
-			values.push_back("255");
 		}
 
-		// Parse the three RGB values.
-		for (int i = 0; i < 4; ++i)
+		// Parse the three RGB values, and the alpha if it was given.
+		colour.alpha = 255;
+		for (int i = 0; i < num_components; ++i)
 		{
-			int component;
+			const char* component_begin = components[i].first;
+			const char* component_end = components[i].second;
 
-			// We're parsing a percentage value.
-			if (values[i].Length() > 0 && values[i][values[i].Length() - 1] == '%')
-				component = Math::RealToInteger((float) (atof(values[i].Substring(0, values[i].Length() - 1).CString()) / 100.0f) * 255.0f);
+			int component;
+			// We're parsing a percentage value. The number ends at the '%', or before it.
+			if (component_end > component_begin && *(component_end - 1) == '%')
+				component = Math::RealToInteger((float) (strtod(component_begin, NULL) / 100.0f) * 255.0f);
 			// We're parsing a 0 -> 255 integer value.
+			else if (component_end > component_begin)
+				component = (int) Math::Clamp(strtol(component_begin, NULL, 10), -1L, 256L);
 			else
-				component = atoi(values[i].CString());
+				component = 0;
 
 			colour[i] = (byte) (Math::Clamp(component, 0, 255));
 		}
@@ -68,14 +68,15 @@ bool PropertyParserNumber::ParseValue(Property& property, const String& value, c
 		}
 	}
 
-	float float_value;
-	if (sscanf(value.CString(), "%f", &float_value) == 1)
-	{
-		property.value = Variant(float_value);
-		return true;
-	}
+	// Parse the number in place; the unit suffix terminates it.
+	const char* number = value.CString();
+	char* number_end;
+	double number_value = strtod(number, &number_end);
+	if (number_end == number)
+		return false;
 
-	return false;
+	property.value = Variant((float) number_value);
+	return true;
 }
 
 // Destroys the parser.
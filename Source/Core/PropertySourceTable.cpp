@@ -0,0 +1,130 @@
+/*
+ * This source file is part of libRocket, the HTML/CSS Interface Middleware
+ *
+ * For the latest information, see http://www.librocket.com
+ *
+ * Copyright (c) 2008-2010 CodePoint Ltd, Shift Technology Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+#include "precompiled.h"
+#include "PropertySourceTable.h"
+
+namespace Rocket {
+namespace Core {
+
+// A source file's index in the table of file names, and a line number within it.
+typedef std::pair< int, int > SourceKey;
+typedef std::map< SourceKey, int > SourceIndexMap;
+typedef std::map< String, int > SourceFileMap;
+
+static StringList source_files;
+static SourceFileMap source_file_indices;
+
+static std::vector< SourceKey > sources;
+static SourceIndexMap source_indices;
+
+// True while the table is shared between threads.
+static bool read_only = false;
+
+// Returns the index of a source, interning it if it hasn't been seen before.
+int PropertySourceTable::GetIndex(const String& source, int source_line_number)
+{
+	if (source.Empty() &&
+		source_line_number == 0)
+		return NO_SOURCE;
+
+	if (read_only)
+	{
+		ROCKET_ERRORMSG("Property source interned while the source table is read-only.");
+		return NO_SOURCE;
+	}
+
+	// The unknown source takes the first entry.
+	if (sources.empty())
+	{
+		source_files.push_back(String());
+		source_file_indices[String()] = 0;
+		sources.push_back(SourceKey(0, 0));
+		source_indices[SourceKey(0, 0)] = NO_SOURCE;
+	}
+
+	int file_index;
+	SourceFileMap::const_iterator file_iterator = source_file_indices.find(source);
+	if (file_iterator != source_file_indices.end())
+		file_index = (*file_iterator).second;
+	else
+	{
+		file_index = (int) source_files.size();
+		source_files.push_back(source);
+		source_file_indices[source] = file_index;
+	}
+
+	SourceKey key(file_index, source_line_number);
+	SourceIndexMap::const_iterator iterator = source_indices.find(key);
+	if (iterator != source_indices.end())
+		return (*iterator).second;
+
+	int index = (int) sources.size();
+	sources.push_back(key);
+	source_indices[key] = index;
+
+	return index;
+}
+
+// Returns the file of an interned source.
+String PropertySourceTable::GetSource(int index)
+{
+	if (index <= NO_SOURCE ||
+		index >= (int) sources.size())
+		return String();
+
+	return source_files[sources[index].first];
+}
+
+// Returns the line number of an interned source.
+int PropertySourceTable::GetSourceLineNumber(int index)
+{
+	if (index <= NO_SOURCE ||
+		index >= (int) sources.size())
+		return 0;
+
+	return sources[index].second;
+}
+
+// Sets whether the table is read-only.
+void PropertySourceTable::SetReadOnly(bool _read_only)
+{
+	read_only = _read_only;
+}
+
+// Releases every interned source.
+void PropertySourceTable::Shutdown()
+{
+	StringList().swap(source_files);
+	source_file_indices.clear();
+	std::vector< SourceKey >().swap(sources);
+	source_indices.clear();
+}
+
+}
+}
@@ -0,0 +1,79 @@
+/*
+ * This source file is part of libRocket, the HTML/CSS Interface Middleware
+ *
+ * For the latest information, see http://www.librocket.com
+ *
+ * Copyright (c) 2008-2010 CodePoint Ltd, Shift Technology Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+#ifndef ROCKETCOREPROPERTYSOURCETABLE_H
+#define ROCKETCOREPROPERTYSOURCETABLE_H
+
+#include <Rocket/Core/Types.h>
+
+namespace Rocket {
+namespace Core {
+
+/**
+	Interns the sources properties are declared in, so each property only needs to store a small index. The table is
+	only read to report where a property came from, such as by the debugger.
+
+	The table isn't synchronised. Sources are only interned as style sheets and declarations are parsed, which happens
+	on the thread updating the contexts; while layout tasks are running concurrently the table is made read-only, and
+	can then be read from any thread.
+ */
+
+class PropertySourceTable
+{
+public:
+	/// The index of an unknown source, such as for properties set from code or inline.
+	static const int NO_SOURCE = 0;
+
+	/// Returns the index of a source, interning it if it hasn't been seen before.
+	/// @param[in] source The file the property was declared in.
+	/// @param[in] source_line_number The line the property was declared on.
+	/// @return The source's index.
+	static int GetIndex(const String& source, int source_line_number);
+
+	/// Returns the file of an interned source. It is returned by value, as the table may grow after it returns.
+	/// @param[in] index The source's index.
+	/// @return The file, or an empty string if the index is invalid.
+	static String GetSource(int index);
+	/// Returns the line number of an interned source.
+	/// @param[in] index The source's index.
+	/// @return The line number, or 0 if the index is invalid.
+	static int GetSourceLineNumber(int index);
+
+	/// Sets whether the table is read-only. While read-only, no new sources can be interned, so the table can be read
+	/// from threads formatting layout concurrently.
+	/// @param[in] read_only True to make the table read-only, false to allow sources to be interned again.
+	static void SetReadOnly(bool read_only);
+
+	/// Releases every interned source. This is called by Core::Shutdown(), once all properties have been released.
+	static void Shutdown();
+};
+
+}
+}
+
+#endif
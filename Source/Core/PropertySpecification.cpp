@@ -28,6 +28,7 @@
 #include "precompiled.h"
 #include <Rocket/Core/PropertySpecification.h>
 #include "PropertyShorthandDefinition.h"
+#include "PropertySourceTable.h"
 #include <Rocket/Core/Log.h>
 #include <Rocket/Core/PropertyDefinition.h>
 #include <Rocket/Core/PropertyDictionary.h>
@@ -54,25 +55,34 @@ PropertyDefinition& PropertySpecification::RegisterProperty(const String& proper
 {
 	String lower_case_name = property_name.ToLower();
 
-	// Create the property and validate the default value.
-	PropertyDefinition* property_definition = new PropertyDefinition(default_value, inherited, forces_layout);
-
-	// Delete any existing property.
+	// Delete any existing property; the new definition takes over its identifier.
+	PropertyId id;
 	PropertyMap::iterator iterator = properties.find(lower_case_name);
 	if (iterator != properties.end())
 	{
+		id = (*iterator).second->GetId();
 		delete (*iterator).second;
 	}
 	else
 	{
+		id = (PropertyId) property_index.size();
+		property_index.push_back(NULL);
+		property_index_names.push_back(lower_case_name);
+
 		property_names.insert(lower_case_name);
+		property_ids.Insert(id);
 		if (inherited)
 		{
 			inherited_property_names.insert(lower_case_name);
+			inherited_property_ids.Insert(id);
 		}
 	}
 
+	// Create the property and validate the default value.
+	PropertyDefinition* property_definition = new PropertyDefinition(id, default_value, inherited, forces_layout);
+
 	properties[lower_case_name] = property_definition;
+	property_index[id] = property_definition;
 	return *property_definition;
 }
 
@@ -86,6 +96,35 @@ const PropertyDefinition* PropertySpecification::GetProperty(const String& prope
 	return (*iterator).second;
 }
 
+// Returns a property definition.
+const PropertyDefinition* PropertySpecification::GetProperty(PropertyId id) const
+{
+	if (id < 0 || id >= (PropertyId) property_index.size())
+		return NULL;
+
+	return property_index[id];
+}
+
+// Returns the identifier of a registered property.
+PropertyId PropertySpecification::GetPropertyId(const String& property_name) const
+{
+	PropertyMap::const_iterator iterator = properties.find(property_name);
+	if (iterator == properties.end())
+		return PROPERTY_INVALID;
+
+	return (*iterator).second->GetId();
+}
+
+// Returns the name a property was registered under.
+const String& PropertySpecification::GetPropertyName(PropertyId id) const
+{
+	static const String empty_name;
+	if (id < 0 || id >= (PropertyId) property_index_names.size())
+		return empty_name;
+
+	return property_index_names[id];
+}
+
 // Fetches a list of the names of all registered property definitions.
 const PropertyNameList& PropertySpecification::GetRegisteredProperties(void) const
 {
@@ -98,6 +137,18 @@ const PropertyNameList& PropertySpecification::GetRegisteredInheritedProperties(
 	return inherited_property_names;
 }
 
+// Returns the set of the identifiers of all registered property definitions.
+const PropertyIdSet& PropertySpecification::GetRegisteredPropertyIds() const
+{
+	return property_ids;
+}
+
+// Returns the set of the identifiers of all registered inherited property definitions.
+const PropertyIdSet& PropertySpecification::GetRegisteredInheritedPropertyIds() const
+{
+	return inherited_property_ids;
+}
+
 // Registers a shorthand property definition.
 bool PropertySpecification::RegisterShorthand(const String& shorthand_name, const String& property_names, ShorthandType type)
 {
@@ -165,11 +216,12 @@ bool PropertySpecification::ParsePropertyDeclaration(PropertyDictionary& diction
 	if (!ParsePropertyValues(property_values, property_value, property_definition == NULL) || property_values.size() == 0)
 		return false;
 
+	int source_index = PropertySourceTable::GetIndex(source_file, source_line_number);
+
 	if (property_definition != NULL)
 	{
 		Property new_property;
-		new_property.source = source_file;
-		new_property.source_line_number = source_line_number;
+		new_property.source_index = source_index;
 		if (property_definition->ParseValue(new_property, property_values[0]))
 		{
 			dictionary.SetProperty(lower_case_name, new_property);
@@ -199,8 +251,7 @@ bool PropertySpecification::ParsePropertyDeclaration(PropertyDictionary& diction
 						if (!shorthand_definition->properties[i].second->ParseValue(new_property, property_values[0]))
 							return false;
 
-						new_property.source = source_file;
-						new_property.source_line_number = source_line_number;
+						new_property.source_index = source_index;
 						dictionary.SetProperty(shorthand_definition->properties[i].first, new_property);
 					}
 				}
@@ -212,8 +263,7 @@ bool PropertySpecification::ParsePropertyDeclaration(PropertyDictionary& diction
 				{
 					// Parse the first value into the top and bottom properties.
 					Property new_property;
-					new_property.source = source_file;
-					new_property.source_line_number = source_line_number;
+					new_property.source_index = source_index;
 
 					if (!shorthand_definition->properties[0].second->ParseValue(new_property, property_values[0]))
 						return false;
@@ -240,8 +290,7 @@ bool PropertySpecification::ParsePropertyDeclaration(PropertyDictionary& diction
 				{
 					// Parse the first value into the top property.
 					Property new_property;
-					new_property.source = source_file;
-					new_property.source_line_number = source_line_number;
+					new_property.source_index = source_index;
 
 					if (!shorthand_definition->properties[0].second->ParseValue(new_property, property_values[0]))
 						return false;
@@ -274,8 +323,7 @@ bool PropertySpecification::ParsePropertyDeclaration(PropertyDictionary& diction
 			for (; value_index < property_values.size() && property_index < shorthand_definition->properties.size(); property_index++)
 			{
 				Property new_property;
-				new_property.source = source_file;
-				new_property.source_line_number = source_line_number;
+				new_property.source_index = source_index;
 
 				if (!shorthand_definition->properties[property_index].second->ParseValue(new_property, property_values[value_index]))
 				{
@@ -303,8 +351,7 @@ bool PropertySpecification::ParsePropertyDeclaration(PropertyDictionary& diction
 
 	// Can't find it! Store as an unknown string value.
 	Property new_property(property_value, Property::UNKNOWN);
-	new_property.source = source_file;
-	new_property.source_line_number = source_line_number;
+	new_property.source_index = source_index;
 	dictionary.SetProperty(lower_case_name, new_property);
 
 	return true;
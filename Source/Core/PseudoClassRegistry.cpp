@@ -0,0 +1,190 @@
+/*
+ * This source file is part of libRocket, the HTML/CSS Interface Middleware
+ *
+ * For the latest information, see http://www.librocket.com
+ *
+ * Copyright (c) 2008-2010 CodePoint Ltd, Shift Technology Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+#include "precompiled.h"
+#include "PseudoClassRegistry.h"
+
+namespace Rocket {
+namespace Core {
+
+typedef std::map< String, int > PseudoClassIdMap;
+
+static PseudoClassIdMap pseudo_class_ids;
+static StringList pseudo_class_names;
+// Set once the registry has been found to be full, so the warning is only logged once.
+static bool full_warning_logged = false;
+
+// Returns the identifier of a pseudo-class, interning it if it hasn't been seen before.
+int PseudoClassRegistry::GetId(const String& pseudo_class)
+{
+	PseudoClassIdMap::const_iterator iterator = pseudo_class_ids.find(pseudo_class);
+	if (iterator != pseudo_class_ids.end())
+		return (*iterator).second;
+
+	if ((int) pseudo_class_names.size() >= MAX_PSEUDO_CLASSES)
+	{
+		if (!full_warning_logged)
+		{
+			Log::Message(Log::LT_WARNING, "Unable to intern pseudo-class '%s'; the maximum of %d distinct pseudo-classes has been reached. Rules using this or any further pseudo-classes will be matched more slowly.", pseudo_class.CString(), MAX_PSEUDO_CLASSES);
+			full_warning_logged = true;
+		}
+
+		return -1;
+	}
+
+	int id = (int) pseudo_class_names.size();
+	pseudo_class_names.push_back(pseudo_class);
+	pseudo_class_ids[pseudo_class] = id;
+
+	return id;
+}
+
+// Returns the identifier of a pseudo-class if it has already been interned.
+int PseudoClassRegistry::FindId(const String& pseudo_class)
+{
+	PseudoClassIdMap::const_iterator iterator = pseudo_class_ids.find(pseudo_class);
+	if (iterator != pseudo_class_ids.end())
+		return (*iterator).second;
+
+	return -1;
+}
+
+// Forgets every interned pseudo-class.
+void PseudoClassRegistry::Shutdown()
+{
+	pseudo_class_ids.clear();
+	pseudo_class_names.clear();
+	full_warning_logged = false;
+}
+
+// Returns the name of an interned pseudo-class.
+const String& PseudoClassRegistry::GetName(int id)
+{
+	static String empty_name;
+	if (id < 0 ||
+		id >= (int) pseudo_class_names.size())
+		return empty_name;
+
+	return pseudo_class_names[id];
+}
+
+// Returns the mask bit for an interned pseudo-class.
+PseudoClassMask PseudoClassRegistry::GetMask(int id)
+{
+	if (id < 0 ||
+		id >= MAX_PSEUDO_CLASSES)
+		return 0;
+
+	return ((PseudoClassMask) 1) << id;
+}
+
+// Expands a mask into the list of the names of its pseudo-classes.
+void PseudoClassRegistry::GetPseudoClasses(PseudoClassList& pseudo_classes, PseudoClassMask mask)
+{
+	for (int id = 0; mask != 0 && id < (int) pseudo_class_names.size(); ++id)
+	{
+		PseudoClassMask bit = GetMask(id);
+		if (mask & bit)
+		{
+			pseudo_classes.insert(pseudo_class_names[id]);
+			mask &= ~bit;
+		}
+	}
+}
+
+PseudoClassRule::PseudoClassRule()
+{
+	mask = 0;
+	complete = true;
+}
+
+PseudoClassRule::PseudoClassRule(const StringList& _pseudo_classes) : pseudo_classes(_pseudo_classes)
+{
+	mask = 0;
+	complete = true;
+
+	for (size_t i = 0; i < pseudo_classes.size(); ++i)
+	{
+		int id = PseudoClassRegistry::GetId(pseudo_classes[i]);
+		if (id < 0)
+			complete = false;
+		else
+			mask |= PseudoClassRegistry::GetMask(id);
+	}
+}
+
+// Returns true if all of the rule's pseudo-classes are active on an element.
+bool PseudoClassRule::IsApplicable(const PseudoClassList& element_pseudo_classes, PseudoClassMask pseudo_class_mask) const
+{
+	if (complete)
+		return (mask & ~pseudo_class_mask) == 0;
+
+	for (size_t i = 0; i < pseudo_classes.size(); ++i)
+	{
+		if (element_pseudo_classes.find(pseudo_classes[i]) == element_pseudo_classes.end())
+			return false;
+	}
+
+	return true;
+}
+
+// Returns true if the rule requires a specific pseudo-class, and all of its other pseudo-classes are active on an
+// element.
+bool PseudoClassRule::IsApplicable(const PseudoClassList& element_pseudo_classes, PseudoClassMask pseudo_class_mask, const String& pseudo_class, int pseudo_class_id) const
+{
+	if (complete)
+	{
+		PseudoClassMask bit = PseudoClassRegistry::GetMask(pseudo_class_id);
+		return (mask & bit) != 0 &&
+			   (mask & ~(pseudo_class_mask | bit)) == 0;
+	}
+
+	bool found_pseudo_class = false;
+	for (size_t i = 0; i < pseudo_classes.size(); ++i)
+	{
+		if (pseudo_classes[i] == pseudo_class)
+		{
+			found_pseudo_class = true;
+			continue;
+		}
+
+		if (element_pseudo_classes.find(pseudo_classes[i]) == element_pseudo_classes.end())
+			return false;
+	}
+
+	return found_pseudo_class;
+}
+
+// Returns the names of the rule's pseudo-classes.
+const StringList& PseudoClassRule::GetPseudoClasses() const
+{
+	return pseudo_classes;
+}
+
+}
+}
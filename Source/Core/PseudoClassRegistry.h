@@ -0,0 +1,118 @@
+/*
+ * This source file is part of libRocket, the HTML/CSS Interface Middleware
+ *
+ * For the latest information, see http://www.librocket.com
+ *
+ * Copyright (c) 2008-2010 CodePoint Ltd, Shift Technology Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+#ifndef ROCKETCOREPSEUDOCLASSREGISTRY_H
+#define ROCKETCOREPSEUDOCLASSREGISTRY_H
+
+#include <Rocket/Core/Types.h>
+
+namespace Rocket {
+namespace Core {
+
+/// A set of interned pseudo-classes, with one bit per pseudo-class identifier.
+typedef uint64_t PseudoClassMask;
+
+/**
+	Interns pseudo-class names into small integer identifiers, so sets of pseudo-classes can be stored and compared
+	as bitmasks.
+ */
+
+class PseudoClassRegistry
+{
+public:
+	/// The maximum number of distinct pseudo-classes that can be interned.
+	static const int MAX_PSEUDO_CLASSES = 64;
+
+	/// Returns the identifier of a pseudo-class, interning it if it hasn't been seen before.
+	/// @param[in] pseudo_class The name of the pseudo-class.
+	/// @return The pseudo-class's identifier, or -1 if the registry is full.
+	static int GetId(const String& pseudo_class);
+	/// Returns the identifier of a pseudo-class if it has already been interned. Only pseudo-classes referred to by
+	/// a style sheet are interned, so this is used for those set on elements.
+	/// @param[in] pseudo_class The name of the pseudo-class.
+	/// @return The pseudo-class's identifier, or -1 if it hasn't been interned.
+	static int FindId(const String& pseudo_class);
+	/// Returns the name of an interned pseudo-class.
+	/// @param[in] id The pseudo-class's identifier.
+	/// @return The name of the pseudo-class, or an empty string if the identifier is invalid.
+	static const String& GetName(int id);
+
+	/// Returns the mask bit for an interned pseudo-class.
+	/// @param[in] id The pseudo-class's identifier.
+	/// @return The pseudo-class's bit, or an empty mask if the identifier is invalid.
+	static PseudoClassMask GetMask(int id);
+	/// Expands a mask into the list of the names of its pseudo-classes.
+	/// @param[out] pseudo_classes The list to add the pseudo-class names to.
+	/// @param[in] mask The mask to expand.
+	static void GetPseudoClasses(PseudoClassList& pseudo_classes, PseudoClassMask mask);
+
+	/// Forgets every interned pseudo-class, so the library starts with an empty registry if it is initialised
+	/// again. This is called by Core::Shutdown(), once all style sheets and elements have been released.
+	static void Shutdown();
+};
+
+/**
+	The set of pseudo-classes a rule requires to be active on an element, stored as both their names and their
+	interned mask. The rule is normally checked against an element with a single mask comparison; only if some of its
+	pseudo-classes couldn't be interned are the names compared instead.
+ */
+
+class PseudoClassRule
+{
+public:
+	PseudoClassRule();
+	PseudoClassRule(const StringList& pseudo_classes);
+
+	/// Returns true if all of the rule's pseudo-classes are active on an element.
+	/// @param[in] pseudo_classes The pseudo-classes active on the element.
+	/// @param[in] pseudo_class_mask The mask of the pseudo-classes active on the element.
+	/// @return True if the rule applies to the element.
+	bool IsApplicable(const PseudoClassList& pseudo_classes, PseudoClassMask pseudo_class_mask) const;
+	/// Returns true if the rule requires a specific pseudo-class, and all of its other pseudo-classes are active on
+	/// an element.
+	/// @param[in] pseudo_classes The pseudo-classes active on the element.
+	/// @param[in] pseudo_class_mask The mask of the pseudo-classes active on the element.
+	/// @param[in] pseudo_class The pseudo-class the rule must require.
+	/// @param[in] pseudo_class_id The interned identifier of the pseudo-class the rule must require.
+	/// @return True if the rule involves the pseudo-class and otherwise applies to the element.
+	bool IsApplicable(const PseudoClassList& pseudo_classes, PseudoClassMask pseudo_class_mask, const String& pseudo_class, int pseudo_class_id) const;
+
+	/// Returns the names of the rule's pseudo-classes.
+	const StringList& GetPseudoClasses() const;
+
+private:
+	StringList pseudo_classes;
+	PseudoClassMask mask;
+	// False if some of the pseudo-classes are missing from the mask.
+	bool complete;
+};
+
+}
+}
+
+#endif
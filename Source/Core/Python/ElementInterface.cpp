@@ -72,9 +72,11 @@ void ElementInterface::InitialisePythonInterface()
 		.def("AddEventListener", AddEventListener)
 		.def("AddEventListener", AddEventListenerDefault)
 		.def("AppendChild", &ElementInterface::AppendChild)
+		.def("BeginStyleUpdate", &Element::BeginStyleUpdate)
 		.def("Blur", &Element::Blur)
 		.def("Click", &Element::Click)
 		.def("DispatchEvent", &ElementInterface::DispatchEvent)
+		.def("EndStyleUpdate", &Element::EndStyleUpdate)
 		.def("Focus", &Element::Focus)
 		.def("GetAttribute", python::make_function(&ElementInterface::GetAttribute, python::return_value_policy< python::return_by_value >()))
 		.def("GetElementById", &Element::GetElementById, python::return_value_policy< python::return_by_value >())
@@ -48,6 +48,10 @@ void ElementStyleProxy::InitialisePythonInterface()
 	python::class_<ElementStyleProxy>("styleproxy", python::no_init)
 		.def("__getattr__", &ElementStyleProxy::GetAttr, python::return_value_policy< python::return_by_value >())
 		.def("__setattr__", &ElementStyleProxy::SetAttr)
+		.def("__enter__", &ElementStyleProxy::Enter)
+		.def("__exit__", &ElementStyleProxy::Exit)
+		.def("BeginUpdate", &ElementStyleProxy::BeginUpdate)
+		.def("EndUpdate", &ElementStyleProxy::EndUpdate)
 		;
 }
 
@@ -74,6 +78,32 @@ Rocket::Core::String ElementStyleProxy::GetAttr(const char* _key)
 	return property->ToString();
 }
 
+void ElementStyleProxy::BeginUpdate()
+{
+	element->BeginStyleUpdate();
+}
+
+void ElementStyleProxy::EndUpdate()
+{
+	element->EndStyleUpdate();
+}
+
+python::object ElementStyleProxy::Enter(python::object self)
+{
+	ElementStyleProxy& proxy = python::extract< ElementStyleProxy& >(self);
+	proxy.BeginUpdate();
+
+	return self;
+}
+
+bool ElementStyleProxy::Exit(python::object ROCKET_UNUSED(type), python::object ROCKET_UNUSED(value), python::object ROCKET_UNUSED(traceback))
+{
+	EndUpdate();
+
+	// Don't suppress any exception raised within the block.
+	return false;
+}
+
 }
 }
 }
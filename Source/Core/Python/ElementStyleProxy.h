@@ -56,6 +56,16 @@ public:
 	void SetAttr(const char* key, const char* value);
 	/// Python GetAttr override
 	Rocket::Core::String GetAttr(const char* key);
+
+	/// Begins a batch of style changes on the element; the changes are propagated once when the batch ends
+	void BeginUpdate();
+	/// Ends a batch of style changes on the element
+	void EndUpdate();
+
+	/// Python context manager entry; begins a batch of style changes
+	static python::object Enter(python::object self);
+	/// Python context manager exit; ends the batch of style changes
+	bool Exit(python::object type, python::object value, python::object traceback);
 	
 private:
 	Element* element;
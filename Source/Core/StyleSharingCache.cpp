@@ -0,0 +1,85 @@
+/*
+ * This source file is part of libRocket, the HTML/CSS Interface Middleware
+ *
+ * For the latest information, see http://www.librocket.com
+ *
+ * Copyright (c) 2008-2010 CodePoint Ltd, Shift Technology Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+#include "precompiled.h"
+#include "StyleSharingCache.h"
+#include "ElementDefinition.h"
+#include "ElementStyle.h"
+
+namespace Rocket {
+namespace Core {
+
+StyleSharingCache::StyleSharingCache()
+{
+	num_entries = 0;
+	next_entry = 0;
+}
+
+// Looks for a definition that can be shared with an element.
+bool StyleSharingCache::Find(ElementDefinition*& definition, const ElementStyle* style, const StyleSheet* style_sheet) const
+{
+	for (int i = 0; i < num_entries; ++i)
+	{
+		const Entry& entry = entries[i];
+		if (entry.style_sheet == style_sheet &&
+			style->CanShareDefinition(*entry.style))
+		{
+			definition = entry.definition;
+			if (definition != NULL)
+				definition->AddReference();
+
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// Adds an element's newly generated definition to the cache.
+void StyleSharingCache::Insert(const ElementStyle* style, const StyleSheet* style_sheet, ElementDefinition* definition)
+{
+	if (definition != NULL &&
+		definition->IsStructurallyVolatile())
+		return;
+
+	Entry* entry;
+	if (num_entries < MAX_ENTRIES)
+		entry = &entries[num_entries++];
+	else
+	{
+		entry = &entries[next_entry];
+		next_entry = (next_entry + 1) % MAX_ENTRIES;
+	}
+
+	entry->style = style;
+	entry->style_sheet = style_sheet;
+	entry->definition = definition;
+}
+
+}
+}
@@ -0,0 +1,85 @@
+/*
+ * This source file is part of libRocket, the HTML/CSS Interface Middleware
+ *
+ * For the latest information, see http://www.librocket.com
+ *
+ * Copyright (c) 2008-2010 CodePoint Ltd, Shift Technology Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+#ifndef ROCKETCORESTYLESHARINGCACHE_H
+#define ROCKETCORESTYLESHARINGCACHE_H
+
+namespace Rocket {
+namespace Core {
+
+class ElementDefinition;
+class ElementStyle;
+class StyleSheet;
+
+/**
+	A short-lived cache of the definitions resolved for a group of related elements (siblings and cousins) during a
+	single definition update pass. Elements that are guaranteed to match exactly the same selectors as an element
+	already in the cache can take its definition instead of matching the style sheet again.
+
+	The cache holds no references on its definitions or styles; it must not outlive the update pass it was created
+	for.
+ */
+
+class StyleSharingCache
+{
+public:
+	StyleSharingCache();
+
+	/// Looks for a definition that can be shared with an element.
+	/// @param[out] definition The shared definition; this may be NULL if the elements have no definition. A reference is added if it isn't.
+	/// @param[in] style The style of the element looking for a definition.
+	/// @param[in] style_sheet The style sheet the element's definition would be generated from.
+	/// @return True if a definition was found, false if the element's definition must be generated.
+	bool Find(ElementDefinition*& definition, const ElementStyle* style, const StyleSheet* style_sheet) const;
+	/// Adds an element's newly generated definition to the cache. Structurally volatile definitions depend on the
+	/// element's position in the document, so they are never added.
+	/// @param[in] style The style of the element the definition was generated for.
+	/// @param[in] style_sheet The style sheet the definition was generated from.
+	/// @param[in] definition The element's definition. This may be NULL.
+	void Insert(const ElementStyle* style, const StyleSheet* style_sheet, ElementDefinition* definition);
+
+private:
+	static const int MAX_ENTRIES = 8;
+
+	struct Entry
+	{
+		const ElementStyle* style;
+		const StyleSheet* style_sheet;
+		ElementDefinition* definition;
+	};
+
+	Entry entries[MAX_ENTRIES];
+	int num_entries;
+	// The entry to replace when the cache is full.
+	int next_entry;
+};
+
+}
+}
+
+#endif
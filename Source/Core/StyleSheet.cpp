@@ -28,7 +28,10 @@
 #include "precompiled.h"
 #include <Rocket/Core/StyleSheet.h>
 #include <algorithm>
+#include "DefinitionCache.h"
 #include "ElementDefinition.h"
+#include "InvalidationMap.h"
+#include "StyleSheetBinary.h"
 #include "StyleSheetFactory.h"
 #include "StyleSheetNode.h"
 #include "StyleSheetParser.h"
@@ -39,6 +42,27 @@
 namespace Rocket {
 namespace Core {
 
+// The tag name that rules applying to any element are indexed under.
+static const String universal_tag;
+
+// Adds the nodes from a list that are applicable to an element into a list of applicable nodes.
+static void GetApplicableNodes(DefinitionCacheKey::NodeList& applicable_nodes, const StyleSheet::NodeList& nodes, const Element* element, const AncestorFilter* ancestor_filter)
+{
+	for (size_t i = 0; i < nodes.size(); ++i)
+	{
+		if (nodes[i]->IsSelectorApplicable(element, ancestor_filter))
+			applicable_nodes.push_back(nodes[i]);
+	}
+}
+
+// Adds the nodes from one bucket of an index that are applicable to an element into a list of applicable nodes.
+static void GetApplicableNodes(DefinitionCacheKey::NodeList& applicable_nodes, const StyleSheet::NodeIndex& index, const String& key, const Element* element, const AncestorFilter* ancestor_filter)
+{
+	StyleSheet::NodeIndex::const_iterator iterator = index.find(key);
+	if (iterator != index.end())
+		GetApplicableNodes(applicable_nodes, (*iterator).second, element, ancestor_filter);
+}
+
 // Sorts style nodes based on specificity.
 static bool StyleSheetNodeSort(const StyleSheetNode* lhs, const StyleSheetNode* rhs)
 {
@@ -49,18 +73,21 @@ StyleSheet::StyleSheet()
 {
 	root = new StyleSheetNode("", StyleSheetNode::ROOT);
 	specificity_offset = 0;
+	node_index_built = false;
+	invalidation_map = new InvalidationMap();
+
+	node_cache = new DefinitionCache();
+	node_match = new DefinitionMatch();
 }
 
 StyleSheet::~StyleSheet()
 {
 	delete root;
+	delete invalidation_map;
 
 	// Release our reference count on the cached element definitions.
-	for (ElementDefinitionCache::iterator cache_iterator = address_cache.begin(); cache_iterator != address_cache.end(); cache_iterator++)
-		(*cache_iterator).second->RemoveReference();
-
-	for (ElementDefinitionCache::iterator cache_iterator = node_cache.begin(); cache_iterator != node_cache.end(); cache_iterator++)
-		(*cache_iterator).second->RemoveReference();
+	delete node_cache;
+	delete node_match;
 }
 
 bool StyleSheet::LoadStyleSheet(Stream* stream)
@@ -70,6 +97,45 @@ bool StyleSheet::LoadStyleSheet(Stream* stream)
 	return specificity_offset >= 0;
 }
 
+// Loads a style sheet from its precompiled binary form.
+bool StyleSheet::LoadCompiledStyleSheet(const byte* data, size_t length, Stream* source)
+{
+	unsigned int source_length, source_hash;
+	StyleSheetBinary::GetSourceSignature(source_length, source_hash, source);
+
+	int compiled_specificity_offset;
+	StyleSheetBinaryReader reader(data, length);
+	if (!reader.ReadHeader(compiled_specificity_offset, source_length, source_hash))
+		return false;
+
+	// Read into a new tree, so we're left untouched if the compiled sheet turns out to be corrupt.
+	StyleSheetNode* compiled_root = new StyleSheetNode("", StyleSheetNode::ROOT);
+	if (!compiled_root->ReadBinary(reader, source->GetSourceURL().GetURL().Replace("|", ":")) ||
+		!reader.IsComplete())
+	{
+		delete compiled_root;
+		return false;
+	}
+
+	delete root;
+	root = compiled_root;
+	specificity_offset = compiled_specificity_offset;
+
+	return true;
+}
+
+// Writes the style sheet in its precompiled binary form.
+bool StyleSheet::WriteCompiledStyleSheet(Stream* stream, Stream* source) const
+{
+	unsigned int source_length, source_hash;
+	StyleSheetBinary::GetSourceSignature(source_length, source_hash, source);
+
+	StyleSheetBinaryWriter writer(stream);
+	writer.WriteHeader(source_length, source_hash, specificity_offset);
+
+	return root->WriteBinary(writer);
+}
+
 /// Combines this style sheet with another one, producing a new sheet
 StyleSheet* StyleSheet::CombineStyleSheet(const StyleSheet* other_sheet) const
 {
@@ -88,124 +154,138 @@ StyleSheet* StyleSheet::CombineStyleSheet(const StyleSheet* other_sheet) const
 // Builds the node index for a combined style sheet.
 void StyleSheet::BuildNodeIndex()
 {
-	if (complete_node_index.empty())
+	if (node_index_built)
+		return;
+
+	node_index_built = true;
+
+	NodeList indexed_nodes;
+	root->BuildIndex(indexed_nodes, structurally_volatile_tags);
+
+	String key;
+	for (size_t i = 0; i < indexed_nodes.size(); ++i)
 	{
-		styled_node_index.clear();
-		complete_node_index.clear();
+		indexed_nodes[i]->AddAncestorDependencies(*invalidation_map);
 
-		root->BuildIndex(styled_node_index, complete_node_index);
+		switch (indexed_nodes[i]->GetIndexKey(key))
+		{
+			case StyleSheetNode::ID:	id_node_index[key].push_back(indexed_nodes[i]); break;
+			case StyleSheetNode::CLASS:	class_node_index[key].push_back(indexed_nodes[i]); break;
+			default:
+			{
+				if (key.Empty())
+					universal_nodes.push_back(indexed_nodes[i]);
+				else
+					tag_node_index[key].push_back(indexed_nodes[i]);
+			}
+			break;
+		}
 	}
 }
 
 // Returns the compiled element definition for a given element hierarchy.
-ElementDefinition* StyleSheet::GetElementDefinition(const Element* element) const
+ElementDefinition* StyleSheet::GetElementDefinition(const Element* element, const AncestorFilter* ancestor_filter) const
 {
-	// Address cache is disabled for the time being; this doesn't work since the introduction of structural
-	// pseudo-classes.
-	ElementDefinitionCache::iterator cache_iterator;
-/*	String element_address = element->GetAddress();
+	MatchElement(*node_match, element, ancestor_filter);
+	return GetElementDefinition(*node_match);
+}
 
-	// Look the address up in the definition, see if we've processed a similar element before.
-	cache_iterator = address_cache.find(element_address);
-	if (cache_iterator != address_cache.end())
-	{
-		ElementDefinition* definition = (*cache_iterator).second;
-		definition->AddReference();
-		return definition;
-	}*/
+// Matches an element against the style sheet's rules, without looking up or creating its definition.
+void StyleSheet::MatchElement(DefinitionMatch& match, const Element* element, const AncestorFilter* ancestor_filter) const
+{
+	// See if there are any styles defined for this element. We only need to check the rules indexed under the
+	// element's id, classes and tag, and the universal rules. The applicable nodes are collected straight into the
+	// match's key, so the definition can be looked up without allocating.
+	match.key.Clear();
+	DefinitionCacheKey::NodeList& applicable_nodes = match.key.GetNodes();
 
-	// See if there are any styles defined for this element.
-	std::vector< const StyleSheetNode* > applicable_nodes;
+	if (!element->GetId().Empty())
+		GetApplicableNodes(applicable_nodes, id_node_index, element->GetId(), element, ancestor_filter);
 
-	String tags[] = {element->GetTagName(), ""};
-	for (int i = 0; i < 2; i++)
-	{
-		NodeIndex::const_iterator iterator = styled_node_index.find(tags[i]);
-		if (iterator != styled_node_index.end())
-		{
-			const NodeList& nodes = (*iterator).second;
+	const StringList& class_names = element->GetClassNameList();
+	for (size_t i = 0; i < class_names.size(); ++i)
+		GetApplicableNodes(applicable_nodes, class_node_index, class_names[i], element, ancestor_filter);
 
-			// There are! Now see if we satisfy all of their parenting requirements. What this involves is traversing the style
-			// nodes backwards, trying to match nodes in the element's hierarchy to nodes in the style hierarchy.
-			for (NodeList::const_iterator iterator = nodes.begin(); iterator != nodes.end(); iterator++)
-			{
-				if ((*iterator)->IsApplicable(element))
-				{
-					// Get the node to add any of its non-tag children that we match into our list.
-					(*iterator)->GetApplicableDescendants(applicable_nodes, element);
-				}
-			}
-		}
-	}
+	GetApplicableNodes(applicable_nodes, tag_node_index, element->GetTagName(), element, ancestor_filter);
+	GetApplicableNodes(applicable_nodes, universal_nodes, element, ancestor_filter);
 
 	std::sort(applicable_nodes.begin(), applicable_nodes.end(), StyleSheetNodeSort);
 
-	// Compile the list of volatile pseudo-classes for this element definition.
-	PseudoClassList volatile_pseudo_classes;
-	bool structurally_volatile = false;
+	// Compile the set of volatile pseudo-classes for this element definition.
+	match.volatile_pseudo_classes = 0;
+	match.volatile_pseudo_classes_complete = true;
+	for (size_t i = 0; i < applicable_nodes.size(); ++i)
+		applicable_nodes[i]->GetVolatilePseudoClasses(match.volatile_pseudo_classes, match.volatile_pseudo_classes_complete);
 
-	for (int i = 0; i < 2; ++i)
-	{
-		NodeIndex::const_iterator iterator = complete_node_index.find(tags[i]);
-		if (iterator != complete_node_index.end())
-		{
-			const NodeList& nodes = (*iterator).second;
-
-			// See if we satisfy all of the parenting requirements for each of these nodes (as in the previous loop).
-			for (NodeList::const_iterator iterator = nodes.begin(); iterator != nodes.end(); iterator++)
-			{
-				structurally_volatile |= (*iterator)->IsStructurallyVolatile();
+	match.structurally_volatile = IsStructurallyVolatile(element->GetTagName());
 
-				if ((*iterator)->IsApplicable(element))
-				{
-					std::vector< const StyleSheetNode* > volatile_nodes;
-					(*iterator)->GetApplicableDescendants(volatile_nodes, element);
+	match.key.Finalise(match.volatile_pseudo_classes);
+}
 
-					for (size_t i = 0; i < volatile_nodes.size(); ++i)
-						volatile_nodes[i]->GetVolatilePseudoClasses(volatile_pseudo_classes);
-				}
-			}
-		}
-	}
+// Returns the compiled element definition for the result of a match.
+ElementDefinition* StyleSheet::GetElementDefinition(const DefinitionMatch& match) const
+{
+	const DefinitionCacheKey::NodeList& applicable_nodes = match.key.GetNodes();
 
 	// If this element definition won't actually store any information, don't bother with it.
 	if (applicable_nodes.empty() &&
-		volatile_pseudo_classes.empty() &&
-		!structurally_volatile)
+		match.volatile_pseudo_classes == 0 &&
+		match.volatile_pseudo_classes_complete &&
+		!match.structurally_volatile)
 		return NULL;
 
 	// Check if this puppy has already been cached in the node index; it may be that it has already been created by an
 	// element with a different address but an identical output definition.
-	String node_ids;
-	for (size_t i = 0; i < applicable_nodes.size(); i++)
-		node_ids += String(10, "%x ", applicable_nodes[i]);
-	for (PseudoClassList::iterator i = volatile_pseudo_classes.begin(); i != volatile_pseudo_classes.end(); ++i)
-		node_ids += String(32, ":%s", (*i).CString());
-
-	cache_iterator = node_cache.find(node_ids);
-	if (cache_iterator != node_cache.end())
+	if (match.volatile_pseudo_classes_complete)
+	{
+		ElementDefinition* definition = node_cache->Find(match.key);
+		if (definition != NULL)
+		{
+			definition->AddReference();
+			return definition;
+		}
+	}
+
+	// Expand the volatile pseudo-classes for the new definition. If some couldn't be interned, we have to fall back to
+	// gathering their names directly (and can't cache the definition, as the key would be ambiguous).
+	PseudoClassList volatile_pseudo_class_names;
+	if (match.volatile_pseudo_classes_complete)
+		PseudoClassRegistry::GetPseudoClasses(volatile_pseudo_class_names, match.volatile_pseudo_classes);
+	else
 	{
-		ElementDefinition* definition = (*cache_iterator).second;
-		definition->AddReference();
-		return definition;
+		for (size_t i = 0; i < applicable_nodes.size(); ++i)
+			applicable_nodes[i]->GetVolatilePseudoClasses(volatile_pseudo_class_names);
 	}
 
 	// Create the new definition and add it to our cache. One reference count is added, bringing the total to two; one
 	// for the element that requested it, and one for the cache.
 	ElementDefinition* new_definition = new ElementDefinition();
-	new_definition->Initialise(applicable_nodes, volatile_pseudo_classes, structurally_volatile);
-
-	// Add to the address cache.
-//	address_cache[element_address] = new_definition;
-//	new_definition->AddReference();
+	new_definition->Initialise(applicable_nodes, volatile_pseudo_class_names, match.structurally_volatile);
 
 	// Add to the node cache.
-	node_cache[node_ids] = new_definition;
-	new_definition->AddReference();
+	if (match.volatile_pseudo_classes_complete)
+		node_cache->Insert(match.key, new_definition);
 
 	return new_definition;
 }
 
+// Returns true if elements with the given tag may be matched by rules using structural pseudo-classes.
+bool StyleSheet::IsStructurallyVolatile(const String& tag) const
+{
+	return !structurally_volatile_tags.empty() &&
+		   (structurally_volatile_tags.find(tag) != structurally_volatile_tags.end() ||
+			structurally_volatile_tags.find(universal_tag) != structurally_volatile_tags.end());
+}
+
+// Returns the map of the style sheet's rules depending on their subjects' ancestors.
+const InvalidationMap* StyleSheet::GetInvalidationMap() const
+{
+	if (!node_index_built)
+		return NULL;
+
+	return invalidation_map;
+}
+
 // Destroys the style sheet.
 void StyleSheet::OnReferenceDeactivate()
 {
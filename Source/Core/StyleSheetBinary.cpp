@@ -0,0 +1,507 @@
+/*
+ * This source file is part of libRocket, the HTML/CSS Interface Middleware
+ *
+ * For the latest information, see http://www.librocket.com
+ *
+ * Copyright (c) 2008-2010 CodePoint Ltd, Shift Technology Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+#include "precompiled.h"
+#include "StyleSheetBinary.h"
+#include <Rocket/Core/Property.h>
+#include <Rocket/Core/Stream.h>
+#include <Rocket/Core/StyleSheetSpecification.h>
+
+namespace Rocket {
+namespace Core {
+
+static const byte MAGIC[4] = { 'R', 'C', 'S', 'C' };
+
+static const unsigned int HASH_SEED = 2166136261u;
+
+// Folds a block of data into an FNV-1a hash.
+static void HashData(unsigned int& hash, const void* data, size_t length)
+{
+	const byte* bytes = (const byte*) data;
+	for (size_t i = 0; i < length; ++i)
+		hash = (hash ^ bytes[i]) * 16777619u;
+}
+
+// Folds a string, and its terminator, into an FNV-1a hash.
+static void HashString(unsigned int& hash, const String& value)
+{
+	HashData(hash, value.CString(), value.Length() + 1);
+}
+
+// Folds an integer into an FNV-1a hash, independently of the platform's byte order.
+static void HashInt(unsigned int& hash, int value)
+{
+	byte bytes[4] = { (byte) (value & 0xFF), (byte) ((value >> 8) & 0xFF), (byte) ((value >> 16) & 0xFF), (byte) ((value >> 24) & 0xFF) };
+	HashData(hash, bytes, sizeof(bytes));
+}
+
+// Computes the signature of an RCSS source.
+void StyleSheetBinary::GetSourceSignature(unsigned int& length, unsigned int& hash, Stream* source)
+{
+	source->Seek(0, SEEK_SET);
+
+	length = 0;
+	hash = HASH_SEED;
+
+	byte buffer[4096];
+	size_t bytes_read;
+	while ((bytes_read = source->Read(buffer, sizeof(buffer))) > 0)
+	{
+		HashData(hash, buffer, bytes_read);
+		length += (unsigned int) bytes_read;
+	}
+
+	source->Seek(0, SEEK_SET);
+}
+
+// Computes the signature of the properties currently registered with the style sheet specification.
+unsigned int StyleSheetBinary::GetSpecificationSignature()
+{
+	unsigned int hash = HASH_SEED;
+
+	// The registered names are held in a set, so they are visited in the same order whatever order they were
+	// registered in.
+	const PropertyNameList& property_names = StyleSheetSpecification::GetRegisteredProperties();
+	for (PropertyNameList::const_iterator i = property_names.begin(); i != property_names.end(); ++i)
+	{
+		const PropertyDefinition* definition = StyleSheetSpecification::GetProperty(*i);
+		if (definition == NULL)
+			continue;
+
+		HashString(hash, *i);
+
+		int num_parsers = definition->GetNumParsers();
+		HashInt(hash, num_parsers);
+		for (int j = 0; j < num_parsers; ++j)
+		{
+			HashString(hash, definition->GetParserName(j));
+
+			const ParameterMap& parameters = definition->GetParserParameters(j);
+			HashInt(hash, (int) parameters.size());
+			for (ParameterMap::const_iterator k = parameters.begin(); k != parameters.end(); ++k)
+			{
+				HashString(hash, (*k).first);
+				HashInt(hash, (*k).second);
+			}
+		}
+	}
+
+	return hash;
+}
+
+StyleSheetBinaryWriter::StyleSheetBinaryWriter(Stream* _stream) : stream(_stream)
+{
+}
+
+// Writes the format's header.
+void StyleSheetBinaryWriter::WriteHeader(unsigned int source_length, unsigned int source_hash, int specificity_offset)
+{
+	stream->Write(MAGIC, sizeof(MAGIC));
+	WriteUInt(StyleSheetBinary::VERSION);
+	WriteUInt(StyleSheetBinary::GetSpecificationSignature());
+	WriteUInt(source_length);
+	WriteUInt(source_hash);
+	WriteInt(specificity_offset);
+}
+
+void StyleSheetBinaryWriter::WriteByte(byte value)
+{
+	stream->Write(&value, 1);
+}
+
+void StyleSheetBinaryWriter::WriteUInt(unsigned int value)
+{
+	byte bytes[4] = { (byte) value, (byte) (value >> 8), (byte) (value >> 16), (byte) (value >> 24) };
+	stream->Write(bytes, sizeof(bytes));
+}
+
+void StyleSheetBinaryWriter::WriteInt(int value)
+{
+	WriteUInt((unsigned int) value);
+}
+
+void StyleSheetBinaryWriter::WriteFloat(float value)
+{
+	unsigned int bits;
+	memcpy(&bits, &value, sizeof(bits));
+	WriteUInt(bits);
+}
+
+void StyleSheetBinaryWriter::WriteString(const String& value)
+{
+	WriteUInt(value.Length());
+	stream->Write(value.CString(), value.Length());
+}
+
+// Writes a parsed property.
+bool StyleSheetBinaryWriter::WriteProperty(const Property& property)
+{
+	Variant::Type type = property.value.GetType();
+	WriteByte((byte) type);
+
+	switch (type)
+	{
+		case Variant::NONE:
+			break;
+
+		// Each value is read into an initialised local, so the compiler can't see a path on which it is written
+		// uninitialised.
+		case Variant::BYTE:
+		{
+			byte value = 0;
+			property.value.GetInto(value);
+			WriteByte(value);
+		}
+		break;
+
+		case Variant::CHAR:
+		{
+			char value = 0;
+			property.value.GetInto(value);
+			WriteByte((byte) value);
+		}
+		break;
+
+		case Variant::FLOAT:
+		{
+			float value = 0;
+			property.value.GetInto(value);
+			WriteFloat(value);
+		}
+		break;
+
+		case Variant::INT:
+		{
+			int value = 0;
+			property.value.GetInto(value);
+			WriteInt(value);
+		}
+		break;
+
+		case Variant::STRING:
+		{
+			String value;
+			property.value.GetInto(value);
+			WriteString(value);
+		}
+		break;
+
+		case Variant::WORD:
+		{
+			word value = 0;
+			property.value.GetInto(value);
+			WriteUInt(value);
+		}
+		break;
+
+		case Variant::VECTOR2:
+		{
+			Vector2f value(0, 0);
+			property.value.GetInto(value);
+			WriteFloat(value.x);
+			WriteFloat(value.y);
+		}
+		break;
+
+		case Variant::COLOURF:
+		{
+			Colourf value(0, 0, 0, 0);
+			property.value.GetInto(value);
+			WriteFloat(value.red);
+			WriteFloat(value.green);
+			WriteFloat(value.blue);
+			WriteFloat(value.alpha);
+		}
+		break;
+
+		case Variant::COLOURB:
+		{
+			Colourb value(0, 0, 0, 0);
+			property.value.GetInto(value);
+			WriteByte(value.red);
+			WriteByte(value.green);
+			WriteByte(value.blue);
+			WriteByte(value.alpha);
+		}
+		break;
+
+		// Pointers can't be stored.
+		default:
+			return false;
+	}
+
+	WriteInt(property.unit);
+	WriteInt(property.specificity);
+	WriteByte(property.definition != NULL ? 1 : 0);
+	WriteInt(property.parser_index);
+	WriteInt(property.GetSourceLineNumber());
+
+	return true;
+}
+
+StyleSheetBinaryReader::StyleSheetBinaryReader(const byte* _data, size_t _length) : data(_data), length(_length)
+{
+	position = 0;
+	error = false;
+}
+
+// Reads the format's header and checks it matches the current version, the current specification and the given source.
+bool StyleSheetBinaryReader::ReadHeader(int& specificity_offset, unsigned int source_length, unsigned int source_hash)
+{
+	if (length < sizeof(MAGIC) ||
+		memcmp(data, MAGIC, sizeof(MAGIC)) != 0)
+		return false;
+
+	position = sizeof(MAGIC);
+
+	unsigned int version, specification_signature, compiled_source_length, compiled_source_hash;
+	if (!ReadUInt(version) ||
+		!ReadUInt(specification_signature) ||
+		!ReadUInt(compiled_source_length) ||
+		!ReadUInt(compiled_source_hash) ||
+		!ReadInt(specificity_offset))
+		return false;
+
+	return version == StyleSheetBinary::VERSION &&
+		   specification_signature == StyleSheetBinary::GetSpecificationSignature() &&
+		   compiled_source_length == source_length &&
+		   compiled_source_hash == source_hash;
+}
+
+bool StyleSheetBinaryReader::ReadByte(byte& value)
+{
+	if (error ||
+		position + 1 > length)
+	{
+		error = true;
+		return false;
+	}
+
+	value = data[position++];
+	return true;
+}
+
+bool StyleSheetBinaryReader::ReadUInt(unsigned int& value)
+{
+	if (error ||
+		position + 4 > length)
+	{
+		error = true;
+		return false;
+	}
+
+	const byte* bytes = data + position;
+	value = (unsigned int) bytes[0] | ((unsigned int) bytes[1] << 8) | ((unsigned int) bytes[2] << 16) | ((unsigned int) bytes[3] << 24);
+	position += 4;
+
+	return true;
+}
+
+bool StyleSheetBinaryReader::ReadInt(int& value)
+{
+	unsigned int bits;
+	if (!ReadUInt(bits))
+		return false;
+
+	value = (int) bits;
+	return true;
+}
+
+bool StyleSheetBinaryReader::ReadFloat(float& value)
+{
+	unsigned int bits;
+	if (!ReadUInt(bits))
+		return false;
+
+	memcpy(&value, &bits, sizeof(value));
+	return true;
+}
+
+bool StyleSheetBinaryReader::ReadString(String& value)
+{
+	unsigned int string_length;
+	if (!ReadUInt(string_length))
+		return false;
+
+	if (string_length > length - position)
+	{
+		error = true;
+		return false;
+	}
+
+	value.Assign((const char*) data + position, (const char*) data + position + string_length);
+	position += string_length;
+
+	return true;
+}
+
+// Reads a parsed property, and resolves its definition.
+bool StyleSheetBinaryReader::ReadProperty(Property& property, const String& name, const String& source)
+{
+	byte type;
+	if (!ReadByte(type))
+		return false;
+
+	switch (type)
+	{
+		case Variant::NONE:
+		{
+			property.value.Clear();
+		}
+		break;
+
+		case Variant::BYTE:
+		{
+			byte value;
+			if (!ReadByte(value))
+				return false;
+			property.value.Set(value);
+		}
+		break;
+
+		case Variant::CHAR:
+		{
+			byte value;
+			if (!ReadByte(value))
+				return false;
+			property.value.Set((char) value);
+		}
+		break;
+
+		case Variant::FLOAT:
+		{
+			float value;
+			if (!ReadFloat(value))
+				return false;
+			property.value.Set(value);
+		}
+		break;
+
+		case Variant::INT:
+		{
+			int value;
+			if (!ReadInt(value))
+				return false;
+			property.value.Set(value);
+		}
+		break;
+
+		case Variant::STRING:
+		{
+			String value;
+			if (!ReadString(value))
+				return false;
+			property.value.Set(value);
+		}
+		break;
+
+		case Variant::WORD:
+		{
+			unsigned int value;
+			if (!ReadUInt(value))
+				return false;
+			property.value.Set((word) value);
+		}
+		break;
+
+		case Variant::VECTOR2:
+		{
+			Vector2f value;
+			if (!ReadFloat(value.x) ||
+				!ReadFloat(value.y))
+				return false;
+			property.value.Set(value);
+		}
+		break;
+
+		case Variant::COLOURF:
+		{
+			Colourf value;
+			if (!ReadFloat(value.red) ||
+				!ReadFloat(value.green) ||
+				!ReadFloat(value.blue) ||
+				!ReadFloat(value.alpha))
+				return false;
+			property.value.Set(value);
+		}
+		break;
+
+		case Variant::COLOURB:
+		{
+			Colourb value;
+			if (!ReadByte(value.red) ||
+				!ReadByte(value.green) ||
+				!ReadByte(value.blue) ||
+				!ReadByte(value.alpha))
+				return false;
+			property.value.Set(value);
+		}
+		break;
+
+		default:
+		{
+			error = true;
+			return false;
+		}
+	}
+
+	int unit;
+	byte has_definition;
+	int source_line_number;
+	if (!ReadInt(unit) ||
+		!ReadInt(property.specificity) ||
+		!ReadByte(has_definition) ||
+		!ReadInt(property.parser_index) ||
+		!ReadInt(source_line_number))
+		return false;
+
+	property.unit = (Property::Unit) unit;
+	property.SetSource(source, source_line_number);
+
+	// The property must still be registered (or not) as it was when the sheet was compiled, otherwise its parsed
+	// value is meaningless. The header's specification signature has already checked the definition's parsers are
+	// unchanged, but the parser index is still checked so a corrupt sheet can't index past them.
+	property.definition = StyleSheetSpecification::GetProperty(name);
+	if ((property.definition != NULL) != (has_definition != 0) ||
+		(property.definition != NULL && (property.parser_index < 0 || property.parser_index >= property.definition->GetNumParsers())))
+	{
+		error = true;
+		return false;
+	}
+
+	return true;
+}
+
+// Returns true if the entire buffer has been read.
+bool StyleSheetBinaryReader::IsComplete() const
+{
+	return !error && position == length;
+}
+
+}
+}
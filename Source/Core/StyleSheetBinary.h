@@ -0,0 +1,142 @@
+/*
+ * This source file is part of libRocket, the HTML/CSS Interface Middleware
+ *
+ * For the latest information, see http://www.librocket.com
+ *
+ * Copyright (c) 2008-2010 CodePoint Ltd, Shift Technology Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+#ifndef ROCKETCORESTYLESHEETBINARY_H
+#define ROCKETCORESTYLESHEETBINARY_H
+
+#include <Rocket/Core/Types.h>
+
+namespace Rocket {
+namespace Core {
+
+class Property;
+class Stream;
+
+/**
+	Encoding of the precompiled binary style sheet format. A compiled sheet holds a style sheet's parsed node tree,
+	with its properties already parsed and their specificities resolved, so it can be loaded without running the RCSS
+	parser or any of the property parsers.
+
+	The format begins with a header identifying the version of the format and the RCSS it was compiled from:
+
+		"RCSC" uint32 version, uint32 specification signature, uint32 source length, uint32 source hash,
+		int32 specificity offset
+
+	The specification signature covers the name of every registered property and the names and keywords of its
+	parsers, in order, as a property's parsed value (a keyword's index, or the index of the parser that parsed it)
+	is only meaningful against the specification it was parsed with.
+
+	followed by the root node. Each node is written as its number of properties, its properties, and then for each
+	node type its number of children and the name and contents of each child. All values are little-endian.
+ */
+
+class StyleSheetBinary
+{
+public:
+	/// The version of the format; this must be increased whenever the format, or the parsed form of a property
+	/// value, changes.
+	static const unsigned int VERSION = 2;
+
+	/// Computes the signature of an RCSS source; its length and a hash of its contents. The stream is read from
+	/// the beginning and returned there afterwards.
+	/// @param[out] length The length of the source.
+	/// @param[out] hash The hash of the source.
+	/// @param[in] source The RCSS source.
+	static void GetSourceSignature(unsigned int& length, unsigned int& hash, Stream* source);
+	/// Computes the signature of the properties currently registered with the style sheet specification.
+	/// @return A hash of every property's name and the names and keywords of its parsers.
+	static unsigned int GetSpecificationSignature();
+};
+
+/**
+	Writes values into a stream in the precompiled style sheet format.
+ */
+
+class StyleSheetBinaryWriter
+{
+public:
+	StyleSheetBinaryWriter(Stream* stream);
+
+	/// Writes the format's header.
+	void WriteHeader(unsigned int source_length, unsigned int source_hash, int specificity_offset);
+
+	void WriteByte(byte value);
+	void WriteUInt(unsigned int value);
+	void WriteInt(int value);
+	void WriteFloat(float value);
+	void WriteString(const String& value);
+	/// Writes a parsed property.
+	/// @return False if the property's value can't be stored.
+	bool WriteProperty(const Property& property);
+
+private:
+	Stream* stream;
+};
+
+/**
+	Reads values from a buffer in the precompiled style sheet format. Once a read fails, as the buffer is truncated
+	or corrupt, every subsequent read fails.
+ */
+
+class StyleSheetBinaryReader
+{
+public:
+	StyleSheetBinaryReader(const byte* data, size_t length);
+
+	/// Reads the format's header and checks it matches the current version, the current property specification and
+	/// the given source.
+	/// @param[out] specificity_offset The specificity offset of the compiled sheet.
+	/// @return True if the header is valid for the source.
+	bool ReadHeader(int& specificity_offset, unsigned int source_length, unsigned int source_hash);
+
+	bool ReadByte(byte& value);
+	bool ReadUInt(unsigned int& value);
+	bool ReadInt(int& value);
+	bool ReadFloat(float& value);
+	bool ReadString(String& value);
+	/// Reads a parsed property, and resolves its definition.
+	/// @param[out] property The property.
+	/// @param[in] name The name of the property.
+	/// @param[in] source The source to set on the property.
+	/// @return False if the property couldn't be read, or doesn't fit the property's current definition.
+	bool ReadProperty(Property& property, const String& name, const String& source);
+
+	/// Returns true if the entire buffer has been read.
+	bool IsComplete() const;
+
+private:
+	const byte* data;
+	size_t length;
+	size_t position;
+	bool error;
+};
+
+}
+}
+
+#endif
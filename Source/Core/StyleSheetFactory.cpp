@@ -40,6 +40,7 @@
 #include "StyleSheetNodeSelectorOnlyChild.h"
 #include "StyleSheetNodeSelectorOnlyOfType.h"
 #include "StyleSheetNodeSelectorEmpty.h"
+#include <Rocket/Core/FileInterface.h>
 #include <Rocket/Core/Log.h>
 
 namespace Rocket {
@@ -47,6 +48,9 @@ namespace Core {
 
 static StyleSheetFactory* instance = NULL;
 
+// The suffix appended to a style sheet's path to find its precompiled form.
+static const char* COMPILED_STYLE_SHEET_SUFFIX = "c";
+
 StyleSheetFactory::StyleSheetFactory()
 {
 	ROCKET_ASSERT(instance == NULL);
@@ -194,7 +198,8 @@ StyleSheet* StyleSheetFactory::LoadStyleSheet(const String& sheet)
 	if (stream->Open(sheet))
 	{
 		new_style_sheet = new StyleSheet();
-		if (!new_style_sheet->LoadStyleSheet(stream))
+		if (!LoadCompiledStyleSheet(new_style_sheet, sheet, stream) &&
+			!new_style_sheet->LoadStyleSheet(stream))
 		{
 			new_style_sheet->RemoveReference();
 			new_style_sheet = NULL;
@@ -205,5 +210,31 @@ StyleSheet* StyleSheetFactory::LoadStyleSheet(const String& sheet)
 	return new_style_sheet;
 }
 
+// Loads a style sheet from its precompiled form, if it has been compiled from the current version of the source.
+bool StyleSheetFactory::LoadCompiledStyleSheet(StyleSheet* style_sheet, const String& sheet, Stream* source)
+{
+	// The compiled sheet is kept alongside its source; it's optional, so we don't complain if it's not there.
+	FileInterface* file_interface = GetFileInterface();
+	FileHandle handle = file_interface->Open(sheet + COMPILED_STYLE_SHEET_SUFFIX);
+	if (!handle)
+		return false;
+
+	std::vector< byte > data(file_interface->Length(handle));
+	size_t length = data.empty() ? 0 : file_interface->Read(&data[0], data.size(), handle);
+	file_interface->Close(handle);
+
+	if (length != data.size() ||
+		data.empty())
+		return false;
+
+	if (!style_sheet->LoadCompiledStyleSheet(&data[0], data.size(), source))
+	{
+		Log::Message(Log::LT_INFO, "Compiled style sheet %s%s is out of date; loading %s instead.", sheet.CString(), COMPILED_STYLE_SHEET_SUFFIX, sheet.CString());
+		return false;
+	}
+
+	return true;
+}
+
 }
 }
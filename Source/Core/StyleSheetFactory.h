@@ -33,6 +33,7 @@
 namespace Rocket {
 namespace Core {
 
+class Stream;
 class StyleSheet;
 class StyleSheetNodeSelector;
 
@@ -73,6 +74,8 @@ private:
 
 	// Loads an individual style sheet
 	StyleSheet* LoadStyleSheet(const String& sheet);
+	// Loads a style sheet from its precompiled form, if it has been compiled from the current version of the source.
+	bool LoadCompiledStyleSheet(StyleSheet* style_sheet, const String& sheet, Stream* source);
 
 	// Individual loaded stylesheets
 	typedef std::map<String, StyleSheet*> StyleSheets;
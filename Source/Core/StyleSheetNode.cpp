@@ -29,6 +29,10 @@
 #include "StyleSheetNode.h"
 #include <algorithm>
 #include <Rocket/Core/Element.h>
+#include "AncestorFilter.h"
+#include "InvalidationMap.h"
+#include "PropertyLayer.h"
+#include "StyleSheetBinary.h"
 #include "StyleSheetFactory.h"
 #include "StyleSheetNodeSelector.h"
 
@@ -42,6 +46,11 @@ StyleSheetNode::StyleSheetNode(const String& name, NodeType _type, StyleSheetNod
 
 	specificity = CalculateSpecificity();
 
+	pseudo_class_id = type == PSEUDO_CLASS ? PseudoClassRegistry::GetId(name) : -1;
+	tag_node = NULL;
+	ancestor_tag_node = NULL;
+	property_layer = new PropertyLayer(GetPseudoClassChain());
+
 	selector = NULL;
 	a = 0;
 	b = 0;
@@ -55,6 +64,11 @@ StyleSheetNode::StyleSheetNode(const String& name, StyleSheetNode* _parent, Styl
 
 	specificity = CalculateSpecificity();
 
+	pseudo_class_id = -1;
+	tag_node = NULL;
+	ancestor_tag_node = NULL;
+	property_layer = new PropertyLayer(GetPseudoClassChain());
+
 	selector = _selector;
 	a = _a;
 	b = _b;
@@ -62,6 +76,8 @@ StyleSheetNode::StyleSheetNode(const String& name, StyleSheetNode* _parent, Styl
 
 StyleSheetNode::~StyleSheetNode()
 {
+	property_layer->RemoveReference();
+
 	for (int i = 0; i < NUM_NODE_TYPES; i++)
 	{
 		for (NodeMap::iterator j = children[i].begin(); j != children[i].end(); j++)
@@ -72,7 +88,7 @@ StyleSheetNode::~StyleSheetNode()
 // Writes the style sheet node (and all ancestors) into the stream.
 void StyleSheetNode::Write(Stream* stream)
 {
-	if (properties.GetNumProperties() > 0)
+	if (GetProperties().GetNumProperties() > 0)
 	{
 		String rule;
 		StyleSheetNode* hierarchy = this;
@@ -110,7 +126,7 @@ void StyleSheetNode::Write(Stream* stream)
 		stream->Write(String(1024, "%s /* specificity: %d */\n", StringUtilities::StripWhitespace(rule).CString(), specificity));
 		stream->Write("{\n");
 
-		const Rocket::Core::PropertyMap& property_map = properties.GetProperties();
+		const Rocket::Core::PropertyMap& property_map = GetProperties().GetProperties();
 		for (Rocket::Core::PropertyMap::const_iterator i = property_map.begin(); i != property_map.end(); ++i)
 		{
 			const String& name = i->first;
@@ -129,11 +145,87 @@ void StyleSheetNode::Write(Stream* stream)
 	}
 }
 
+// Writes the node's properties and descendants in the precompiled binary format.
+bool StyleSheetNode::WriteBinary(StyleSheetBinaryWriter& writer) const
+{
+	const PropertyMap& property_map = GetProperties().GetProperties();
+	writer.WriteUInt((unsigned int) property_map.size());
+	for (PropertyMap::const_iterator i = property_map.begin(); i != property_map.end(); ++i)
+	{
+		writer.WriteString((*i).first);
+		if (!writer.WriteProperty((*i).second))
+			return false;
+	}
+
+	for (int i = 0; i < NUM_NODE_TYPES; ++i)
+	{
+		writer.WriteUInt((unsigned int) children[i].size());
+		for (NodeMap::const_iterator j = children[i].begin(); j != children[i].end(); ++j)
+		{
+			writer.WriteString((*j).first);
+			if (!(*j).second->WriteBinary(writer))
+				return false;
+		}
+	}
+
+	return true;
+}
+
+// Reads the node's properties and descendants from the precompiled binary format.
+bool StyleSheetNode::ReadBinary(StyleSheetBinaryReader& reader, const String& source)
+{
+	unsigned int num_properties;
+	if (!reader.ReadUInt(num_properties))
+		return false;
+
+	String property_name;
+	for (unsigned int i = 0; i < num_properties; ++i)
+	{
+		Property property;
+		if (!reader.ReadString(property_name) ||
+			!reader.ReadProperty(property, property_name, source))
+			return false;
+
+		GetWritableProperties().SetProperty(property_name, property);
+	}
+
+	for (int i = 0; i < NUM_NODE_TYPES; ++i)
+	{
+		unsigned int num_children;
+		if (!reader.ReadUInt(num_children))
+			return false;
+
+		String child_name;
+		for (unsigned int j = 0; j < num_children; ++j)
+		{
+			if (!reader.ReadString(child_name))
+				return false;
+
+			// The child is created just as the parser would have, so its specificity and selector are rebuilt.
+			StyleSheetNode* child = GetChildNode(child_name, (NodeType) i);
+			if (child == NULL ||
+				!child->ReadBinary(reader, source))
+				return false;
+		}
+	}
+
+	return true;
+}
+
 // Merges an entire tree hierarchy into our hierarchy.
 bool StyleSheetNode::MergeHierarchy(StyleSheetNode* node, int specificity_offset)
 {
-	// Merge the other node's properties into ours.
-	MergeProperties(node->properties, specificity_offset);
+	// Merge the other node's properties into ours. If we have none of our own yet and the specificities are
+	// unchanged, the merge would just be a copy; share the other node's layer instead.
+	if (specificity_offset == 0 &&
+		GetProperties().GetNumProperties() == 0)
+	{
+		node->property_layer->AddReference();
+		property_layer->RemoveReference();
+		property_layer = node->property_layer;
+	}
+	else
+		MergeProperties(node->GetProperties(), specificity_offset);
 
 	selector = node->selector;
 	a = node->a;
@@ -152,41 +244,88 @@ bool StyleSheetNode::MergeHierarchy(StyleSheetNode* node, int specificity_offset
 }
 
 // Builds up a style sheet's index recursively.
-void StyleSheetNode::BuildIndex(StyleSheet::NodeIndex& styled_index, StyleSheet::NodeIndex& complete_index)
+void StyleSheetNode::BuildIndex(StyleSheet::NodeList& indexed_nodes, std::set< String >& structurally_volatile_tags)
 {
-	// If this is a tag node, then we insert it into the list of all tag nodes. Makes sense, neh?
+	// Work out which tag node we'd be matched through. Pseudo-classes can't be built into the root definition, so
+	// nodes beneath them (other than further tag nodes) are never matched directly.
 	if (type == TAG)
 	{
-		StyleSheet::NodeIndex::iterator iterator = complete_index.find(name);
-		if (iterator == complete_index.end())
-			(*complete_index.insert(StyleSheet::NodeIndex::value_type(name, StyleSheet::NodeList())).first).second.insert(this);
-		else
-			(*iterator).second.insert(this);
+		tag_node = this;
+		CompileAncestorRequirements();
+
+		if (IsStructurallyVolatile())
+			structurally_volatile_tags.insert(name);
 	}
+	else if (type == ROOT ||
+			 type == PSEUDO_CLASS ||
+			 parent == NULL)
+		tag_node = NULL;
+	else
+		tag_node = parent->tag_node;
+
+	// If we are a styled node (ie, have some style attributes attached), or have pseudo-classes that may be, then we
+	// insert ourselves into the list of indexed nodes.
+	if (tag_node != NULL &&
+		(GetProperties().GetNumProperties() > 0 || !children[PSEUDO_CLASS].empty()))
+		indexed_nodes.push_back(this);
 
-	// If we are a styled node (ie, have some style attributes attached), then we insert our closest parent tag node
-	// into the list of styled tag nodes.
-	if (properties.GetNumProperties() > 0)
+	for (int i = 0; i < NUM_NODE_TYPES; i++)
 	{
-		StyleSheetNode* tag_node = this;
-		while (tag_node != NULL &&
-			   tag_node->type != TAG)
-			tag_node = tag_node->parent;
+		for (NodeMap::iterator j = children[i].begin(); j != children[i].end(); ++j)
+			(*j).second->BuildIndex(indexed_nodes, structurally_volatile_tags);
+	}
+}
 
-		if (tag_node != NULL)
+// Returns the part of the node's selector it should be indexed under.
+StyleSheetNode::NodeType StyleSheetNode::GetIndexKey(String& key) const
+{
+	const StyleSheetNode* class_node = NULL;
+	for (const StyleSheetNode* node = this; node != tag_node; node = node->parent)
+	{
+		if (node->type == ID)
 		{
-			StyleSheet::NodeIndex::iterator iterator = styled_index.find(tag_node->name);
-			if (iterator == styled_index.end())
-				(*styled_index.insert(StyleSheet::NodeIndex::value_type(tag_node->name, StyleSheet::NodeList())).first).second.insert(tag_node);
-			else
-				(*iterator).second.insert(tag_node);
+			key = node->name;
+			return ID;
 		}
+
+		if (node->type == CLASS &&
+			class_node == NULL)
+			class_node = node;
 	}
 
-	for (int i = 0; i < NUM_NODE_TYPES; i++)
+	if (class_node != NULL)
 	{
-		for (NodeMap::iterator j = children[i].begin(); j != children[i].end(); ++j)
-			(*j).second->BuildIndex(styled_index, complete_index);
+		key = class_node->name;
+		return CLASS;
+	}
+
+	key = tag_node->name;
+	return TAG;
+}
+
+// Records in an invalidation map the classes, ids and pseudo-classes this indexed node's selector requires of the
+// subject's ancestors.
+void StyleSheetNode::AddAncestorDependencies(InvalidationMap& invalidation_map) const
+{
+	String key;
+	InvalidationMap::SubjectKey key_type;
+	switch (GetIndexKey(key))
+	{
+		case ID:	key_type = InvalidationMap::SUBJECT_ID; break;
+		case CLASS:	key_type = InvalidationMap::SUBJECT_CLASS; break;
+		default:	key_type = InvalidationMap::SUBJECT_TAG; break;
+	}
+
+	for (const StyleSheetNode* node = tag_node; node->ancestor_tag_node != NULL; node = node->ancestor_tag_node)
+	{
+		if (!node->ancestor_id.Empty())
+			invalidation_map.AddDependency(InvalidationMap::ID, node->ancestor_id, key_type, key);
+
+		for (size_t i = 0; i < node->ancestor_classes.size(); ++i)
+			invalidation_map.AddDependency(InvalidationMap::CLASS, node->ancestor_classes[i], key_type, key);
+
+		for (size_t i = 0; i < node->ancestor_pseudo_classes.size(); ++i)
+			invalidation_map.AddDependency(InvalidationMap::PSEUDO_CLASS, node->ancestor_pseudo_classes[i], key_type, key);
 	}
 }
 
@@ -206,27 +345,39 @@ int StyleSheetNode::GetSpecificity() const
 // properties.
 void StyleSheetNode::ImportProperties(const PropertyDictionary& _properties, int rule_specificity)
 {
-	properties.Import(_properties, specificity + rule_specificity);
+	GetWritableProperties().Import(_properties, specificity + rule_specificity);
 }
 
 // Merges properties from another node (ie, with potentially differing specificities) into the
 // node's properties.
 void StyleSheetNode::MergeProperties(const PropertyDictionary& _properties, int rule_specificity_offset)
 {
-	properties.Merge(_properties, rule_specificity_offset);
+	GetWritableProperties().Merge(_properties, rule_specificity_offset);
 }
 
 // Returns the node's default properties.
 const PropertyDictionary& StyleSheetNode::GetProperties() const
 {
-	return properties;
+	return property_layer->GetProperties();
+}
+
+// Returns the shared layer holding the node's default properties.
+PropertyLayer* StyleSheetNode::GetPropertyLayer() const
+{
+	return property_layer;
 }
 
-// Builds the properties of all of the pseudo-classes of this style sheet node into a single map.
-void StyleSheetNode::GetPseudoClassProperties(PseudoClassPropertyMap& pseudo_class_properties) const
+// Adds to a list the property layers of all of the pseudo-classes of this style sheet node that declare properties.
+void StyleSheetNode::GetPseudoClassPropertyLayers(std::vector< PropertyLayer* >& pseudo_class_layers) const
 {
 	for (NodeMap::const_iterator i = children[PSEUDO_CLASS].begin(); i != children[PSEUDO_CLASS].end(); ++i)
-		(*i).second->GetPseudoClassProperties(pseudo_class_properties, StringList());
+	{
+		const StyleSheetNode* pseudo_class_node = (*i).second;
+		if (pseudo_class_node->GetProperties().GetNumProperties() > 0)
+			pseudo_class_layers.push_back(pseudo_class_node->property_layer);
+
+		pseudo_class_node->GetPseudoClassPropertyLayers(pseudo_class_layers);
+	}
 }
 
 // Adds to a list the names of this node's pseudo-classes which are deemed volatile.
@@ -253,6 +404,34 @@ bool StyleSheetNode::GetVolatilePseudoClasses(PseudoClassList& volatile_pseudo_c
 	return false;
 }
 
+// Adds to a mask this node's pseudo-classes which are deemed volatile.
+bool StyleSheetNode::GetVolatilePseudoClasses(PseudoClassMask& volatile_pseudo_classes, bool& complete) const
+{
+	if (type == PSEUDO_CLASS)
+	{
+		bool self_volatile = !children[TAG].empty();
+
+		for (NodeMap::const_iterator i = children[PSEUDO_CLASS].begin(); i != children[PSEUDO_CLASS].end(); ++i)
+			self_volatile = (*i).second->GetVolatilePseudoClasses(volatile_pseudo_classes, complete) | self_volatile;
+
+		if (self_volatile)
+		{
+			if (pseudo_class_id < 0)
+				complete = false;
+			volatile_pseudo_classes |= PseudoClassRegistry::GetMask(pseudo_class_id);
+		}
+
+		return self_volatile;
+	}
+	else
+	{
+		for (NodeMap::const_iterator i = children[PSEUDO_CLASS].begin(); i != children[PSEUDO_CLASS].end(); ++i)
+			(*i).second->GetVolatilePseudoClasses(volatile_pseudo_classes, complete);
+	}
+
+	return false;
+}
+
 // Returns a direct child node of this node of the requested type.
 StyleSheetNode* StyleSheetNode::GetChildNode(const String& child_name, NodeType child_type, bool create)
 {
@@ -287,7 +466,7 @@ StyleSheetNode* StyleSheetNode::GetChildNode(const String& child_name, NodeType
 }
 
 // Returns true if this node is applicable to the given element, given its IDs, classes and heritage.
-bool StyleSheetNode::IsApplicable(const Element* element) const
+bool StyleSheetNode::IsApplicable(const Element* element, const AncestorFilter* ancestor_filter) const
 {
 	// This function is called with an element that matches a style node only with the tag name. We have to determine
 	// here whether or not it also matches the required hierarchy.
@@ -303,41 +482,31 @@ bool StyleSheetNode::IsApplicable(const Element* element) const
 	if (parent->type == ROOT)
 		return true;
 
-	// Determine the tag (and possibly id / class as well) of the next required parent in the RCSS hierarchy.
-	const StyleSheetNode* parent_node = parent;
-	String ancestor_id;
-	StringList ancestor_classes;
-	StringList ancestor_pseudo_classes;
-	std::vector< const StyleSheetNode* > ancestor_structural_pseudo_classes;
-
-	while (parent_node != NULL && parent_node->type != TAG)
-	{
-		switch (parent_node->type)
-		{
-			case ID:						ancestor_id = parent_node->name; break;
-			case CLASS:						ancestor_classes.push_back(parent_node->name); break;
-			case PSEUDO_CLASS:				ancestor_pseudo_classes.push_back(parent_node->name); break;
-			case STRUCTURAL_PSEUDO_CLASS:	ancestor_structural_pseudo_classes.push_back(parent_node); break;
-			default:						ROCKET_ERRORMSG("Invalid RCSS hierarchy."); return false;
-		}
-
-		parent_node = parent_node->parent;
-	}
-
 	// Check for an invalid RCSS hierarchy.
-	if (parent_node == NULL)
+	if (ancestor_tag_node == NULL)
 	{
 		ROCKET_ERRORMSG("Invalid RCSS hierarchy.");
 		return false;
 	}
 
-	// Now we know the name / class / ID / pseudo-class / structural requirements for the next ancestor requirement of
-	// the element. So we look back through the element's ancestors to find one that matches.
+	// If any of the tags, ids or classes we require of our ancestors definitely can't be found, we can reject the
+	// element without looking through its ancestors.
+	if (ancestor_filter != NULL)
+	{
+		for (size_t i = 0; i < ancestor_hashes.size(); ++i)
+		{
+			if (!ancestor_filter->MayContain(ancestor_hashes[i]))
+				return false;
+		}
+	}
+
+	// We know the name / class / ID / pseudo-class / structural requirements for the next ancestor requirement of the
+	// element. So we look back through the element's ancestors to find one that matches.
 	for (const Element* ancestor_element = element->GetParentNode(); ancestor_element != NULL; ancestor_element = ancestor_element->GetParentNode())
 	{
 		// Skip this ancestor if the name of the next style node doesn't match its tag name, and one was specified.
-		if (!parent_node->name.Empty() 
-			&& parent_node->name != ancestor_element->GetTagName())
+		if (!ancestor_tag_node->name.Empty() 
+			&& ancestor_tag_node->name != ancestor_element->GetTagName())
 			continue;
 
 		// Skip this ancestor if the ID of the next style node doesn't match its ID, and one was specified.
@@ -384,70 +553,41 @@ bool StyleSheetNode::IsApplicable(const Element* element) const
 		if (!resolved_requirements)
 			continue;
 
-		return parent_node->IsApplicable(ancestor_element);
+		return ancestor_tag_node->IsApplicable(ancestor_element);
 	}
 
 	// We hit the end of the hierarchy before matching the required ancestor, so bail.
 	return false;
 }
 
-// Appends all applicable non-tag descendants of this node into the given element list.
-void StyleSheetNode::GetApplicableDescendants(std::vector< const StyleSheetNode* >& applicable_nodes, const Element* element) const
+// Returns true if this indexed node's entire selector is applicable to the given element.
+bool StyleSheetNode::IsSelectorApplicable(const Element* element, const AncestorFilter* ancestor_filter) const
 {
-	// Check if this node matches this element.
-	switch (type)
+	// Check the requirements of our simple selectors back up to our tag node first; these are cheap to resolve as
+	// they only involve the element itself.
+	for (const StyleSheetNode* node = this; node != tag_node; node = node->parent)
 	{
-		case ROOT:
-		case TAG:
-		{
-			// These nodes always match.
-		}
-		break;
-
-		case CLASS:
-		{
-			if (!element->IsClassSet(name))
-				return;
-		}
-		break;
-
-		case ID:
-		{
-			if (name != element->GetId())
-				return;
-		}
-		break;
-
-		case PSEUDO_CLASS:
-		{
-			if (!element->IsPseudoClassSet(name))
-				return;
-		}
-		break;
-
-		case STRUCTURAL_PSEUDO_CLASS:
-		{
-			if (selector == NULL)
-				return;
-
-			if (!selector->IsApplicable(element, a, b))
-				return;
-		}
-		break;
+		if (!node->IsRequirementMet(element))
+			return false;
 	}
 
-	if (properties.GetNumProperties() > 0 ||
-		!children[PSEUDO_CLASS].empty())
-		applicable_nodes.push_back(this);
+	if (!tag_node->name.Empty() &&
+		tag_node->name != element->GetTagName())
+		return false;
 
-	for (int i = CLASS; i < NUM_NODE_TYPES; i++)
-	{
-		// Don't recurse into pseudo-classes; they can't be built into the root definition.
-		if (i == PSEUDO_CLASS)
-			continue;
+	return tag_node->IsApplicable(element, ancestor_filter);
+}
 
-		for (NodeMap::const_iterator j = children[i].begin(); j != children[i].end(); ++j)
-			(*j).second->GetApplicableDescendants(applicable_nodes, element);
+// Returns true if the element satisfies this node's own requirement.
+bool StyleSheetNode::IsRequirementMet(const Element* element) const
+{
+	switch (type)
+	{
+		case CLASS:						return element->IsClassSet(name);
+		case ID:						return name == element->GetId();
+		case PSEUDO_CLASS:				return element->IsPseudoClassSet(name);
+		case STRUCTURAL_PSEUDO_CLASS:	return selector != NULL && selector->IsApplicable(element, a, b);
+		default:						return true;
 	}
 }
 
@@ -552,17 +692,32 @@ StyleSheetNode* StyleSheetNode::CreateStructuralChild(const String& child_name)
 	return new StyleSheetNode(child_name, this, child_selector, child_a, child_b);
 }
 
-// Recursively builds up a list of all pseudo-classes branching from a single node.
-void StyleSheetNode::GetPseudoClassProperties(PseudoClassPropertyMap& pseudo_class_properties, const StringList& ancestor_pseudo_classes)
+// Returns the node's properties for modification, first taking a private copy of the property layer if it is shared.
+PropertyDictionary& StyleSheetNode::GetWritableProperties()
 {
-	StringList pseudo_classes(ancestor_pseudo_classes);
-	pseudo_classes.push_back(name);
+	if (property_layer->GetReferenceCount() > 1)
+	{
+		PropertyLayer* copy = new PropertyLayer(*property_layer);
+		property_layer->RemoveReference();
+		property_layer = copy;
+	}
 
-	if (properties.GetNumProperties() > 0)
-		pseudo_class_properties[pseudo_classes] = properties;
+	return property_layer->GetWritableProperties();
+}
 
-	for (NodeMap::const_iterator i = children[PSEUDO_CLASS].begin(); i != children[PSEUDO_CLASS].end(); ++i)
-		(*i).second->GetPseudoClassProperties(pseudo_class_properties, pseudo_classes);
+// Returns the pseudo-classes required by this node and the pseudo-class nodes it descends from.
+StringList StyleSheetNode::GetPseudoClassChain() const
+{
+	size_t num_pseudo_classes = 0;
+	for (const StyleSheetNode* node = this; node != NULL && node->type == PSEUDO_CLASS; node = node->parent)
+		num_pseudo_classes++;
+
+	// The chain is filled in from this node upwards, so it runs from the outermost pseudo-class down.
+	StringList pseudo_classes(num_pseudo_classes);
+	for (const StyleSheetNode* node = this; num_pseudo_classes > 0; node = node->parent)
+		pseudo_classes[--num_pseudo_classes] = node->name;
+
+	return pseudo_classes;
 }
 
 int StyleSheetNode::CalculateSpecificity()
@@ -608,5 +763,51 @@ int StyleSheetNode::CalculateSpecificity()
 	return specificity;
 }
 
+// Compiles the requirements this tag node places on the element's ancestors.
+void StyleSheetNode::CompileAncestorRequirements()
+{
+	ancestor_tag_node = NULL;
+	ancestor_id.Clear();
+	ancestor_classes.clear();
+	ancestor_pseudo_classes.clear();
+	ancestor_structural_pseudo_classes.clear();
+	ancestor_hashes.clear();
+
+	if (parent == NULL ||
+		parent->type == ROOT)
+		return;
+
+	// Determine the tag (and possibly id / class as well) of the next required parent in the RCSS hierarchy. If the
+	// hierarchy is invalid, the tag node is left as NULL so the error can be reported when the node is used.
+	const StyleSheetNode* parent_node = parent;
+	while (parent_node != NULL && parent_node->type != TAG)
+	{
+		switch (parent_node->type)
+		{
+			case ID:						ancestor_id = parent_node->name; break;
+			case CLASS:						ancestor_classes.push_back(parent_node->name); break;
+			case PSEUDO_CLASS:				ancestor_pseudo_classes.push_back(parent_node->name); break;
+			case STRUCTURAL_PSEUDO_CLASS:	ancestor_structural_pseudo_classes.push_back(parent_node); break;
+			default:						return;
+		}
+
+		parent_node = parent_node->parent;
+	}
+
+	if (parent_node == NULL)
+		return;
+
+	ancestor_tag_node = parent_node;
+
+	if (!ancestor_tag_node->name.Empty())
+		ancestor_hashes.push_back(AncestorFilter::HashTag(ancestor_tag_node->name));
+	if (!ancestor_id.Empty())
+		ancestor_hashes.push_back(AncestorFilter::HashId(ancestor_id));
+	for (size_t i = 0; i < ancestor_classes.size(); ++i)
+		ancestor_hashes.push_back(AncestorFilter::HashClass(ancestor_classes[i]));
+
+	ancestor_hashes.insert(ancestor_hashes.end(), ancestor_tag_node->ancestor_hashes.begin(), ancestor_tag_node->ancestor_hashes.end());
+}
+
 }
 }
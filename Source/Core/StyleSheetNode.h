@@ -31,10 +31,16 @@
 #include <Rocket/Core/PropertyDictionary.h>
 #include <Rocket/Core/StyleSheet.h>
 #include <Rocket/Core/Types.h>
+#include "PseudoClassRegistry.h"
 
 namespace Rocket {
 namespace Core {
 
+class AncestorFilter;
+class InvalidationMap;
+class PropertyLayer;
+class StyleSheetBinaryReader;
+class StyleSheetBinaryWriter;
 class StyleSheetNodeSelector;
 
 typedef std::map< StringList, PropertyDictionary > PseudoClassPropertyMap;
@@ -67,11 +73,31 @@ public:
 
 	/// Writes the style sheet node (and all ancestors) into the stream.
 	void Write(Stream* stream);
+	/// Writes the node's properties and descendants in the precompiled binary format.
+	/// @param[in] writer The writer to write the node through.
+	/// @return False if one of the properties can't be stored in the format.
+	bool WriteBinary(StyleSheetBinaryWriter& writer) const;
+	/// Reads the node's properties and descendants from the precompiled binary format.
+	/// @param[in] reader The reader to read the node through.
+	/// @param[in] source The source file to set on the node's properties.
+	/// @return False if the node couldn't be read.
+	bool ReadBinary(StyleSheetBinaryReader& reader, const String& source);
 
 	/// Merges an entire tree hierarchy into our hierarchy.
 	bool MergeHierarchy(StyleSheetNode* node, int specificity_offset = 0);
 	/// Builds up a style sheet's index recursively.
-	void BuildIndex(StyleSheet::NodeIndex& styled_index, StyleSheet::NodeIndex& complete_index);
+	/// @param[out] indexed_nodes The list to add every node that can apply to an element to.
+	/// @param[out] structurally_volatile_tags The set to add the tag of every structurally volatile tag node to.
+	void BuildIndex(StyleSheet::NodeList& indexed_nodes, std::set< String >& structurally_volatile_tags);
+	/// Returns the part of the node's selector it should be indexed under: the selector's right-most id if it has
+	/// one, otherwise its right-most class, otherwise its tag. This is only valid for indexed nodes.
+	/// @param[out] key The name of the id, class or tag.
+	/// @return The type of the key; one of ID, CLASS or TAG.
+	NodeType GetIndexKey(String& key) const;
+	/// Records in an invalidation map the classes, ids and pseudo-classes this indexed node's selector requires of
+	/// the subject's ancestors.
+	/// @param[out] invalidation_map The map to add the dependencies to.
+	void AddAncestorDependencies(InvalidationMap& invalidation_map) const;
 
 	/// Returns the name of this node.
 	const String& GetName() const;
@@ -93,13 +119,21 @@ public:
 	/// Returns the node's default properties.
 	const PropertyDictionary& GetProperties() const;
 
-	/// Merges the properties of all of the pseudo-classes of this style sheet node into a single map.
-	/// @param pseudo_class_properties[out] The dictionary to fill with the pseudo-class properties.
-	void GetPseudoClassProperties(PseudoClassPropertyMap& pseudo_class_properties) const;
+	/// Returns the shared layer holding the node's default properties. The layer is copied on write, so callers may
+	/// add a reference to it and keep it unchanged beyond the lifetime of the node.
+	PropertyLayer* GetPropertyLayer() const;
+	/// Adds to a list the property layers of all of the pseudo-classes of this style sheet node that declare
+	/// properties, ordered by their pseudo-classes.
+	/// @param pseudo_class_layers[out] The list to add the layers to.
+	void GetPseudoClassPropertyLayers(std::vector< PropertyLayer* >& pseudo_class_layers) const;
 	/// Adds to a list the names of this node's pseudo-classes which are deemed volatile; that is, which will
 	/// potentially affect child node's element definition if set or unset.
 	/// @param volatile_pseudo_classes[out] The list of volatile pseudo-classes.
 	bool GetVolatilePseudoClasses(PseudoClassList& volatile_pseudo_classes) const;
+	/// Adds to a mask this node's pseudo-classes which are deemed volatile.
+	/// @param volatile_pseudo_classes[out] The mask of volatile pseudo-classes.
+	/// @param complete[out] Set to false if any of the volatile pseudo-classes could not be interned into the mask.
+	bool GetVolatilePseudoClasses(PseudoClassMask& volatile_pseudo_classes, bool& complete) const;
 
 	/// Returns a direct child node of this node of the requested type.
 	/// @param name The name of the child node to fetch.
@@ -107,10 +141,15 @@ public:
 	/// @param create If set to true, the node will be created if it doesn't exist.
 	StyleSheetNode* GetChildNode(const String& name, NodeType type, bool create = true);
 
-	/// Returns true if this node is applicable to the given element, given its IDs, classes and heritage.
-	bool IsApplicable(const Element* element) const;
-	/// Appends all applicable non-tag descendants of this node into the given element list.
-	void GetApplicableDescendants(std::vector< const StyleSheetNode* >& applicable_nodes, const Element* element) const;
+	/// Returns true if this tag node is applicable to the given element, given its IDs, classes and heritage.
+	/// @param[in] element The element to check.
+	/// @param[in] ancestor_filter If set, a filter of the element's ancestors used to quickly reject the node if an ancestor it requires can't exist.
+	bool IsApplicable(const Element* element, const AncestorFilter* ancestor_filter = NULL) const;
+	/// Returns true if this indexed node's entire selector is applicable to the given element; that is, the element
+	/// has its tag, classes, id and structural pseudo-classes and its heritage matches.
+	/// @param[in] element The element to check.
+	/// @param[in] ancestor_filter If set, a filter of the element's ancestors used to quickly reject the node if an ancestor it requires can't exist.
+	bool IsSelectorApplicable(const Element* element, const AncestorFilter* ancestor_filter = NULL) const;
 
 	/// Returns true if this node employs a structural selector, and therefore generates element definitions that are
 	/// sensitive to sibling changes.
@@ -120,10 +159,18 @@ public:
 private:
 	// Constructs a structural pseudo-class child node.
 	StyleSheetNode* CreateStructuralChild(const String& child_name);
-	// Recursively builds up a list of all pseudo-classes branching from a single node.
-	void GetPseudoClassProperties(PseudoClassPropertyMap& pseudo_class_properties, const StringList& ancestor_pseudo_classes);
+	// Returns the node's properties for modification, first taking a private copy of the property layer if it is
+	// shared.
+	PropertyDictionary& GetWritableProperties();
+	// Returns the pseudo-classes required by this node and the pseudo-class nodes it descends from.
+	StringList GetPseudoClassChain() const;
 
 	int CalculateSpecificity();
+	// Returns true if the element satisfies this node's own requirement; its class, id or structural pseudo-class.
+	bool IsRequirementMet(const Element* element) const;
+	// Compiles the requirements this tag node places on the element's ancestors. This is called as the index is
+	// built, after our ancestors have compiled their own requirements.
+	void CompileAncestorRequirements();
 
 	// The parent of this node; is NULL for the root node.
 	StyleSheetNode* parent;
@@ -131,6 +178,8 @@ private:
 	// The name and type.
 	String name;
 	NodeType type;
+	// The interned identifier of the pseudo-class; only used for pseudo-class nodes.
+	int pseudo_class_id;
 
 	// The complex selector for this node; only used for structural nodes.
 	StyleSheetNodeSelector* selector;
@@ -141,8 +190,21 @@ private:
 	// node with a lower value.
 	int specificity;
 
-	// The generic properties for this node.
-	PropertyDictionary properties;
+	// The closest tag node at or above this node, if the node can be applied to elements through the index.
+	const StyleSheetNode* tag_node;
+
+	// The tag node of the next ancestor required by this tag node, and the id, classes, pseudo-classes and
+	// structural pseudo-classes that ancestor must have. The tag node is NULL if we have no required ancestors.
+	const StyleSheetNode* ancestor_tag_node;
+	String ancestor_id;
+	StringList ancestor_classes;
+	StringList ancestor_pseudo_classes;
+	std::vector< const StyleSheetNode* > ancestor_structural_pseudo_classes;
+	// The filter hashes of the tags, ids and classes required of all of our ancestors.
+	std::vector< unsigned int > ancestor_hashes;
+
+	// The generic properties for this node, shared with the element definitions we apply to.
+	PropertyLayer* property_layer;
 
 	// This node's child nodes, whether standard tagged children, or further derivations of this tag by ID or class.
 	typedef std::map< String, StyleSheetNode* > NodeMap;
@@ -31,22 +31,31 @@
 #include "PropertyParserColour.h"
 #include "PropertyParserKeyword.h"
 #include "PropertyParserString.h"
+#include "PropertyParseCache.h"
 
 namespace Rocket {
 namespace Core {
 
 static StyleSheetSpecification* instance = NULL;
 
+// The number of declarations held in the parsed declaration cache.
+static const size_t PARSE_CACHE_SIZE = 512;
+
 StyleSheetSpecification::StyleSheetSpecification()
 {
 	ROCKET_ASSERT(instance == NULL);
 	instance = this;
+
+	parse_cache = new PropertyParseCache(PARSE_CACHE_SIZE);
+	parse_cache_enabled = true;
 }
 
 StyleSheetSpecification::~StyleSheetSpecification()
 {
 	ROCKET_ASSERT(instance == this);
 	instance = NULL;
+
+	delete parse_cache;
 }
 
 bool StyleSheetSpecification::Initialise()
@@ -81,6 +90,7 @@ bool StyleSheetSpecification::RegisterParser(const String& parser_name, Property
 		(*iterator).second->Release();
 
 	instance->parsers[parser_name] = parser;
+	instance->parse_cache->Clear();
 	return true;
 }
 
@@ -97,6 +107,8 @@ PropertyParser* StyleSheetSpecification::GetParser(const String& parser_name)
 // Registers a property with a new definition.
 PropertyDefinition& StyleSheetSpecification::RegisterProperty(const String& property_name, const String& default_value, bool inherited, bool forces_layout)
 {
+	instance->parse_cache->Clear();
+
 	return instance->properties.RegisterProperty(property_name, default_value, inherited, forces_layout);
 }
 
@@ -106,6 +118,27 @@ const PropertyDefinition* StyleSheetSpecification::GetProperty(const String& pro
 	return instance->properties.GetProperty(property_name);
 }
 
+// Returns a property definition.
+const PropertyDefinition* StyleSheetSpecification::GetProperty(PropertyId id)
+{
+	return instance->properties.GetProperty(id);
+}
+
+// Returns the identifier of a registered property.
+PropertyId StyleSheetSpecification::GetPropertyId(const String& property_name)
+{
+	if (instance == NULL)
+		return PROPERTY_INVALID;
+
+	return instance->properties.GetPropertyId(property_name);
+}
+
+// Returns the name a property was registered under.
+const String& StyleSheetSpecification::GetPropertyName(PropertyId id)
+{
+	return instance->properties.GetPropertyName(id);
+}
+
 // Fetches a list of the names of all registered property definitions.
 const PropertyNameList& StyleSheetSpecification::GetRegisteredProperties()
 {
@@ -117,9 +150,22 @@ const PropertyNameList & StyleSheetSpecification::GetRegisteredInheritedProperti
 	return instance->properties.GetRegisteredInheritedProperties();
 }
 
+// Returns the set of the identifiers of all registered property definitions.
+const PropertyIdSet& StyleSheetSpecification::GetRegisteredPropertyIds()
+{
+	return instance->properties.GetRegisteredPropertyIds();
+}
+
+// Returns the set of the identifiers of all registered inherited property definitions.
+const PropertyIdSet& StyleSheetSpecification::GetRegisteredInheritedPropertyIds()
+{
+	return instance->properties.GetRegisteredInheritedPropertyIds();
+}
+
 // Registers a shorthand property definition.
 bool StyleSheetSpecification::RegisterShorthand(const String& shorthand_name, const String& property_names, PropertySpecification::ShorthandType type)
 {
+	instance->parse_cache->Clear();
 	return instance->properties.RegisterShorthand(shorthand_name, property_names, type);
 }
 
@@ -135,6 +181,42 @@ bool StyleSheetSpecification::ParsePropertyDeclaration(PropertyDictionary& dicti
 	return instance->properties.ParsePropertyDeclaration(dictionary, property_name, property_value, source_file, source_line_number);
 }
 
+// Parses a property declaration without a source, caching the parsed values of recent declarations.
+bool StyleSheetSpecification::ParseCachedPropertyDeclaration(PropertyDictionary& dictionary, const String& property_name, const String& property_value)
+{
+	if (!instance->parse_cache_enabled)
+		return instance->properties.ParsePropertyDeclaration(dictionary, property_name, property_value, "", 0);
+
+	const PropertyDictionary* parsed_properties = instance->parse_cache->Find(property_name, property_value);
+
+	PropertyDictionary new_properties;
+	bool success = true;
+	if (parsed_properties == NULL)
+	{
+		// Only successful declarations are cached; a shorthand that fails part-way through still sets the properties
+		// it did parse.
+		success = instance->properties.ParsePropertyDeclaration(new_properties, property_name, property_value, "", 0);
+		if (success)
+			instance->parse_cache->Insert(property_name, property_value, new_properties);
+
+		parsed_properties = &new_properties;
+	}
+
+	const PropertyMap& properties = parsed_properties->GetProperties();
+	for (PropertyMap::const_iterator i = properties.begin(); i != properties.end(); ++i)
+		dictionary.SetProperty((*i).first, (*i).second);
+
+	return success;
+}
+
+// Enables or disables the cache used by ParseCachedPropertyDeclaration().
+void StyleSheetSpecification::SetParseCacheEnabled(bool enabled)
+{
+	instance->parse_cache_enabled = enabled;
+	if (!enabled)
+		instance->parse_cache->Clear();
+}
+
 // Registers Rocket's default parsers.
 void StyleSheetSpecification::RegisterDefaultParsers()
 {
@@ -261,6 +343,11 @@ void StyleSheetSpecification::RegisterDefaultProperties()
 	RegisterProperty(FOCUS, "auto", true, false).AddParser("keyword", "none, auto");
 
 	RegisterProperty(SCROLLBAR_MARGIN, "0", false, false).AddParser("number");
+
+	// The default properties must have been registered in the order of their identifiers.
+	ROCKET_ASSERT(GetPropertyId(MARGIN_TOP) == PROPERTY_MARGIN_TOP);
+	ROCKET_ASSERT(GetPropertyId(SCROLLBAR_MARGIN) == PROPERTY_SCROLLBAR_MARGIN);
+	ROCKET_ASSERT((int) GetRegisteredProperties().size() == NUM_DEFAULT_PROPERTIES);
 }
 
 }
@@ -0,0 +1,218 @@
+/*
+ * This source file is part of libRocket, the HTML/CSS Interface Middleware
+ *
+ * For the latest information, see http://www.librocket.com
+ *
+ * Copyright (c) 2008-2010 CodePoint Ltd, Shift Technology Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+#include "precompiled.h"
+#include <Rocket/Core/StyleStatistics.h>
+#include "AtomicCounter.h"
+#include "StyleStatisticsRecorder.h"
+
+namespace Rocket {
+namespace Core {
+
+#ifdef ROCKET_ENABLE_STYLE_STATS
+
+// The counters are updated as properties are looked up from layout tasks, which may be running concurrently, so the
+// lookups are counted in a fixed table rather than one that grows as new properties are seen.
+static const int MAX_COUNTED_PROPERTIES = 256;
+static volatile unsigned int property_lookups[MAX_COUNTED_PROPERTIES];
+static volatile unsigned int total_property_lookups = 0;
+static volatile unsigned int cache_hits = 0;
+static volatile unsigned int cache_misses = 0;
+static volatile unsigned int inherited_lookups = 0;
+static volatile unsigned int inherited_walk_steps = 0;
+static volatile unsigned int max_inherited_walk_depth = 0;
+static volatile unsigned int pseudo_class_changes = 0;
+static volatile unsigned int pseudo_class_restyles = 0;
+
+// Records a lookup of a property through an element's style.
+void StyleStatisticsRecorder::OnPropertyLookup(PropertyId id)
+{
+	if (id < 0)
+		return;
+
+	if (id < MAX_COUNTED_PROPERTIES)
+		AtomicAdd(property_lookups[id], 1);
+
+	AtomicAdd(total_property_lookups, 1);
+}
+
+// Records an element style cache request served from the cache.
+void StyleStatisticsRecorder::OnCacheHit()
+{
+	AtomicAdd(cache_hits, 1);
+}
+
+// Records an element style cache request that had to resolve its property.
+void StyleStatisticsRecorder::OnCacheMiss()
+{
+	AtomicAdd(cache_misses, 1);
+}
+
+// Records the resolution of an inherited property from an element's ancestors.
+void StyleStatisticsRecorder::OnInheritedLookup(int depth)
+{
+	AtomicAdd(inherited_lookups, 1);
+	AtomicAdd(inherited_walk_steps, depth);
+	AtomicMax(max_inherited_walk_depth, depth);
+}
+
+// Records a pseudo-class being set on or removed from an element.
+void StyleStatisticsRecorder::OnPseudoClassChange(int num_restyles)
+{
+	AtomicAdd(pseudo_class_changes, 1);
+	AtomicAdd(pseudo_class_restyles, num_restyles);
+}
+
+bool StyleStatistics::IsEnabled()
+{
+	return true;
+}
+
+void StyleStatistics::Reset()
+{
+	for (int i = 0; i < MAX_COUNTED_PROPERTIES; ++i)
+		property_lookups[i] = 0;
+	total_property_lookups = 0;
+	cache_hits = 0;
+	cache_misses = 0;
+	inherited_lookups = 0;
+	inherited_walk_steps = 0;
+	max_inherited_walk_depth = 0;
+	pseudo_class_changes = 0;
+	pseudo_class_restyles = 0;
+}
+
+unsigned int StyleStatistics::GetPropertyLookups(PropertyId id)
+{
+	if (id < 0 ||
+		id >= MAX_COUNTED_PROPERTIES)
+		return 0;
+
+	return property_lookups[id];
+}
+
+unsigned int StyleStatistics::GetTotalPropertyLookups()
+{
+	return total_property_lookups;
+}
+
+unsigned int StyleStatistics::GetCacheHits()
+{
+	return cache_hits;
+}
+
+unsigned int StyleStatistics::GetCacheMisses()
+{
+	return cache_misses;
+}
+
+unsigned int StyleStatistics::GetInheritedLookups()
+{
+	return inherited_lookups;
+}
+
+unsigned int StyleStatistics::GetInheritedWalkSteps()
+{
+	return inherited_walk_steps;
+}
+
+unsigned int StyleStatistics::GetMaxInheritedWalkDepth()
+{
+	return max_inherited_walk_depth;
+}
+
+unsigned int StyleStatistics::GetPseudoClassChanges()
+{
+	return pseudo_class_changes;
+}
+
+unsigned int StyleStatistics::GetPseudoClassRestyles()
+{
+	return pseudo_class_restyles;
+}
+
+#else
+
+bool StyleStatistics::IsEnabled()
+{
+	return false;
+}
+
+void StyleStatistics::Reset()
+{
+}
+
+unsigned int StyleStatistics::GetPropertyLookups(PropertyId ROCKET_UNUSED(id))
+{
+	return 0;
+}
+
+unsigned int StyleStatistics::GetTotalPropertyLookups()
+{
+	return 0;
+}
+
+unsigned int StyleStatistics::GetCacheHits()
+{
+	return 0;
+}
+
+unsigned int StyleStatistics::GetCacheMisses()
+{
+	return 0;
+}
+
+unsigned int StyleStatistics::GetInheritedLookups()
+{
+	return 0;
+}
+
+unsigned int StyleStatistics::GetInheritedWalkSteps()
+{
+	return 0;
+}
+
+unsigned int StyleStatistics::GetMaxInheritedWalkDepth()
+{
+	return 0;
+}
+
+unsigned int StyleStatistics::GetPseudoClassChanges()
+{
+	return 0;
+}
+
+unsigned int StyleStatistics::GetPseudoClassRestyles()
+{
+	return 0;
+}
+
+#endif
+
+}
+}
@@ -0,0 +1,68 @@
+/*
+ * This source file is part of libRocket, the HTML/CSS Interface Middleware
+ *
+ * For the latest information, see http://www.librocket.com
+ *
+ * Copyright (c) 2008-2010 CodePoint Ltd, Shift Technology Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+#ifndef ROCKETCORESTYLESTATISTICSRECORDER_H
+#define ROCKETCORESTYLESTATISTICSRECORDER_H
+
+#include <Rocket/Core/PropertyIds.h>
+
+namespace Rocket {
+namespace Core {
+
+/**
+	Internal recording points for StyleStatistics. Call sites should use ROCKET_STYLE_STATISTIC() so the recording
+	compiles to nothing unless ROCKET_ENABLE_STYLE_STATS is defined.
+ */
+
+class StyleStatisticsRecorder
+{
+public:
+	/// Records a lookup of a property through an element's style.
+	static void OnPropertyLookup(PropertyId id);
+	/// Records an element style cache request served from the cache.
+	static void OnCacheHit();
+	/// Records an element style cache request that had to resolve its property.
+	static void OnCacheMiss();
+	/// Records the resolution of an inherited property from an element's ancestors.
+	/// @param[in] depth The number of ancestors visited.
+	static void OnInheritedLookup(int depth);
+	/// Records a pseudo-class being set on or removed from an element.
+	/// @param[in] num_restyles The number of element definitions dirtied by the change.
+	static void OnPseudoClassChange(int num_restyles);
+};
+
+}
+}
+
+#ifdef ROCKET_ENABLE_STYLE_STATS
+#define ROCKET_STYLE_STATISTIC(statement) Rocket::Core::StyleStatisticsRecorder::statement
+#else
+#define ROCKET_STYLE_STATISTIC(statement) ((void) 0)
+#endif
+
+#endif
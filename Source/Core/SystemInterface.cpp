@@ -107,6 +107,19 @@ void SystemInterface::JoinPath(String& translated_path, const String& document_p
 	translated_path = url.GetPathedFileName().Replace("|", ":");
 }
 	
+// Returns the number of tasks the application can run concurrently through RunTasks().
+int SystemInterface::GetMaxConcurrentTasks()
+{
+	return 1;
+}
+
+// Runs a batch of independent tasks, returning once every task has completed.
+void SystemInterface::RunTasks(TaskFunction function, void* data, int num_tasks)
+{
+	for (int i = 0; i < num_tasks; ++i)
+		function(data, i);
+}
+
 // Activate keyboard (for touchscreen devices)
 void SystemInterface::ActivateKeyboard() 
 {
@@ -183,6 +183,16 @@ void WidgetSlider::Update()
 			}
 		}
 	}
+
+	// We're updated from the update of the element we're scrolling; it has to be visited again while an arrow is
+	// held down.
+	if (arrow_timers[0] > 0 ||
+		arrow_timers[1] > 0)
+	{
+		Element* scrolled_element = parent->GetParentNode();
+		if (scrolled_element != NULL)
+			scrolled_element->DirtyUpdate();
+	}
 }
 
 // Sets the position of the bar.
@@ -331,11 +341,11 @@ void WidgetSlider::FormatBar(float bar_length)
 				bar_box_content.y = track_length * bar_length;
 
 				// Check for 'min-height' restrictions.
-				float min_track_length = bar->ResolveProperty(MIN_HEIGHT, track_length);
+				float min_track_length = bar->ResolveProperty(PROPERTY_MIN_HEIGHT, track_length);
 				bar_box_content.y = Math::Max(min_track_length, bar_box_content.y);
 
 				// Check for 'max-height' restrictions.
-				float max_track_length = bar->ResolveProperty(MAX_HEIGHT, track_length);
+				float max_track_length = bar->ResolveProperty(PROPERTY_MAX_HEIGHT, track_length);
 				if (max_track_length > 0)
 					bar_box_content.y = Math::Min(max_track_length, bar_box_content.y);
 			}
@@ -352,11 +362,11 @@ void WidgetSlider::FormatBar(float bar_length)
 				bar_box_content.x = track_length * bar_length;
 
 				// Check for 'min-width' restrictions.
-				float min_track_length = bar->ResolveProperty(MIN_WIDTH, track_length);
+				float min_track_length = bar->ResolveProperty(PROPERTY_MIN_WIDTH, track_length);
 				bar_box_content.x = Math::Max(min_track_length, bar_box_content.x);
 
 				// Check for 'max-width' restrictions.
-				float max_track_length = bar->ResolveProperty(MAX_WIDTH, track_length);
+				float max_track_length = bar->ResolveProperty(PROPERTY_MAX_WIDTH, track_length);
 				if (max_track_length > 0)
 					bar_box_content.x = Math::Min(max_track_length, bar_box_content.x);
 			}
@@ -455,6 +465,12 @@ void WidgetSlider::ProcessEvent(Event& event)
 			last_update_time = Clock::GetElapsedTime();
 			SetBarPosition(OnLineIncrement());
 		}
+
+		// The element we're scrolling has to update us until the arrow is released.
+		if ((arrow_timers[0] > 0 ||
+			 arrow_timers[1] > 0) &&
+			parent->GetParentNode() != NULL)
+			parent->GetParentNode()->DirtyUpdate();
 	}
 	else if (event == MOUSEUP ||
 			 event == MOUSEOUT)
@@ -29,9 +29,12 @@
 #include <Rocket/Core/Property.h>
 #include <Rocket/Core/Factory.h>
 #include <Rocket/Core/StyleSheet.h>
+#include <Rocket/Core/StyleSheetSpecification.h>
+#include <Rocket/Core/StyleStatistics.h>
 #include "Geometry.h"
 #include "CommonSource.h"
 #include "InfoSource.h"
+#include <functional>
 #include <map>
 
 namespace Rocket {
@@ -145,6 +148,12 @@ void ElementInfo::ProcessEvent(Core::Event& event)
 					if (IsVisible())
 						SetProperty("visibility", "hidden");
 				}
+				else if (target_element->GetId() == "style-statistics-reset")
+				{
+					Core::StyleStatistics::Reset();
+					UpdateStyleStatistics();
+					event.StopPropagation();
+				}
 				// Check if the id is in the form "a %d" or "c %d" - these are the ancestor or child labels.
 				else
 				{
@@ -365,6 +374,67 @@ void ElementInfo::UpdateSourceElement()
 		else
 			children_content->SetInnerRML(children);
 	}
+
+	UpdateStyleStatistics();
+}
+
+void ElementInfo::UpdateStyleStatistics()
+{
+	Core::Element* statistics_content = GetElementById("style-statistics-content");
+	if (statistics_content == NULL)
+		return;
+
+	if (!Core::StyleStatistics::IsEnabled())
+	{
+		statistics_content->SetInnerRML("<em>Rebuild with ROCKET_ENABLE_STYLE_STATS to gather statistics.</em>");
+		return;
+	}
+
+	// Take a snapshot of the counters before we generate any RML, as formatting the panel will cause lookups itself.
+	unsigned int total_lookups = Core::StyleStatistics::GetTotalPropertyLookups();
+	unsigned int cache_hits = Core::StyleStatistics::GetCacheHits();
+	unsigned int cache_misses = Core::StyleStatistics::GetCacheMisses();
+	unsigned int inherited_lookups = Core::StyleStatistics::GetInheritedLookups();
+	unsigned int inherited_walk_steps = Core::StyleStatistics::GetInheritedWalkSteps();
+	unsigned int max_inherited_walk_depth = Core::StyleStatistics::GetMaxInheritedWalkDepth();
+	unsigned int pseudo_class_changes = Core::StyleStatistics::GetPseudoClassChanges();
+	unsigned int pseudo_class_restyles = Core::StyleStatistics::GetPseudoClassRestyles();
+
+	// Sort the registered properties by their lookup counts.
+	typedef std::multimap< unsigned int, Core::PropertyId, std::greater< unsigned int > > PropertyLookupMap;
+	PropertyLookupMap property_lookups;
+	for (Core::PropertyId id = 0; id < Core::NUM_DEFAULT_PROPERTIES; ++id)
+	{
+		unsigned int lookups = Core::StyleStatistics::GetPropertyLookups(id);
+		if (lookups > 0)
+			property_lookups.insert(PropertyLookupMap::value_type(lookups, id));
+	}
+
+	Core::String statistics;
+	statistics.Append(Core::String(64, "property lookups: <em>%u</em><br />", total_lookups));
+	statistics.Append(Core::String(64, "cache hits: <em>%u</em><br />", cache_hits));
+	statistics.Append(Core::String(64, "cache misses: <em>%u</em><br />", cache_misses));
+	statistics.Append(Core::String(64, "inherited lookups: <em>%u</em><br />", inherited_lookups));
+	statistics.Append(Core::String(64, "average walk depth: <em>%.2f</em><br />", inherited_lookups > 0 ? inherited_walk_steps / (float) inherited_lookups : 0.0f));
+	statistics.Append(Core::String(64, "maximum walk depth: <em>%u</em><br />", max_inherited_walk_depth));
+	statistics.Append(Core::String(64, "pseudo-class changes: <em>%u</em><br />", pseudo_class_changes));
+	statistics.Append(Core::String(64, "restyles per change: <em>%.2f</em><br />", pseudo_class_changes > 0 ? pseudo_class_restyles / (float) pseudo_class_changes : 0.0f));
+
+	if (!property_lookups.empty())
+	{
+		statistics.Append("<h3>most looked-up properties</h3>");
+
+		int num_listed = 0;
+		for (PropertyLookupMap::const_iterator i = property_lookups.begin(); i != property_lookups.end() && num_listed < 10; ++i, ++num_listed)
+		{
+			const Core::String& name = Core::StyleSheetSpecification::GetPropertyName((*i).second);
+			statistics.Append(Core::String(name.Length() + 32, "%s: <em>%u</em><br />", name.CString(), (*i).first));
+		}
+	}
+
+	statistics.Append("<p id=\"style-statistics-reset\">reset</p>");
+
+	statistics_content->SetInnerRML(statistics);
 }
 
 void ElementInfo::BuildElementPropertiesRML(Core::String& property_rml, Core::Element* element, Core::Element* primary_element)
@@ -392,9 +462,9 @@ void ElementInfo::BuildElementPropertiesRML(Core::String& property_rml, Core::El
 			NamedPropertyList::iterator insert_iterator = properties.begin();
 			while (insert_iterator != properties.end())
 			{
-				int source_cmp = strcasecmp((*insert_iterator).second->source.CString(), property->source.CString());
+				int source_cmp = strcasecmp((*insert_iterator).second->GetSource().CString(), property->GetSource().CString());
 				if (source_cmp > 0 ||
-					(source_cmp == 0 && (*insert_iterator).second->source_line_number >= property->source_line_number))
+					(source_cmp == 0 && (*insert_iterator).second->GetSourceLineNumber() >= property->GetSourceLineNumber()))
 					break;
 
 				++insert_iterator;
@@ -447,11 +517,11 @@ void ElementInfo::BuildPropertiesRML(Core::String& property_rml, const NamedProp
 	for (size_t i = 0; i < properties.size(); ++i)
 	{
 		if (i == 0 ||
-			last_source != properties[i].second->source ||
-			last_source_line != properties[i].second->source_line_number)
+			last_source != properties[i].second->GetSource() ||
+			last_source_line != properties[i].second->GetSourceLineNumber())
 		{
-			last_source = properties[i].second->source;
-			last_source_line = properties[i].second->source_line_number;
+			last_source = properties[i].second->GetSource();
+			last_source_line = properties[i].second->GetSourceLineNumber();
 
 			property_rml.Append("<h4>");
 
@@ -66,6 +66,7 @@ protected:
 private:
 	void SetSourceElement(Core::Element* new_source_element);
 	void UpdateSourceElement();
+	void UpdateStyleStatistics();
 
 	void BuildElementPropertiesRML(Core::String& property_rml, Core::Element* element, Core::Element* primary_element);
 	void BuildPropertiesRML(Core::String& property_rml, const NamedPropertyList& properties);
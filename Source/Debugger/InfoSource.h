@@ -45,7 +45,8 @@ static const char* info_rcss =
 "	font-size: 10;\n"
 "}\n"
 "div#ancestors p:hover,\n"
-"div#children p:hover\n"
+"div#children p:hover,\n"
+"div#style-statistics p:hover\n"
 "{\n"
 "	background-color: #ddd;\n"
 "}\n"
@@ -87,4 +88,9 @@ static const char* info_rml =
 "		<div id=\"children-content\">\n"
 "		</div>\n"
 "	</div>\n"
+"	<div id =\"style-statistics\">\n"
+"		<h2>Style Statistics</h2>\n"
+"		<div id=\"style-statistics-content\">\n"
+"		</div>\n"
+"	</div>\n"
 "</div>\n";
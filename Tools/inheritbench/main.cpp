@@ -0,0 +1,239 @@
+/*
+ * This source file is part of libRocket, the HTML/CSS Interface Middleware
+ *
+ * For the latest information, see http://www.librocket.com
+ *
+ * Copyright (c) 2008-2010 CodePoint Ltd, Shift Technology Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+#include <Rocket/Core.h>
+#include <Rocket/Core/StyleSheetSpecification.h>
+#include <Rocket/Core/StyleStatistics.h>
+#include <stdio.h>
+#include <time.h>
+
+/*
+	Measures the cost of reading an inherited property on an element that doesn't define it, over chains of elements
+	of increasing depth. The property is defined on the root of each chain and read from the leaf.
+
+	Each chain is measured twice: repeated reads of the memoised value, and reads immediately after the root's value
+	has been changed, which discard the memoised values of the whole chain. With the library built with style
+	statistics enabled, the number of reads served from the memoised values and the number that had to ask the
+	element's parent are also reported.
+
+	Before measuring, the memoised values are checked not to outlive the properties they refer to in the cases that
+	have gone wrong before; the benchmark exits with an error if any check fails.
+ */
+
+class BenchmarkSystemInterface : public Rocket::Core::SystemInterface
+{
+public:
+	virtual float GetElapsedTime()
+	{
+		return (float) clock() / CLOCKS_PER_SEC;
+	}
+
+	virtual bool LogMessage(Rocket::Core::Log::Type ROCKET_UNUSED(type), const Rocket::Core::String& message)
+	{
+		fprintf(stderr, "%s\n", message.CString());
+		return true;
+	}
+};
+
+// Creates an element outside of any document.
+static Rocket::Core::Element* CreateElement()
+{
+	return Rocket::Core::Factory::InstanceElement(NULL, "div", "div", Rocket::Core::XMLAttributes());
+}
+
+// Returns the time since an earlier call to clock(), in nanoseconds per iteration.
+static double GetNanosecondsPerIteration(clock_t start, int num_iterations)
+{
+	return (double) (clock() - start) * 1e9 / CLOCKS_PER_SEC / num_iterations;
+}
+
+// Prints the hits and misses on the memoised inherited values since the statistics were last reset.
+static void PrintStatistics()
+{
+	if (!Rocket::Core::StyleStatistics::IsEnabled())
+	{
+		printf("\n");
+		return;
+	}
+
+	// A read served from the memoised value takes no steps up the tree; a miss takes one, to the parent.
+	unsigned int lookups = Rocket::Core::StyleStatistics::GetInheritedLookups();
+	unsigned int misses = Rocket::Core::StyleStatistics::GetInheritedWalkSteps();
+	printf(" %10u %10u\n", lookups - misses, misses);
+}
+
+// Checks that an element reads an inherited property's default value, rather than a value memoised from an element
+// that was once its parent.
+static bool CheckDefaultColour(Rocket::Core::Element* element, const char* name)
+{
+	const Rocket::Core::Property* colour = element->GetProperty(Rocket::Core::PROPERTY_COLOR);
+	if (colour == Rocket::Core::StyleSheetSpecification::GetProperty(Rocket::Core::PROPERTY_COLOR)->GetDefaultValue())
+		return true;
+
+	fprintf(stderr, "check failed: %s\n", name);
+	return false;
+}
+
+// Checks that an element removed from its parent forgets the values it inherited, which may not outlive it.
+static bool CheckDetachedElement()
+{
+	Rocket::Core::Element* parent = CreateElement();
+	Rocket::Core::Element* child = CreateElement();
+	parent->AppendChild(child);
+
+	parent->SetProperty("color", "#ff0000");
+	child->GetProperty(Rocket::Core::PROPERTY_COLOR);
+
+	parent->RemoveChild(child);
+	parent->Update();
+	parent->RemoveProperty("color");
+
+	bool passed = CheckDefaultColour(child, "detached element");
+
+	child->RemoveReference();
+	parent->RemoveReference();
+
+	return passed;
+}
+
+// Checks that a property removed from an element during a style update isn't still read by its descendants.
+static bool CheckBatchedRemoval()
+{
+	Rocket::Core::Element* parent = CreateElement();
+	Rocket::Core::Element* child = CreateElement();
+	parent->AppendChild(child);
+	child->RemoveReference();
+
+	parent->SetProperty("color", "#ff0000");
+	child->GetProperty(Rocket::Core::PROPERTY_COLOR);
+
+	parent->BeginStyleUpdate();
+	parent->RemoveProperty("color");
+	bool passed = CheckDefaultColour(child, "property removed during a style update");
+	parent->EndStyleUpdate();
+
+	parent->RemoveReference();
+
+	return passed;
+}
+
+// Measures reads of an inherited property at the bottom of a chain of elements.
+static void RunBenchmark(int depth, int num_iterations)
+{
+	Rocket::Core::Element* root = CreateElement();
+	root->SetProperty("color", "#ff0000");
+
+	Rocket::Core::Element* leaf = root;
+	for (int i = 0; i < depth; ++i)
+	{
+		Rocket::Core::Element* child = CreateElement();
+		leaf->AppendChild(child);
+		child->RemoveReference();
+
+		leaf = child;
+	}
+
+	// Accumulate the colour so the reads can't be optimised away.
+	unsigned int checksum = 0;
+
+	leaf->GetProperty(Rocket::Core::PROPERTY_COLOR);
+	Rocket::Core::StyleStatistics::Reset();
+
+	clock_t start = clock();
+	for (int i = 0; i < num_iterations; ++i)
+		checksum += leaf->GetProperty(Rocket::Core::PROPERTY_COLOR)->value.Get< Rocket::Core::Colourb >().red;
+
+	printf("%6d %-12s %10.1f", depth, "memoised", GetNanosecondsPerIteration(start, num_iterations));
+	PrintStatistics();
+
+	// Each change of the root's colour is pushed down the chain, so the invalidation itself is linear in the depth.
+	// It is timed on its own, and subtracted from the time taken to change the colour and then read it again.
+	const char* colours[2] = { "#00ff00", "#0000ff" };
+	int num_changes = num_iterations / (depth + 1) + 1;
+
+	start = clock();
+	for (int i = 0; i < num_changes; ++i)
+		root->SetProperty("color", colours[i & 1]);
+	double change_nanoseconds = GetNanosecondsPerIteration(start, num_changes);
+
+	Rocket::Core::StyleStatistics::Reset();
+
+	start = clock();
+	for (int i = 0; i < num_changes; ++i)
+	{
+		root->SetProperty("color", colours[i & 1]);
+		checksum += leaf->GetProperty(Rocket::Core::PROPERTY_COLOR)->value.Get< Rocket::Core::Colourb >().green;
+	}
+	double read_nanoseconds = GetNanosecondsPerIteration(start, num_changes) - change_nanoseconds;
+
+	printf("%6d %-12s %10.1f", depth, "invalidated", read_nanoseconds > 0 ? read_nanoseconds : 0);
+	PrintStatistics();
+
+	if (checksum == 0)
+		printf("(checksum %u)\n", checksum);
+
+	root->RemoveReference();
+}
+
+int main(int argc, char** argv)
+{
+	int num_iterations = 1000000;
+	if (argc > 1)
+		sscanf(argv[1], "%d", &num_iterations);
+
+	if (num_iterations <= 0)
+	{
+		fprintf(stderr, "usage: %s [<iterations>]\n", argv[0]);
+		return 1;
+	}
+
+	BenchmarkSystemInterface system_interface;
+	Rocket::Core::SetSystemInterface(&system_interface);
+	if (!Rocket::Core::Initialise())
+		return 1;
+
+	if (!CheckDetachedElement() ||
+		!CheckBatchedRemoval())
+	{
+		Rocket::Core::Shutdown();
+		return 1;
+	}
+
+	printf("%6s %-12s %10s", "depth", "reads", "ns/read");
+	if (Rocket::Core::StyleStatistics::IsEnabled())
+		printf(" %10s %10s", "hits", "misses");
+	printf("\n");
+
+	const int depths[] = { 1, 4, 16, 64, 256 };
+	for (size_t i = 0; i < sizeof(depths) / sizeof(depths[0]); ++i)
+		RunBenchmark(depths[i], num_iterations);
+
+	Rocket::Core::Shutdown();
+
+	return 0;
+}
@@ -0,0 +1,336 @@
+/*
+ * This source file is part of libRocket, the HTML/CSS Interface Middleware
+ *
+ * For the latest information, see http://www.librocket.com
+ *
+ * Copyright (c) 2008-2010 CodePoint Ltd, Shift Technology Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+#include <Rocket/Core.h>
+#include <Rocket/Controls.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+/*
+	Formats a set of documents repeatedly, one at a time and then concurrently, and reports the time taken per frame.
+	It is also an example of a system interface that runs the library's tasks on threads: the tasks of each batch are
+	shared out between the calling thread and a set of worker threads started for the batch, each taking the next
+	task until there are none left. An application would more likely submit the tasks to its own job system.
+ */
+
+#ifdef _WIN32
+typedef CRITICAL_SECTION Mutex;
+static void InitialiseMutex(Mutex& mutex) { InitializeCriticalSection(&mutex); }
+static void DestroyMutex(Mutex& mutex) { DeleteCriticalSection(&mutex); }
+static void LockMutex(Mutex& mutex) { EnterCriticalSection(&mutex); }
+static void UnlockMutex(Mutex& mutex) { LeaveCriticalSection(&mutex); }
+#else
+typedef pthread_mutex_t Mutex;
+static void InitialiseMutex(Mutex& mutex) { pthread_mutex_init(&mutex, NULL); }
+static void DestroyMutex(Mutex& mutex) { pthread_mutex_destroy(&mutex); }
+static void LockMutex(Mutex& mutex) { pthread_mutex_lock(&mutex); }
+static void UnlockMutex(Mutex& mutex) { pthread_mutex_unlock(&mutex); }
+#endif
+
+// Returns the wall-clock time in seconds, from an arbitrary starting point.
+static double GetTime()
+{
+#ifdef _WIN32
+	LARGE_INTEGER frequency, counter;
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&counter);
+	return (double) counter.QuadPart / (double) frequency.QuadPart;
+#else
+	timeval time;
+	gettimeofday(&time, NULL);
+	return time.tv_sec + time.tv_usec * 1e-6;
+#endif
+}
+
+// Returns the number of processors available to run threads on.
+static int GetNumProcessors()
+{
+#ifdef _WIN32
+	SYSTEM_INFO system_info;
+	GetSystemInfo(&system_info);
+	return (int) system_info.dwNumberOfProcessors;
+#else
+	long num_processors = sysconf(_SC_NPROCESSORS_ONLN);
+	return num_processors > 0 ? (int) num_processors : 1;
+#endif
+}
+
+class ThreadedSystemInterface : public Rocket::Core::SystemInterface
+{
+public:
+	ThreadedSystemInterface(int _num_threads) : num_threads(_num_threads)
+	{
+		InitialiseMutex(mutex);
+	}
+
+	virtual ~ThreadedSystemInterface()
+	{
+		DestroyMutex(mutex);
+	}
+
+	virtual float GetElapsedTime()
+	{
+		return (float) GetTime();
+	}
+
+	// Messages may be logged from any of the tasks.
+	virtual bool LogMessage(Rocket::Core::Log::Type ROCKET_UNUSED(type), const Rocket::Core::String& message)
+	{
+		LockMutex(mutex);
+		fprintf(stderr, "%s\n", message.CString());
+		UnlockMutex(mutex);
+
+		return true;
+	}
+
+	virtual int GetMaxConcurrentTasks()
+	{
+		return num_threads;
+	}
+
+	virtual void RunTasks(TaskFunction _function, void* _data, int _num_tasks)
+	{
+		function = _function;
+		data = _data;
+		num_tasks = _num_tasks;
+		next_task = 0;
+
+		int num_workers = (num_tasks < num_threads ? num_tasks : num_threads) - 1;
+
+#ifdef _WIN32
+		std::vector< HANDLE > workers;
+		for (int i = 0; i < num_workers; ++i)
+		{
+			HANDLE worker = CreateThread(NULL, 0, WorkerMain, this, 0, NULL);
+			if (worker != NULL)
+				workers.push_back(worker);
+		}
+
+		RunWorker();
+
+		for (size_t i = 0; i < workers.size(); ++i)
+		{
+			WaitForSingleObject(workers[i], INFINITE);
+			CloseHandle(workers[i]);
+		}
+#else
+		std::vector< pthread_t > workers;
+		for (int i = 0; i < num_workers; ++i)
+		{
+			pthread_t worker;
+			if (pthread_create(&worker, NULL, WorkerMain, this) == 0)
+				workers.push_back(worker);
+		}
+
+		RunWorker();
+
+		for (size_t i = 0; i < workers.size(); ++i)
+			pthread_join(workers[i], NULL);
+#endif
+	}
+
+private:
+#ifdef _WIN32
+	static DWORD WINAPI WorkerMain(LPVOID system_interface)
+	{
+		((ThreadedSystemInterface*) system_interface)->RunWorker();
+		return 0;
+	}
+#else
+	static void* WorkerMain(void* system_interface)
+	{
+		((ThreadedSystemInterface*) system_interface)->RunWorker();
+		return NULL;
+	}
+#endif
+
+	// Runs tasks from the current batch until there are none left.
+	void RunWorker()
+	{
+		for (;;)
+		{
+			LockMutex(mutex);
+			int task_index = next_task++;
+			UnlockMutex(mutex);
+
+			if (task_index >= num_tasks)
+				break;
+
+			function(data, task_index);
+		}
+	}
+
+	int num_threads;
+	Mutex mutex;
+
+	// The current batch of tasks, and the index of the next task to be run.
+	TaskFunction function;
+	void* data;
+	int num_tasks;
+	int next_task;
+};
+
+class NullRenderInterface : public Rocket::Core::RenderInterface
+{
+public:
+	virtual void RenderGeometry(Rocket::Core::Vertex* ROCKET_UNUSED(vertices), int ROCKET_UNUSED(num_vertices), int* ROCKET_UNUSED(indices), int ROCKET_UNUSED(num_indices), Rocket::Core::TextureHandle ROCKET_UNUSED(texture), const Rocket::Core::Vector2f& ROCKET_UNUSED(translation))
+	{
+	}
+
+	virtual void EnableScissorRegion(bool ROCKET_UNUSED(enable))
+	{
+	}
+
+	virtual void SetScissorRegion(int ROCKET_UNUSED(x), int ROCKET_UNUSED(y), int ROCKET_UNUSED(width), int ROCKET_UNUSED(height))
+	{
+	}
+
+	virtual bool LoadTexture(Rocket::Core::TextureHandle& texture_handle, Rocket::Core::Vector2i& texture_dimensions, const Rocket::Core::String& ROCKET_UNUSED(source))
+	{
+		texture_handle = 1;
+		texture_dimensions = Rocket::Core::Vector2i(64, 64);
+		return true;
+	}
+
+	virtual bool GenerateTexture(Rocket::Core::TextureHandle& texture_handle, const Rocket::Core::byte* ROCKET_UNUSED(source), const Rocket::Core::Vector2i& ROCKET_UNUSED(source_dimensions))
+	{
+		texture_handle = 1;
+		return true;
+	}
+
+	virtual void ReleaseTexture(Rocket::Core::TextureHandle ROCKET_UNUSED(texture_handle))
+	{
+	}
+};
+
+// Returns true if a path names a font face rather than a document.
+static bool IsFontFace(const char* path)
+{
+	size_t length = strlen(path);
+	return length > 4 &&
+		   (strcmp(path + length - 4, ".otf") == 0 ||
+			strcmp(path + length - 4, ".ttf") == 0);
+}
+
+// Formats the context's documents a number of times, and returns the time taken per frame in milliseconds.
+static double TimeLayout(Rocket::Core::Context* context, int num_frames)
+{
+	const char* widths[2] = { "100%", "99%" };
+
+	double start = GetTime();
+	for (int i = 0; i < num_frames; ++i)
+	{
+		// Changing the width of each document's body forces it to be formatted in its entirety.
+		for (int j = 0; j < context->GetNumDocuments(); ++j)
+			context->GetDocument(j)->SetProperty("width", widths[i & 1]);
+
+		context->Update();
+		context->Render();
+	}
+
+	return (GetTime() - start) * 1000.0 / num_frames;
+}
+
+int main(int argc, char** argv)
+{
+	int num_frames = 100;
+	int num_threads = GetNumProcessors();
+
+	std::vector< const char* > font_faces;
+	std::vector< const char* > documents;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+			sscanf(argv[++i], "%d", &num_frames);
+		else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+			sscanf(argv[++i], "%d", &num_threads);
+		else if (IsFontFace(argv[i]))
+			font_faces.push_back(argv[i]);
+		else
+			documents.push_back(argv[i]);
+	}
+
+	if (documents.empty() ||
+		num_frames <= 0 ||
+		num_threads <= 0)
+	{
+		fprintf(stderr, "usage: %s [-n <frames>] [-t <threads>] <font face> [<font face> ...] <document> [<document> ...]\n", argv[0]);
+		return 1;
+	}
+
+	ThreadedSystemInterface system_interface(num_threads);
+	NullRenderInterface render_interface;
+	Rocket::Core::SetSystemInterface(&system_interface);
+	Rocket::Core::SetRenderInterface(&render_interface);
+	if (!Rocket::Core::Initialise())
+		return 1;
+
+	Rocket::Controls::Initialise();
+
+	for (size_t i = 0; i < font_faces.size(); ++i)
+		Rocket::Core::FontDatabase::LoadFontFace(font_faces[i]);
+
+	Rocket::Core::Context* context = Rocket::Core::CreateContext("layoutbench", Rocket::Core::Vector2i(1024, 768));
+	for (size_t i = 0; i < documents.size(); ++i)
+	{
+		Rocket::Core::ElementDocument* document = context->LoadDocument(documents[i]);
+		if (document != NULL)
+		{
+			document->Show();
+			document->RemoveReference();
+		}
+	}
+
+	// Format everything once, so both runs start from the same state.
+	context->Update();
+	context->Render();
+
+	context->SetConcurrentLayout(false);
+	double serial = TimeLayout(context, num_frames);
+
+	context->SetConcurrentLayout(true);
+	double concurrent = TimeLayout(context, num_frames);
+
+	printf("%d documents, %d frames\n", context->GetNumDocuments(), num_frames);
+	printf("one at a time: %8.3f ms/frame\n", serial);
+	printf("%2d threads:    %8.3f ms/frame\n", num_threads, concurrent);
+
+	context->RemoveReference();
+	Rocket::Core::Shutdown();
+
+	return 0;
+}
@@ -0,0 +1,126 @@
+/*
+ * This source file is part of libRocket, the HTML/CSS Interface Middleware
+ *
+ * For the latest information, see http://www.librocket.com
+ *
+ * Copyright (c) 2008-2010 CodePoint Ltd, Shift Technology Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+#include <Rocket/Core.h>
+#include <stdio.h>
+#include <time.h>
+
+/*
+	Measures the cost of setting properties on an element from strings, as script and game code do every frame, with
+	the parsed declaration cache disabled and enabled. Each property alternates between two values, covering the
+	common units and colour forms, and a shorthand.
+ */
+
+class BenchmarkSystemInterface : public Rocket::Core::SystemInterface
+{
+public:
+	virtual float GetElapsedTime()
+	{
+		return (float) clock() / CLOCKS_PER_SEC;
+	}
+
+	virtual bool LogMessage(Rocket::Core::Log::Type ROCKET_UNUSED(type), const Rocket::Core::String& message)
+	{
+		fprintf(stderr, "%s\n", message.CString());
+		return true;
+	}
+};
+
+struct Declaration
+{
+	const char* name;
+	const char* values[2];
+};
+
+static const Declaration declarations[] =
+{
+	{ "left", { "12px", "13px" } },
+	{ "width", { "1.5em", "2em" } },
+	{ "width", { "50%", "75%" } },
+	{ "color", { "rgb(255,128,0)", "rgba(0,128,255,128)" } },
+	{ "color", { "#ff8000", "#08f" } },
+	{ "margin", { "1px 2px 3px 4px", "4px 3px 2px 1px" } }
+};
+
+// Sets a declaration on an element repeatedly, and returns the time taken in nanoseconds per call.
+static double TimeDeclaration(Rocket::Core::Element* element, const Declaration& declaration, int num_iterations)
+{
+	Rocket::Core::String name(declaration.name);
+	Rocket::Core::String values[2] = { Rocket::Core::String(declaration.values[0]), Rocket::Core::String(declaration.values[1]) };
+
+	clock_t start = clock();
+	for (int i = 0; i < num_iterations; ++i)
+		element->SetProperty(name, values[i & 1]);
+
+	return (double) (clock() - start) * 1e9 / CLOCKS_PER_SEC / num_iterations;
+}
+
+int main(int argc, char** argv)
+{
+	int num_iterations = 200000;
+	if (argc > 1)
+		sscanf(argv[1], "%d", &num_iterations);
+
+	if (num_iterations <= 0)
+	{
+		fprintf(stderr, "usage: %s [<iterations>]\n", argv[0]);
+		return 1;
+	}
+
+	BenchmarkSystemInterface system_interface;
+	Rocket::Core::SetSystemInterface(&system_interface);
+	if (!Rocket::Core::Initialise())
+		return 1;
+
+	Rocket::Core::Element* element = Rocket::Core::Factory::InstanceElement(NULL, "div", "div", Rocket::Core::XMLAttributes());
+
+	printf("%-8s %-38s %12s %12s %8s\n", "property", "values", "uncached ns", "cached ns", "speedup");
+
+	for (size_t i = 0; i < sizeof(declarations) / sizeof(declarations[0]); ++i)
+	{
+		const Declaration& declaration = declarations[i];
+
+		Rocket::Core::StyleSheetSpecification::SetParseCacheEnabled(false);
+		double uncached = TimeDeclaration(element, declaration, num_iterations);
+
+		Rocket::Core::StyleSheetSpecification::SetParseCacheEnabled(true);
+		double cached = TimeDeclaration(element, declaration, num_iterations);
+
+		Rocket::Core::String values(declaration.values[0]);
+		values += " | ";
+		values += declaration.values[1];
+
+		printf("%-8s %-38s %12.1f %12.1f %7.2fx\n", declaration.name, values.CString(), uncached, cached, cached > 0 ? uncached / cached : 0);
+	}
+
+	element->RemoveReference();
+
+	Rocket::Core::Shutdown();
+
+	return 0;
+}
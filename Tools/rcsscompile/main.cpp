@@ -0,0 +1,147 @@
+/*
+ * This source file is part of libRocket, the HTML/CSS Interface Middleware
+ *
+ * For the latest information, see http://www.librocket.com
+ *
+ * Copyright (c) 2008-2010 CodePoint Ltd, Shift Technology Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+#include <Rocket/Core.h>
+#include <Rocket/Core/StreamMemory.h>
+#include <Rocket/Controls.h>
+#include <stdio.h>
+#include <vector>
+
+/*
+	Compiles RCSS style sheets into the precompiled binary form loaded by the style sheet factory. Each compiled
+	sheet is written alongside its source, with a 'c' appended to its name; the factory loads it instead of parsing
+	the source for as long as the source is unchanged.
+
+	Applications that register their own properties must compile their sheets with those properties registered, as
+	the compiled sheets are rejected otherwise. They can do so by calling StyleSheet::WriteCompiledStyleSheet()
+	themselves.
+ */
+
+class CompilerSystemInterface : public Rocket::Core::SystemInterface
+{
+public:
+	virtual float GetElapsedTime()
+	{
+		return 0;
+	}
+
+	virtual bool LogMessage(Rocket::Core::Log::Type ROCKET_UNUSED(type), const Rocket::Core::String& message)
+	{
+		fprintf(stderr, "%s\n", message.CString());
+		return true;
+	}
+};
+
+// Reads an entire file into a buffer.
+static bool ReadFile(std::vector< Rocket::Core::byte >& data, const char* path)
+{
+	FILE* file = fopen(path, "rb");
+	if (file == NULL)
+		return false;
+
+	fseek(file, 0, SEEK_END);
+	long length = ftell(file);
+	fseek(file, 0, SEEK_SET);
+
+	data.resize(length > 0 ? length : 0);
+	bool success = length >= 0 && (data.empty() || fread(&data[0], 1, data.size(), file) == data.size());
+
+	fclose(file);
+	return success;
+}
+
+// Compiles a single style sheet.
+static bool CompileStyleSheet(const char* source_path, const char* compiled_path)
+{
+	std::vector< Rocket::Core::byte > source_data;
+	if (!ReadFile(source_data, source_path))
+	{
+		fprintf(stderr, "Unable to read %s.\n", source_path);
+		return false;
+	}
+
+	// Keep the buffer valid even for an empty sheet.
+	source_data.push_back(0);
+	Rocket::Core::StreamMemory* source = new Rocket::Core::StreamMemory(&source_data[0], source_data.size() - 1);
+	source->SetSourceURL(Rocket::Core::URL(source_path));
+
+	Rocket::Core::StyleSheet* style_sheet = new Rocket::Core::StyleSheet();
+	Rocket::Core::StreamMemory* compiled = new Rocket::Core::StreamMemory();
+
+	bool success = false;
+	if (!style_sheet->LoadStyleSheet(source))
+		fprintf(stderr, "Unable to parse %s.\n", source_path);
+	else if (!style_sheet->WriteCompiledStyleSheet(compiled, source))
+		fprintf(stderr, "Unable to compile %s.\n", source_path);
+	else
+	{
+		FILE* file = fopen(compiled_path, "wb");
+		if (file != NULL)
+		{
+			success = fwrite(compiled->RawStream(), 1, compiled->Length(), file) == compiled->Length();
+			success = fclose(file) == 0 && success;
+		}
+
+		if (!success)
+			fprintf(stderr, "Unable to write %s.\n", compiled_path);
+	}
+
+	compiled->RemoveReference();
+	style_sheet->RemoveReference();
+	source->RemoveReference();
+
+	return success;
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 2)
+	{
+		fprintf(stderr, "usage: %s <style sheet> [<style sheet> ...]\n", argv[0]);
+		return 1;
+	}
+
+	CompilerSystemInterface system_interface;
+	Rocket::Core::SetSystemInterface(&system_interface);
+	if (!Rocket::Core::Initialise())
+		return 1;
+
+	Rocket::Controls::Initialise();
+
+	int num_failed = 0;
+	for (int i = 1; i < argc; ++i)
+	{
+		Rocket::Core::String compiled_path = Rocket::Core::String(argv[i]) + "c";
+		if (!CompileStyleSheet(argv[i], compiled_path.CString()))
+			num_failed++;
+	}
+
+	Rocket::Core::Shutdown();
+
+	return num_failed == 0 ? 0 : 1;
+}